@@ -0,0 +1,107 @@
+// Микробенчмарк интерполяции кадров MDL: вершин в секунду для векторного
+// и скалярного ядра на моделях из assets. OpenGL не нужен - модели только разбираются.
+//
+//   MDLLerpBench [model.mdl ...]
+#include "graphics/MDLModel.h"
+#include "graphics/MDLLerp.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace Revolt;
+
+namespace {
+
+typedef void (*LerpFunction)(const MDLRenderVertex*, const MDLRenderVertex*, float, MDLRenderVertex*, size_t);
+
+const double MIN_SECONDS = 0.25;
+
+// Проходит по всем парам соседних кадров с меняющимся t, пока не наберётся MIN_SECONDS
+double MeasureVerticesPerSecond(const MDLModel& model, LerpFunction lerp, std::vector<MDLRenderVertex>& out) {
+    typedef std::chrono::steady_clock Clock;
+    
+    int frameCount = model.GetFrameCount();
+    size_t count = static_cast<size_t>(model.GetRenderVertexCount());
+    out.resize(count);
+    
+    long long vertices = 0;
+    int iteration = 0;
+    Clock::time_point start = Clock::now();
+    double seconds = 0.0;
+    
+    do {
+        for (int batch = 0; batch < 64; ++batch, ++iteration) {
+            int frame = iteration % frameCount;
+            float t = static_cast<float>(iteration % 10) * 0.1f + 0.05f;
+            lerp(model.GetFrameVertices(frame), model.GetFrameVertices((frame + 1) % frameCount), t, out.data(), count);
+            vertices += static_cast<long long>(count);
+        }
+        seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    } while (seconds < MIN_SECONDS);
+    
+    return vertices / seconds;
+}
+
+// Максимальное расхождение с эталонной версией
+float MaxError(const MDLModel& model) {
+    size_t count = static_cast<size_t>(model.GetRenderVertexCount());
+    std::vector<MDLRenderVertex> fast(count), reference(count);
+    float maxError = 0.0f;
+    
+    int frameCount = model.GetFrameCount();
+    for (int frame = 0; frame < frameCount; ++frame) {
+        const MDLRenderVertex* a = model.GetFrameVertices(frame);
+        const MDLRenderVertex* b = model.GetFrameVertices((frame + 1) % frameCount);
+        LerpFrameVertices(a, b, 0.37f, fast.data(), count);
+        LerpFrameVerticesScalar(a, b, 0.37f, reference.data(), count);
+        
+        for (size_t v = 0; v < count; ++v) {
+            for (int k = 0; k < 3; ++k) {
+                maxError = std::fmax(maxError, std::fabs(fast[v].position[k] - reference[v].position[k]));
+                maxError = std::fmax(maxError, std::fabs(fast[v].normal[k] - reference[v].normal[k]));
+            }
+        }
+    }
+    return maxError;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        files.push_back(argv[i]);
+    }
+    if (files.empty()) {
+        const char* defaults[] = {"boss", "enforcer", "hknight", "ogre", "player", "soldier", "zombie"};
+        for (const char* name : defaults) {
+            files.push_back(std::string("assets/") + name + ".mdl");
+        }
+    }
+    
+    std::printf("Lerp kernel: %s\n", GetLerpKernelName());
+    std::printf("%-24s %8s %8s %14s %14s %8s %10s\n", 
+                "model", "frames", "verts", "Mvert/s", "scalar Mvert/s", "speedup", "max error");
+    
+    std::vector<MDLRenderVertex> out;
+    int failed = 0;
+    for (const std::string& file : files) {
+        MDLModel model;
+        if (!model.ParseFile(file) || model.GetFrameCount() == 0 || model.GetRenderVertexCount() == 0) {
+            std::fprintf(stderr, "Failed to load %s\n", file.c_str());
+            ++failed;
+            continue;
+        }
+        
+        double fast = MeasureVerticesPerSecond(model, LerpFrameVertices, out);
+        double scalar = MeasureVerticesPerSecond(model, LerpFrameVerticesScalar, out);
+        
+        std::printf("%-24s %8d %8d %14.1f %14.1f %7.2fx %10.2e\n", 
+                    file.c_str(), model.GetFrameCount(), model.GetRenderVertexCount(),
+                    fast / 1e6, scalar / 1e6, fast / scalar, MaxError(model));
+    }
+    
+    return failed ? 1 : 0;
+}
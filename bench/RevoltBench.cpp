@@ -0,0 +1,520 @@
+// Набор микробенчмарков горячих путей движка. Окно и OpenGL не нужны:
+// модели только разбираются, меши не загружаются в буферы.
+//
+//   RevoltBench [--assets DIR] [--filter TEXT] [--quick]
+//               [--json OUT.json] [--baseline BASE.json] [--threshold PERCENT]
+//
+// Результат каждого бенчмарка - медиана наносекунд на операцию по нескольким
+// замерам. С --baseline результаты сравниваются с сохранённым JSON: медленнее
+// порога (по умолчанию 10%) - регрессия, код возврата 2. Бенчмарк из базы,
+// которого нет в текущем запуске, тоже считается ошибкой - кроме отсечённых
+// --filter и тех, что --quick пропускает намеренно (сцены на 100000 объектов).
+#include "core/GameObject.h"
+#include "core/Log.h"
+#include "core/ResourceManager.h"
+#include "core/Scene.h"
+#include "core/SceneLoader.h"
+#include "graphics/Camera.h"
+#include "graphics/CookedAsset.h"
+#include "graphics/MDLModel.h"
+#include "math/Matrix4.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>
+#else
+#  include <dirent.h>
+#endif
+
+using namespace Revolt;
+using json = nlohmann::json;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+struct BenchConfig {
+    std::string assetsDir = "assets";
+    std::string filter;
+    std::string jsonPath;
+    std::string baselinePath;
+    double thresholdPercent = 10.0;
+    bool quick = false;
+};
+
+struct BenchResult {
+    std::string name;
+    double nsPerOp;
+    double itemsPerOp;  // Вершин, пикселей, объектов... на операцию
+    long long operations;
+};
+
+// Результат, который оптимизатор не может выбросить
+volatile float g_sink = 0.0f;
+
+// Загрузчик сцен и кэш ресурсов пишут в консоль на каждый объект -
+// при замерах вывод уходит в никуда
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+};
+
+class BenchRunner {
+public:
+    explicit BenchRunner(const BenchConfig& config) : m_config(config) {}
+
+    // op выполняет одну операцию; items - единиц работы в ней (для пропускной способности)
+    void Run(const std::string& name, double items, const std::function<void()>& op) {
+        if (!m_config.filter.empty() && name.find(m_config.filter) == std::string::npos) {
+            return;
+        }
+
+        const double sampleSeconds = m_config.quick ? 0.02 : 0.1;
+        const int sampleCount = m_config.quick ? 3 : 7;
+
+        // Разогрев и подбор размера пачки, чтобы замер шёл не меньше sampleSeconds
+        long long batch = 1;
+        for (;;) {
+            double seconds = TimeBatch(op, batch);
+            if (seconds >= sampleSeconds || batch >= (1LL << 30)) break;
+            double scale = seconds > 0.0 ? sampleSeconds / seconds * 1.2 : 16.0;
+            batch = static_cast<long long>(batch * std::min(std::max(scale, 2.0), 16.0));
+        }
+
+        std::vector<double> samples;
+        for (int i = 0; i < sampleCount; ++i) {
+            samples.push_back(TimeBatch(op, batch) * 1e9 / batch);
+        }
+        std::sort(samples.begin(), samples.end());
+
+        BenchResult result = {name, samples[samples.size() / 2], items, batch * sampleCount};
+        m_results.push_back(result);
+
+        std::printf("%-40s %14.1f ns/op", name.c_str(), result.nsPerOp);
+        if (items > 1.0) {
+            std::printf(" %12.2f M items/s", items / result.nsPerOp * 1e3);
+        }
+        std::printf("  (%lld ops)\n", result.operations);
+        std::fflush(stdout);
+    }
+
+    // Бенчмарк, который в этом режиме намеренно не запускается: при сравнении
+    // с базой его отсутствие не ошибка
+    void Skip(const std::string& name) {
+        m_skipped.push_back(name);
+    }
+
+    const std::vector<BenchResult>& GetResults() const { return m_results; }
+    const std::vector<std::string>& GetSkipped() const { return m_skipped; }
+
+private:
+    static double TimeBatch(const std::function<void()>& op, long long batch) {
+        Clock::time_point start = Clock::now();
+        for (long long i = 0; i < batch; ++i) {
+            op();
+        }
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    BenchConfig m_config;
+    std::vector<BenchResult> m_results;
+    std::vector<std::string> m_skipped;
+};
+
+void BenchMatrix(BenchRunner& runner) {
+    Matrix4 a = Matrix4::Perspective(1.0472f, 4.0f / 3.0f, 0.1f, 100.0f);
+    Matrix4 b;
+    b.Rotate(30.0f, 0.0f, 1.0f, 0.0f);
+    b.Translate(1.0f, 2.0f, 3.0f);
+
+    runner.Run("matrix.multiply", 1.0, [&]() {
+        Matrix4 c = a.Multiply(b);
+        g_sink = g_sink + c.m[5];
+        a.m[12] = c.m[0] * 1e-6f;
+    });
+
+    float angle = 0.0f;
+    runner.Run("matrix.rotate", 1.0, [&]() {
+        Matrix4 m;
+        angle += 1.0f;
+        m.Rotate(angle, 0.0f, 1.0f, 0.0f);
+        g_sink = g_sink + m.m[0];
+    });
+
+    runner.Run("matrix.translate", 1.0, [&]() {
+        Matrix4 m;
+        angle += 1.0f;
+        m.Translate(angle, 1.0f, 2.0f);
+        g_sink = g_sink + m.m[12];
+    });
+}
+
+void BenchGameObjects(BenchRunner& runner) {
+    const int counts[] = {1000, 10000};
+    for (int count : counts) {
+        std::vector<GameObject> objects(count);
+        for (int i = 0; i < count; ++i) {
+            objects[i].SetPosition(static_cast<float>(i % 100), 0.0f, static_cast<float>(i / 100));
+            objects[i].SetScale(1.0f, 1.0f, 1.0f);
+        }
+
+        // Как Application::Update: каждый кадр новый поворот у всех объектов
+        float rotation = 0.0f;
+        runner.Run("gameobject.update_transform/" + std::to_string(count), count, [&]() {
+            rotation += 3.0f;
+            for (GameObject& object : objects) {
+                object.SetRotation(0.0f, rotation, 0.0f);
+                object.UpdateTransform();
+            }
+            g_sink = g_sink + objects.back().GetTransform().m[0];
+        });
+    }
+}
+
+bool IsModelFile(const std::string& name) {
+    return name.size() > 4 && name.compare(name.size() - 4, 4, ".mdl") == 0;
+}
+
+// Все .mdl каталога; по алфавиту, чтобы порядок результатов не зависел от файловой системы
+std::vector<std::string> FindModels(const std::string& assetsDir) {
+    std::vector<std::string> files;
+#if defined(_WIN32)
+    WIN32_FIND_DATAA data;
+    HANDLE find = FindFirstFileA((assetsDir + "\\*.mdl").c_str(), &data);
+    if (find != INVALID_HANDLE_VALUE) {
+        do {
+            if (!(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) && IsModelFile(data.cFileName)) {
+                files.push_back(assetsDir + "/" + data.cFileName);
+            }
+        } while (FindNextFileA(find, &data));
+        FindClose(find);
+    }
+#else
+    if (DIR* dir = opendir(assetsDir.c_str())) {
+        while (dirent* entry = readdir(dir)) {
+            if (entry->d_name[0] != '.' && IsModelFile(entry->d_name)) {
+                files.push_back(assetsDir + "/" + entry->d_name);
+            }
+        }
+        closedir(dir);
+    }
+#endif
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+std::string GetBaseName(const std::string& path) {
+    size_t slash = path.find_last_of("/\\");
+    std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+    size_t dot = name.rfind('.');
+    return dot == std::string::npos ? name : name.substr(0, dot);
+}
+
+void BenchModels(BenchRunner& runner, const BenchConfig& config) {
+    std::vector<std::string> files = FindModels(config.assetsDir);
+    if (files.empty()) {
+        std::fprintf(stderr, "No models found in %s\n", config.assetsDir.c_str());
+        return;
+    }
+
+    for (const std::string& file : files) {
+        std::string name = GetBaseName(file);
+
+        // Разбор файла и распаковка кадров - CPU-часть MDLModel::LoadFromFile
+        runner.Run("mdl.load/" + name, 1.0, [&]() {
+            MDLModel model;
+            model.ParseFile(file);
+            g_sink = g_sink + static_cast<float>(model.GetRenderVertexCount());
+        });
+
+        MDLModel model;
+        if (!model.ParseFile(file) || model.GetFrameCount() == 0) {
+            std::fprintf(stderr, "Failed to load %s\n", file.c_str());
+            continue;
+        }
+
+        // То же из подготовленного RevoltCook файла
+        std::string cookedPath = "revolt_bench_" + name + Cooked::MODEL_EXTENSION;
+        std::vector<uint8_t> cooked;
+        if (model.Cook(Cooked::SourceStamp(), cooked) && Cooked::WriteFileAtomic(cookedPath, cooked)) {
+            runner.Run("mdl.load_cooked/" + name, 1.0, [&]() {
+                MDLModel cookedModel;
+                cookedModel.LoadCooked(cookedPath);
+                g_sink = g_sink + static_cast<float>(cookedModel.GetRenderVertexCount());
+            });
+            std::remove(cookedPath.c_str());
+        }
+
+        int vertexCount = model.GetRenderVertexCount();
+        std::vector<MDLRenderVertex> decoded(vertexCount);
+        int frame = 0;
+        runner.Run("mdl.decode_frame/" + name, vertexCount, [&]() {
+            model.DecodeFrame(frame, decoded.data());
+            frame = (frame + 1) % model.GetFrameCount();
+            g_sink = g_sink + decoded[0].position[0];
+        });
+
+        // CPU-часть CreateTextureFromSkin для RGBA-скинов
+        if (model.GetSkinCount() > 0) {
+            size_t pixelCount = static_cast<size_t>(model.GetHeader().skinWidth) * model.GetHeader().skinHeight;
+            std::vector<unsigned char> rgba(pixelCount * 4);
+            runner.Run("mdl.expand_skin/" + name, static_cast<double>(pixelCount), [&]() {
+                MDLModel::ExpandPaletteToRGBA(model.GetSkinPixels(0), pixelCount, rgba.data());
+                g_sink = g_sink + rgba[pixelCount * 2];
+            });
+        }
+    }
+}
+
+// Сцена из мешей всех типов; MDL-модели не используются - им нужен OpenGL
+std::string WriteGeneratedScene(int objectCount) {
+    std::string path = "revolt_bench_scene_" + std::to_string(objectCount) + ".json";
+    std::ofstream file(path);
+    file << "{\"camera\":{\"position\":[0,0,68],\"lookAt\":[0,-12,0],\"fov\":1.0472,"
+            "\"aspect\":1.33333,\"near\":0.1,\"far\":100.0},\"objects\":[";
+
+    for (int i = 0; i < objectCount; ++i) {
+        float x = static_cast<float>(i % 100) * 2.0f;
+        float z = static_cast<float>(i / 100) * -2.0f;
+        float hue = static_cast<float>(i % 10) * 0.1f;
+        file << (i ? "," : "") << "\n{";
+        switch (i % 3) {
+            case 0:
+                file << "\"type\":\"Cube\",\"parameters\":{\"size\":" << 0.5f + (i % 4) * 0.1f << "}";
+                break;
+            case 1:
+                file << "\"type\":\"Pyramid\",\"parameters\":{\"base\":1.0,\"height\":" << 1.0f + (i % 4) * 0.25f << "}";
+                break;
+            default:
+                file << "\"type\":\"Torus\",\"parameters\":{\"majorRadius\":1.0,\"minorRadius\":0.3,"
+                        "\"majorSegments\":16,\"minorSegments\":8}";
+                break;
+        }
+        file << ",\"position\":[" << x << ",0," << z << "],\"rotation\":[0," << (i % 360) << ",0]"
+             << ",\"scale\":[1,1,1],\"material\":{\"color\":[" << hue << ",0.5,1.0,1.0]}}";
+    }
+    file << "\n]}\n";
+    return path;
+}
+
+void BenchSceneLoading(BenchRunner& runner, const BenchConfig& config) {
+    const int counts[] = {1000, 10000, 100000};
+    for (int count : counts) {
+        if (config.quick && count > 10000) {
+            runner.Skip("scene.load/" + std::to_string(count));
+            runner.Skip("scene.load_compiled/" + std::to_string(count));
+            continue;
+        }
+
+        std::string path = WriteGeneratedScene(count);
+        runner.Run("scene.load/" + std::to_string(count), count, [&]() {
+            Scene scene;
+            Camera camera;
+            SceneLoader::LoadSceneFromFile(path, scene, camera);
+            g_sink = g_sink + static_cast<float>(scene.GetObjects().size());
+        });
+
+        // Та же сцена, скомпилированная RevoltCook: загрузчик берёт .rscn вместо JSON
+        Cooked::SourceStamp stamp;
+        std::vector<uint8_t> compiled;
+        std::string compiledPath = Cooked::GetCookedPath(path, Cooked::SCENE_EXTENSION);
+        if (Cooked::GetSourceStamp(path, stamp) && SceneLoader::CompileScene(path, stamp, compiled) &&
+            Cooked::WriteFileAtomic(compiledPath, compiled)) {
+            runner.Run("scene.load_compiled/" + std::to_string(count), count, [&]() {
+                Scene scene;
+                Camera camera;
+                SceneLoader::LoadSceneFromFile(path, scene, camera);
+                g_sink = g_sink + static_cast<float>(scene.GetObjects().size());
+            });
+            std::remove(compiledPath.c_str());
+        }
+        std::remove(path.c_str());
+    }
+}
+
+void BenchResources(BenchRunner& runner) {
+    ResourceManager& resources = ResourceManager::GetInstance();
+
+    // Кэш уже содержит все варианты: замеряется сборка ключа и поиск
+    const int variants = 64;
+    for (int i = 0; i < variants; ++i) {
+        resources.LoadMesh("Cube", 0.5f + i * 0.01f);
+    }
+
+    int index = 0;
+    runner.Run("resources.mesh_lookup", 1.0, [&]() {
+        std::shared_ptr<Mesh> mesh = resources.LoadMesh("Cube", 0.5f + index * 0.01f);
+        index = (index + 1) % variants;
+        g_sink = g_sink + (mesh ? 1.0f : 0.0f);
+    });
+}
+
+bool WriteResults(const std::string& path, const std::vector<BenchResult>& results) {
+    json benchmarks = json::array();
+    for (const BenchResult& result : results) {
+        benchmarks.push_back({
+            {"name", result.name},
+            {"ns_per_op", result.nsPerOp},
+            {"items_per_op", result.itemsPerOp},
+            {"operations", result.operations}
+        });
+    }
+    json document = {{"benchmarks", benchmarks}};
+
+    std::ofstream file(path);
+    if (!file) {
+        std::fprintf(stderr, "Failed to write %s\n", path.c_str());
+        return false;
+    }
+    file << document.dump(2) << "\n";
+    std::printf("Results written: %s\n", path.c_str());
+    return true;
+}
+
+// Возвращает число регрессий и пропавших бенчмарков или -1, если базу прочитать не удалось
+int CompareWithBaseline(const std::string& path, const BenchRunner& runner, const BenchConfig& config) {
+    const std::vector<BenchResult>& results = runner.GetResults();
+    const std::vector<std::string>& skipped = runner.GetSkipped();
+    const double thresholdPercent = config.thresholdPercent;
+    std::ifstream file(path);
+    if (!file) {
+        std::fprintf(stderr, "Failed to open baseline %s\n", path.c_str());
+        return -1;
+    }
+
+    json baseline;
+    try {
+        baseline = json::parse(file);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "Invalid baseline %s: %s\n", path.c_str(), e.what());
+        return -1;
+    }
+
+    std::printf("\nBaseline %s, threshold %.1f%%\n", path.c_str(), thresholdPercent);
+    std::printf("%-40s %14s %14s %9s\n", "benchmark", "baseline ns", "current ns", "change");
+
+    int regressions = 0;
+    for (const BenchResult& result : results) {
+        const json* match = nullptr;
+        for (const json& entry : baseline["benchmarks"]) {
+            if (entry.value("name", std::string()) == result.name) {
+                match = &entry;
+                break;
+            }
+        }
+        if (!match) {
+            std::printf("%-40s %14s %14.1f %9s\n", result.name.c_str(), "-", result.nsPerOp, "new");
+            continue;
+        }
+
+        double base = match->value("ns_per_op", 0.0);
+        double change = base > 0.0 ? (result.nsPerOp / base - 1.0) * 100.0 : 0.0;
+        bool regressed = change > thresholdPercent;
+        regressions += regressed ? 1 : 0;
+        std::printf("%-40s %14.1f %14.1f %+8.1f%%%s\n", result.name.c_str(), base, result.nsPerOp, change,
+                    regressed ? "  REGRESSION" : "");
+    }
+
+    // Переименованный или сломавшийся бенчмарк не должен проходить проверку молча
+    int missing = 0;
+    for (const json& entry : baseline["benchmarks"]) {
+        std::string name = entry.value("name", std::string());
+        if (!config.filter.empty() && name.find(config.filter) == std::string::npos) {
+            continue;
+        }
+        bool found = false;
+        for (const BenchResult& result : results) {
+            found = found || result.name == name;
+        }
+        if (!found && std::find(skipped.begin(), skipped.end(), name) != skipped.end()) {
+            std::printf("%-40s %14.1f %14s %9s\n", name.c_str(), entry.value("ns_per_op", 0.0), "-", "skipped");
+        } else if (!found) {
+            ++missing;
+            std::printf("%-40s %14.1f %14s %9s\n", name.c_str(), entry.value("ns_per_op", 0.0), "-", "MISSING");
+        }
+    }
+    return regressions + missing;
+}
+
+bool ParseArguments(int argc, char** argv, BenchConfig& config) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--quick") {
+            config.quick = true;
+        } else if (arg == "--assets" && hasValue) {
+            config.assetsDir = argv[++i];
+        } else if (arg == "--filter" && hasValue) {
+            config.filter = argv[++i];
+        } else if (arg == "--json" && hasValue) {
+            config.jsonPath = argv[++i];
+        } else if (arg == "--baseline" && hasValue) {
+            config.baselinePath = argv[++i];
+        } else if (arg == "--threshold" && hasValue) {
+            config.thresholdPercent = std::atof(argv[++i]);
+        } else {
+            std::fprintf(stderr, "Unknown argument: %s\n", arg.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchConfig config;
+    if (!ParseArguments(argc, argv, config)) {
+        std::fprintf(stderr, "Usage: RevoltBench [--assets DIR] [--filter TEXT] [--quick] "
+                             "[--json OUT.json] [--baseline BASE.json] [--threshold PERCENT]\n");
+        return 1;
+    }
+
+    // Сообщения кэша и загрузчика не должны попадать в замеры
+    Log::SetLevel(LogLevel::Warning);
+    NullBuffer nullBuffer;
+    std::streambuf* coutBuffer = std::cout.rdbuf(&nullBuffer);
+
+    BenchRunner runner(config);
+    BenchMatrix(runner);
+    BenchGameObjects(runner);
+    BenchModels(runner, config);
+    BenchSceneLoading(runner, config);
+    BenchResources(runner);
+
+    std::cout.rdbuf(coutBuffer);
+
+    if (!config.jsonPath.empty() && !WriteResults(config.jsonPath, runner.GetResults())) {
+        return 1;
+    }
+    if (!config.baselinePath.empty()) {
+        int failures = CompareWithBaseline(config.baselinePath, runner, config);
+        if (failures < 0) {
+            return 1;
+        }
+        if (failures > 0) {
+            std::printf("%d failure(s): regressions over %.1f%% or missing benchmarks\n", failures, config.thresholdPercent);
+            return 2;
+        }
+    }
+    return 0;
+}
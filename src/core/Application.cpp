@@ -3,18 +3,102 @@
 #include "core/Scene.h"
 #include "core/SceneLoader.h"
 #include "graphics/TextRenderer.h" 
+#include "graphics/GLState.h"
+#include "core/Profiler.h"
+#include "core/Log.h"
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 
 namespace Revolt {
 
-Application::Application() 
-    : m_window{m_resolutions[m_currentResolutionIndex].width, m_resolutions[m_currentResolutionIndex].height, "Revolt Engine"}
+namespace {
+
+int ParseFrameCount(const char* text) {
+    int frames = std::atoi(text);
+    return frames > 0 ? frames : 0;
+}
+
+float ParseMilliseconds(const char* text) {
+    float milliseconds = static_cast<float>(std::atof(text));
+    return milliseconds > 0.0f ? milliseconds : 0.0f;
+}
+
+// Цвета графика времени кадра: до 60 FPS, до 30 FPS, медленнее
+const uint8_t GRAPH_BACKGROUND_COLOR[4] = {0, 0, 0, 128};
+const uint8_t GRAPH_FAST_COLOR[4] = {64, 220, 64, 255};
+const uint8_t GRAPH_SLOW_COLOR[4] = {240, 200, 40, 255};
+const uint8_t GRAPH_HITCH_COLOR[4] = {240, 48, 48, 255};
+const uint8_t GRAPH_LINE_COLOR[4] = {255, 255, 255, 96};
+
+} // namespace
+
+LaunchOptions LaunchOptions::Parse(int argc, char** argv) {
+    LaunchOptions options;
+    bool framesGiven = false;
+    
+    const char* headlessEnv = std::getenv("REVOLT_HEADLESS");
+    if (headlessEnv && *headlessEnv && std::strcmp(headlessEnv, "0") != 0) {
+        options.headless = true;
+    }
+    const char* framesEnv = std::getenv("REVOLT_FRAMES");
+    if (framesEnv && *framesEnv) {
+        options.frameCount = ParseFrameCount(framesEnv);
+        framesGiven = true;
+    }
+    const char* hitchEnv = std::getenv("REVOLT_HITCH_MS");
+    if (hitchEnv && *hitchEnv) {
+        options.hitchThresholdMs = ParseMilliseconds(hitchEnv);
+    }
+    const char* uploadEnv = std::getenv("REVOLT_UPLOAD_BUDGET_MS");
+    if (uploadEnv && *uploadEnv) {
+        options.uploadBudgetMs = ParseMilliseconds(uploadEnv);
+    }
+    const char* logFileEnv = std::getenv("REVOLT_LOG_FILE");
+    if (logFileEnv) {
+        options.logFile = logFileEnv;
+    }
+    
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--headless") == 0) {
+            options.headless = true;
+        } else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            options.frameCount = ParseFrameCount(argv[++i]);
+            framesGiven = true;
+        } else if (std::strcmp(argv[i], "--hitch-ms") == 0 && i + 1 < argc) {
+            options.hitchThresholdMs = ParseMilliseconds(argv[++i]);
+        } else if (std::strcmp(argv[i], "--upload-budget-ms") == 0 && i + 1 < argc) {
+            options.uploadBudgetMs = ParseMilliseconds(argv[++i]);
+        } else if (std::strcmp(argv[i], "--log-file") == 0 && i + 1 < argc) {
+            options.logFile = argv[++i];
+        } else {
+            std::cerr << "Unknown argument ignored: " << argv[i] << std::endl;
+        }
+    }
+    
+    if (options.headless && !framesGiven) {
+        options.frameCount = DEFAULT_HEADLESS_FRAMES;
+    }
+    return options;
+}
+
+Application::Application(const LaunchOptions& options) 
+    : m_options(options)
+    , m_window{m_resolutions[m_currentResolutionIndex].width, m_resolutions[m_currentResolutionIndex].height, "Revolt Engine"}
     , m_isRunning(false)
     , m_showDebugInfo(false)
+    , m_debugPage(DEBUG_PAGE_TIMING)
     , m_fps(0.0f)
     , m_fpsAccumulator(0.0f)
     , m_fpsFrames(0)
-    , m_fpsRefreshTime(0.0f) {
+    , m_fpsRefreshTime(0.0f)
+    , m_debugTextHandle(TextRenderer::INVALID_TEXT_HANDLE)
+    , m_glStatsTextHandle(TextRenderer::INVALID_TEXT_HANDLE)
+    , m_gpuTimesTextHandle(TextRenderer::INVALID_TEXT_HANDLE) {
+    for (TextRenderer::TextHandle& handle : m_renderStatsTextHandles) {
+        handle = TextRenderer::INVALID_TEXT_HANDLE;
+    }
+    m_frameTimesTextHandle = TextRenderer::INVALID_TEXT_HANDLE;
 }
 
 Application::~Application() {
@@ -53,23 +137,28 @@ void Application::CycleResolution() {
 }
 
 bool Application::Initialize() {
+    REVOLT_PROFILE_THREAD("Main");
+    Log::Start(m_options.logFile.c_str());
+    
     // Получаем начальное разрешение
     Resolution initialRes = m_resolutions[m_currentResolutionIndex];
     
+    m_window.SetHeadless(m_options.headless);
     if (!m_window.Initialize()) {
         return false;
     }
     
-    // 1. Сначала загружаем сцену И камеру из JSON
+    // 1. Инициализируем рендерер: от его шейдеров зависит формат скинов моделей
+    m_renderer.Initialize(initialRes.width, initialRes.height);
+    ResourceManager::GetInstance().SetPalettizedSkins(m_renderer.SupportsPalettizedSkins());
+    
+    // 2. Загружаем сцену И камеру из JSON
     SceneLoader::LoadSceneFromFile("../../assets/demo_scene.json", m_scene, m_camera);
     
-    // 2. Только ПОСЛЕ этого настраиваем проекцию камеры с правильным соотношением сторон
+    // 3. Только ПОСЛЕ этого настраиваем проекцию камеры с правильным соотношением сторон
     float aspectRatio = (float)initialRes.width / (float)initialRes.height;
     m_camera.SetPerspective(1.0472f, aspectRatio, 0.1f, 100.0f);
     
-    // 3. Инициализируем рендерер
-    m_renderer.Initialize(initialRes.width, initialRes.height);
-    
     // 4. Устанавливаем камеру в рендерер (уже с параметрами из JSON + правильной проекцией)
     m_renderer.SetCamera(m_camera);
     
@@ -81,6 +170,14 @@ bool Application::Initialize() {
     
     m_textRenderer.SetRenderResolution(initialRes.width, initialRes.height);
     m_textRenderer.SetWindowSize(m_window.GetScreenWidth(), m_window.GetScreenHeight());
+    m_debugTextHandle = m_textRenderer.CreateTextBlock();
+    m_glStatsTextHandle = m_textRenderer.CreateTextBlock();
+    m_gpuTimesTextHandle = m_textRenderer.CreateTextBlock();
+    for (TextRenderer::TextHandle& handle : m_renderStatsTextHandles) {
+        handle = m_textRenderer.CreateTextBlock();
+    }
+    m_frameTimesTextHandle = m_textRenderer.CreateTextBlock();
+    m_frameTimes.SetHitchThreshold(m_options.hitchThresholdMs);
     
     // Выводим информацию для отладки
     PrintSceneInfo();
@@ -94,8 +191,17 @@ bool Application::Initialize() {
 
 void Application::Run() {
     double lastTime = glfwGetTime();
+    double startTime = lastTime;
+    int frames = 0;
     
     while (!m_window.ShouldClose() && m_isRunning) {
+        if (m_options.frameCount > 0 && frames >= m_options.frameCount) {
+            break;
+        }
+        ++frames;
+        
+        REVOLT_PROFILE_SCOPE("Frame");
+        
         double currentTime = glfwGetTime();
         float deltaTime = static_cast<float>(currentTime - lastTime);
         lastTime = currentTime;
@@ -111,14 +217,52 @@ void Application::Run() {
         // Настраиваем вьюпорт для сцены (центрируем изображение)
         m_window.SetupViewportForScene();
         
+        // Текстуры и буферы догрузившихся ресурсов - не дольше бюджета за кадр
+        ResourceManager::GetInstance().ProcessUploads(m_options.uploadBudgetMs);
+        
+        double updateStart = glfwGetTime();
         Update(deltaTime);
+        double renderStart = glfwGetTime();
         Render();
+        double renderEnd = glfwGetTime();
+        
+        // Ожидание vsync в SwapBuffers не считаем работой кадра
+        Resolution currentRes = m_resolutions[m_currentResolutionIndex];
+        const RenderStats& renderStats = m_renderer.GetStats();
+        FrameSample sample;
+        sample.frame = static_cast<uint32_t>(frames);
+        sample.time = currentTime;
+        sample.frameMs = deltaTime * 1000.0f;
+        sample.cpuMs = static_cast<float>((renderEnd - currentTime) * 1000.0);
+        sample.updateMs = static_cast<float>((renderStart - updateStart) * 1000.0);
+        sample.renderMs = static_cast<float>((renderEnd - renderStart) * 1000.0);
+        sample.drawCalls = renderStats.GetLast(RenderStats::DRAW_CALLS);
+        sample.triangles = renderStats.GetLast(RenderStats::TRIANGLES);
+        sample.renderWidth = currentRes.width;
+        sample.renderHeight = currentRes.height;
+        m_frameTimes.AddFrame(sample);
+        
         m_window.SwapBuffers();
     }
+    
+    // Итог для автоматических прогонов
+    if (m_options.frameCount > 0 && frames > 0) {
+        double elapsed = glfwGetTime() - startTime;
+        std::cout << "Ran " << frames << " frames in " << elapsed << " s ("
+                  << elapsed * 1000.0 / frames << " ms/frame)" << std::endl;
+        std::cout << "CPU frame ms: p50 " << m_frameTimes.GetPercentile(50.0f)
+                  << " p95 " << m_frameTimes.GetPercentile(95.0f)
+                  << " p99 " << m_frameTimes.GetPercentile(99.0f)
+                  << " max " << m_frameTimes.GetMaxMs() << std::endl;
+    }
 }
 
 void Application::Shutdown() {
     m_isRunning = false;
+    
+    ResourceManager::GetInstance().Shutdown();
+    REVOLT_PROFILE_WRITE_TRACE("revolt_trace.json");
+    Log::Stop();
 }
 
 void Application::UpdateFPS(float deltaTime) {
@@ -139,6 +283,8 @@ void Application::ToggleDebugInfo() {
 }
 
 void Application::Update(float deltaTime) {
+    REVOLT_PROFILE_SCOPE("Application::Update");
+    
     static float totalTime = 0.0f;
     totalTime += deltaTime;
     
@@ -163,13 +309,36 @@ void Application::Update(float deltaTime) {
         m_tabPressed = false;
     }
     
+    // F2 - следующая страница отладочного оверлея
+    if (glfwGetKey(m_window.GetNativeWindow(), GLFW_KEY_F2) == GLFW_PRESS) {
+        if (!m_pageKeyPressed) {
+            m_debugPage = (m_debugPage + 1) % DEBUG_PAGE_COUNT;
+            m_pageKeyPressed = true;
+        }
+    } else {
+        m_pageKeyPressed = false;
+    }
+    
+#if defined(REVOLT_ENABLE_PROFILER) && REVOLT_ENABLE_PROFILER
+    // F9 - сохранить трассу профилировщика
+    static bool traceKeyPressed = false;
+    if (glfwGetKey(m_window.GetNativeWindow(), GLFW_KEY_F9) == GLFW_PRESS) {
+        if (!traceKeyPressed) {
+            REVOLT_PROFILE_WRITE_TRACE("revolt_trace.json");
+            traceKeyPressed = true;
+        }
+    } else {
+        traceKeyPressed = false;
+    }
+#endif
+    
     const float rotationSpeed = 180.0f; // градусов в секунду для всех объектов
     
     const auto& objects = m_scene.GetObjects();
     for (size_t i = 0; i < objects.size(); ++i) {
         float rotation = totalTime * rotationSpeed;
         
-        if (objects[i]->GetMDLModel()) {
+        if (objects[i]->GetMDLModel() || objects[i]->IsLoading()) {
             objects[i]->SetRotation(-90.0f, rotation, 0.0f);
         } else {
             objects[i]->SetRotation(0.0f, rotation, 0.0f);
@@ -179,45 +348,151 @@ void Application::Update(float deltaTime) {
 }
 
 void Application::Render() {
-    m_renderer.BeginFrame();
-    
-    // Рендерим все объекты сцены
-    const auto& objects = m_scene.GetObjects(); // ПЕРЕМЕЩАЕМ объявление сюда
-    for (const auto& obj : objects) {
-        if (obj->GetMesh()) {
-            m_renderer.RenderMesh(*obj->GetMesh(), obj->GetTransform());
-        }
-        else if (obj->GetMDLModel()) {
-            m_renderer.RenderMDLModel(*obj->GetMDLModel(), obj->GetTransform(), obj->GetCurrentFrame());
-        }
-        else {
-            std::cout << "Object has no mesh or MDL model!" << std::endl;
+    {
+        REVOLT_PROFILE_SCOPE("Scene");
+        m_renderer.BeginFrame();
+        
+        // Рендерим все объекты сцены
+        const auto& objects = m_scene.GetObjects(); // ПЕРЕМЕЩАЕМ объявление сюда
+        for (const auto& obj : objects) {
+            if (obj->GetMesh()) {
+                m_renderer.RenderMesh(*obj->GetMesh(), obj->GetTransform());
+            }
+            else if (obj->GetMDLModel()) {
+                m_renderer.RenderMDLModel(*obj->GetMDLModel(), obj->GetTransform(), obj->GetPose(),
+                                          obj->GetCurrentFrame(), obj->GetNextFrame(), obj->GetFrameLerp());
+            }
+            else if (!obj->IsLoading()) {
+                REVOLT_LOG_LIMITED(Warning, Scene, 1000, "Object has no mesh or MDL model!");
+            }
         }
+        
+        // Рисуем отсортированную очередь до оверлея, иначе сцена перекроет текст
+        m_renderer.FlushQueue();
     }
     
     // РЕНДЕРИМ UI ТОЖЕ В ТЕКУЩЕМ РАЗРЕШЕНИИ
     if (m_showDebugInfo) {
+        REVOLT_PROFILE_SCOPE("Text");
+        m_renderer.BeginGPUPass(GPUTimer::PASS_TEXT);
         Resolution currentRes = m_resolutions[m_currentResolutionIndex];
         
-        // Форматируем текст в нужном формате: "(разрешение)(FPS значение)"
-        std::string resolutionInfo = "(" + std::to_string(currentRes.width) + "x" + 
-                                std::to_string(currentRes.height) + ")";
-        std::string fpsInfo = "(FPS " + std::to_string(static_cast<int>(m_fps)) + ")";
-        std::string debugText = resolutionInfo + fpsInfo;
+        // Форматируем текст в нужном формате: "(разрешение)(FPS значение)".
+        // Буфер фиксированный, а блок перестраивает геометрию только при
+        // изменении строки - в установившемся режиме аллокаций нет
+        m_debugText.Clear()
+            .Append('(').Append(currentRes.width).Append('x').Append(currentRes.height).Append(')')
+            .Append("(FPS ").Append(static_cast<int>(m_fps)).Append(')');
 
         // Позиционируем в ВЕРХНЕМ левом углу
         float textScale = 4.0f;
         float textX = 20.0f;
         float textY = 40.0f;
 
-        // Рендерим текст через TextRenderer (только одну строку)
-        m_textRenderer.RenderText(debugText, textX, textY, textScale);
+        m_textRenderer.SetTextBlock(m_debugTextHandle, m_debugText.GetString(), textX, textY, textScale);
+        m_textRenderer.QueueTextBlock(m_debugTextHandle);
+        
+        switch (m_debugPage) {
+            case DEBUG_PAGE_RENDER_STATS:
+                QueueRenderStatsPage(textX, textY + 90.0f);
+                break;
+            case DEBUG_PAGE_FRAME_TIMES:
+                QueueFrameTimesPage(textX, textY + 90.0f);
+                break;
+            default:
+                QueueTimingPage(textX, textY + 90.0f);
+                break;
+        }
+        m_textRenderer.Flush();
     }
     
     m_renderer.EndFrame();
     
-    // Рендерим текущее разрешение на экран (растягиваем без интерполяции)
-    m_renderer.RenderToScreen(m_window.GetScreenWidth(), m_window.GetScreenHeight());
+    // Рендерим текущее разрешение на экран (растягиваем без интерполяции).
+    // Без экрана показывать некому - кадр остаётся в текстуре
+    if (!m_window.IsHeadless()) {
+        m_renderer.RenderToScreen(m_window.GetScreenWidth(), m_window.GetScreenHeight());
+    }
+}
+
+void Application::QueueTimingPage(float x, float y) {
+    // Вызовы состояния GL за прошлый кадр: ушедшие в драйвер / отброшенные кэшем
+    const GLState::FrameStats& glStats = GLState::GetLastFrameStats();
+    m_debugText.Clear()
+        .Append("(GL ").Append(static_cast<int>(glStats.issued))
+        .Append(" ELIDED ").Append(static_cast<int>(glStats.elided)).Append(')');
+    m_textRenderer.SetTextBlock(m_glStatsTextHandle, m_debugText.GetString(), x, y, 2.0f);
+    m_textRenderer.QueueTextBlock(m_glStatsTextHandle);
+    
+    // Время проходов на GPU (с задержкой в несколько кадров)
+    const GPUTimer& gpuTimer = m_renderer.GetGPUTimer();
+    if (gpuTimer.HasResults()) {
+        m_debugText.Clear().Append("(GPU MS");
+        for (int pass = 0; pass < GPUTimer::PASS_COUNT; ++pass) {
+            GPUTimer::Pass gpuPass = static_cast<GPUTimer::Pass>(pass);
+            m_debugText.Append(' ').Append(GPUTimer::GetPassName(gpuPass))
+                       .Append(' ').Append(gpuTimer.GetPassTime(gpuPass), 2);
+        }
+        m_debugText.Append(')');
+        m_textRenderer.SetTextBlock(m_gpuTimesTextHandle, m_debugText.GetString(), x, y + 50.0f, 2.0f);
+        m_textRenderer.QueueTextBlock(m_gpuTimesTextHandle);
+    }
+}
+
+void Application::QueueRenderStatsPage(float x, float y) {
+    // Строка на счётчик: прошлый кадр, затем минимум/среднее/максимум по истории
+    const RenderStats& stats = m_renderer.GetStats();
+    const float lineScale = 1.5f;
+    const float lineHeight = 36.0f;
+    
+    for (int i = 0; i < RenderStats::COUNTER_COUNT; ++i) {
+        RenderStats::Counter counter = static_cast<RenderStats::Counter>(i);
+        RenderStats::Summary summary = stats.GetSummary(counter);
+        m_debugText.Clear()
+            .Append(RenderStats::GetCounterName(counter)).Append(' ')
+            .Append(static_cast<int>(stats.GetLast(counter)))
+            .Append(" (").Append(static_cast<int>(summary.minimum))
+            .Append(' ').Append(summary.average, 1)
+            .Append(' ').Append(static_cast<int>(summary.maximum)).Append(')');
+        m_textRenderer.SetTextBlock(m_renderStatsTextHandles[i], m_debugText.GetString(),
+                                    x, y + i * lineHeight, lineScale);
+        m_textRenderer.QueueTextBlock(m_renderStatsTextHandles[i]);
+    }
+}
+
+void Application::QueueFrameTimesPage(float x, float y) {
+    // Процентили за весь запуск по гистограмме
+    m_debugText.Clear()
+        .Append("(CPU MS P50 ").Append(m_frameTimes.GetPercentile(50.0f), 1)
+        .Append(" P95 ").Append(m_frameTimes.GetPercentile(95.0f), 1)
+        .Append(" P99 ").Append(m_frameTimes.GetPercentile(99.0f), 1)
+        .Append(" MAX ").Append(m_frameTimes.GetMaxMs(), 1).Append(')');
+    m_textRenderer.SetTextBlock(m_frameTimesTextHandle, m_debugText.GetString(), x, y, 2.0f);
+    m_textRenderer.QueueTextBlock(m_frameTimesTextHandle);
+    
+    // График последних кадров: столбец на кадр, линия - 60 FPS, верх - 50 мс
+    const float barWidth = 2.0f;
+    const float graphHeight = 100.0f;
+    const float graphMaxMs = 50.0f;
+    const float fastMs = 1000.0f / 60.0f;
+    const float slowMs = 1000.0f / 30.0f;
+    float graphWidth = FrameTimeTracker::GRAPH_FRAMES * barWidth;
+    float graphTop = y + 60.0f;
+    float graphBottom = graphTop + graphHeight;
+    
+    m_textRenderer.QueueRect(x, graphTop, graphWidth, graphHeight, GRAPH_BACKGROUND_COLOR);
+    
+    int count = m_frameTimes.GetGraphSize();
+    float left = x + graphWidth - count * barWidth; // Новые кадры справа
+    for (int i = 0; i < count; ++i) {
+        float ms = m_frameTimes.GetGraphSample(i);
+        float height = (ms < graphMaxMs ? ms : graphMaxMs) / graphMaxMs * graphHeight;
+        const uint8_t* color = ms <= fastMs ? GRAPH_FAST_COLOR : (ms <= slowMs ? GRAPH_SLOW_COLOR : GRAPH_HITCH_COLOR);
+        m_textRenderer.QueueRect(left + i * barWidth, graphBottom - height, barWidth, height, color);
+    }
+    
+    float fastY = graphBottom - fastMs / graphMaxMs * graphHeight;
+    m_textRenderer.QueueRect(x, fastY, graphWidth, 1.0f, GRAPH_LINE_COLOR);
 }
 
 } // namespace Revolt
\ No newline at end of file
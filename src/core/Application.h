@@ -4,15 +4,39 @@
 #include "graphics/Camera.h"
 #include "core/Scene.h"
 #include "core/SceneLoader.h"
+#include "core/ResourceManager.h"
 #include "graphics/TextRenderer.h"
+#include "core/FrameTimeTracker.h"
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace Revolt {
 
+// Параметры запуска. Переменные окружения читаются первыми, командная
+// строка их переопределяет:
+//     --headless     / REVOLT_HEADLESS=1  - невидимое окно, без вывода на экран
+//     --frames N     / REVOLT_FRAMES=N    - выйти после N кадров (0 - не ограничено)
+//     --hitch-ms N   / REVOLT_HITCH_MS=N  - порог рывка для самописца (0 - выключен)
+//     --log-file F   / REVOLT_LOG_FILE=F  - копия журнала в файл
+//     --upload-budget-ms N / REVOLT_UPLOAD_BUDGET_MS=N - время на загрузку ресурсов в GL за кадр
+struct LaunchOptions {
+    // Безголовый запуск без --frames не должен висеть вечно
+    static const int DEFAULT_HEADLESS_FRAMES = 600;
+
+    bool headless = false;
+    int frameCount = 0;
+    float hitchThresholdMs = 50.0f;
+    // Время на создание объектов GL для догруженных ресурсов за кадр
+    float uploadBudgetMs = ResourceManager::DEFAULT_UPLOAD_BUDGET_MS;
+    std::string logFile;
+
+    static LaunchOptions Parse(int argc, char** argv);
+};
+
 class Application {
 public:
-    Application();
+    explicit Application(const LaunchOptions& options = LaunchOptions());
     ~Application();
     
     bool Initialize();
@@ -26,6 +50,9 @@ private:
     void Render();
     void UpdateFPS(float deltaTime);
     void ToggleDebugInfo();
+    void QueueTimingPage(float x, float y);
+    void QueueRenderStatsPage(float x, float y);
+    void QueueFrameTimesPage(float x, float y);
     void CycleResolution(); // Новый метод для переключения разрешения
 
     // Список доступных разрешений
@@ -43,6 +70,7 @@ private:
     
     size_t m_currentResolutionIndex = 0; // Текущее разрешение
     
+    LaunchOptions m_options;
     Window m_window{m_resolutions[0].width, m_resolutions[0].height, "Revolt Engine"};
     Renderer m_renderer;
     Camera m_camera;
@@ -51,12 +79,33 @@ private:
     bool m_isRunning;
     bool m_showDebugInfo;
     
+    // Страницы оверлея под строкой "(WxH)(FPS n)", переключаются F2
+    enum DebugPage {
+        DEBUG_PAGE_TIMING,       // Вызовы GL и время проходов на GPU
+        DEBUG_PAGE_RENDER_STATS, // Счётчики рендерера: кадр, минимум/среднее/максимум
+        DEBUG_PAGE_FRAME_TIMES,  // Процентили времени кадра на CPU и график
+        DEBUG_PAGE_COUNT
+    };
+    int m_debugPage;
+    bool m_pageKeyPressed = false;
+    
     // Переменные для FPS
     float m_fps;
     float m_fpsAccumulator;
     int m_fpsFrames;
     float m_fpsRefreshTime;
     
+    // Время кадров на CPU: гистограмма, график и самописец рывков
+    FrameTimeTracker m_frameTimes;
+    
+    // Оверлей отладки: сохранённый блок текста и буфер форматирования
+    TextRenderer::TextHandle m_debugTextHandle;
+    TextRenderer::TextHandle m_glStatsTextHandle;
+    TextRenderer::TextHandle m_gpuTimesTextHandle;
+    TextRenderer::TextHandle m_renderStatsTextHandles[RenderStats::COUNTER_COUNT];
+    TextRenderer::TextHandle m_frameTimesTextHandle;
+    TextBuffer m_debugText;
+    
     // Для обработки клавиши Tab
     bool m_tabPressed = false;
 };
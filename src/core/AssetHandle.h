@@ -0,0 +1,75 @@
+#pragma once
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace Revolt {
+
+enum class AssetStatus {
+    Loading,   // Файл читается и распаковывается на рабочем потоке
+    Uploading, // Данные готовы, ждут создания объектов GL на главном потоке
+    Ready,
+    Failed
+};
+
+// Общее состояние одной загрузки. Все запросы одного ресурса получают
+// один и тот же объект, поэтому файл читается один раз.
+struct AssetLoadState {
+    explicit AssetLoadState(const std::string& assetName)
+        : name(assetName), status(AssetStatus::Loading) {}
+    virtual ~AssetLoadState() = default;
+
+    // Создаёт объекты GL; только главный поток
+    virtual bool Upload() = 0;
+
+    const std::string name;
+    std::atomic<AssetStatus> status;
+};
+
+template <typename T>
+struct TypedAssetLoadState : AssetLoadState {
+    TypedAssetLoadState(const std::string& assetName, std::shared_ptr<T> object)
+        : AssetLoadState(assetName), asset(std::move(object)) {}
+
+    bool Upload() override { return upload ? upload(*asset) : true; }
+
+    // Пишется до перехода из Loading, читается после - статус служит барьером
+    std::shared_ptr<T> asset;
+    std::function<bool(T&)> upload;
+};
+
+// Ссылка на ресурс, который, возможно, ещё загружается. Копируется дёшево;
+// Get() возвращает ресурс только после того, как созданы его объекты GL.
+template <typename T>
+class AssetHandle {
+public:
+    AssetHandle() = default;
+    explicit AssetHandle(std::shared_ptr<TypedAssetLoadState<T>> state) : m_state(std::move(state)) {}
+
+    bool IsValid() const { return m_state != nullptr; }
+
+    AssetStatus GetStatus() const {
+        return m_state ? m_state->status.load(std::memory_order_acquire) : AssetStatus::Failed;
+    }
+    bool IsReady() const { return GetStatus() == AssetStatus::Ready; }
+    bool IsPending() const {
+        AssetStatus status = GetStatus();
+        return status == AssetStatus::Loading || status == AssetStatus::Uploading;
+    }
+
+    // nullptr, пока загрузка не завершена или если она не удалась
+    std::shared_ptr<T> Get() const { return IsReady() ? m_state->asset : nullptr; }
+
+    const std::string& GetName() const {
+        static const std::string empty;
+        return m_state ? m_state->name : empty;
+    }
+
+private:
+    friend class ResourceManager;
+
+    std::shared_ptr<TypedAssetLoadState<T>> m_state;
+};
+
+} // namespace Revolt
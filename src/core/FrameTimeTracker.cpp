@@ -0,0 +1,126 @@
+#include "FrameTimeTracker.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace Revolt {
+
+namespace {
+
+const float BUCKET_MS = 0.1f;
+const float DEFAULT_HITCH_THRESHOLD_MS = 50.0f;
+
+} // namespace
+
+FrameTimeTracker::FrameTimeTracker()
+    : m_sampleCount(0), m_maxMs(0.0f)
+    , m_graphNext(0), m_graphSize(0)
+    , m_recorderNext(0), m_recorderSize(0)
+    , m_hitchThresholdMs(DEFAULT_HITCH_THRESHOLD_MS)
+    , m_hitchFrame(0), m_dumpPending(false), m_lastDumpFrame(0), m_dumpCount(0) {
+    std::memset(m_histogram, 0, sizeof(m_histogram));
+    std::memset(m_graph, 0, sizeof(m_graph));
+    std::memset(m_recorder, 0, sizeof(m_recorder));
+}
+
+void FrameTimeTracker::AddFrame(const FrameSample& sample) {
+    int bucket = static_cast<int>(sample.cpuMs / BUCKET_MS);
+    if (bucket < 0) bucket = 0;
+    if (bucket >= HISTOGRAM_BUCKETS) bucket = HISTOGRAM_BUCKETS - 1;
+    ++m_histogram[bucket];
+    ++m_sampleCount;
+    if (sample.cpuMs > m_maxMs) {
+        m_maxMs = sample.cpuMs;
+    }
+
+    m_graph[m_graphNext] = sample.cpuMs;
+    m_graphNext = (m_graphNext + 1) % GRAPH_FRAMES;
+    if (m_graphSize < GRAPH_FRAMES) ++m_graphSize;
+
+    m_recorder[m_recorderNext] = sample;
+    m_recorderNext = (m_recorderNext + 1) % RECORDER_FRAMES;
+    if (m_recorderSize < RECORDER_FRAMES) ++m_recorderSize;
+
+    if (m_hitchThresholdMs <= 0.0f) {
+        return;
+    }
+
+    bool coolingDown = m_dumpCount > 0 && sample.frame - m_lastDumpFrame < static_cast<uint32_t>(HITCH_COOLDOWN_FRAMES);
+    if (!m_dumpPending && !coolingDown && m_dumpCount < MAX_HITCH_DUMPS && sample.cpuMs > m_hitchThresholdMs) {
+        m_dumpPending = true;
+        m_hitchFrame = sample.frame;
+        std::cout << "Frame " << sample.frame << " hitch: " << sample.cpuMs << " ms" << std::endl;
+    }
+
+    if (m_dumpPending && sample.frame - m_hitchFrame >= static_cast<uint32_t>(POST_HITCH_FRAMES)) {
+        std::string path = "revolt_hitch_" + std::to_string(m_hitchFrame) + ".json";
+        DumpFlightRecorder(path, m_hitchFrame);
+        m_dumpPending = false;
+        m_lastDumpFrame = sample.frame;
+        ++m_dumpCount;
+    }
+}
+
+float FrameTimeTracker::GetPercentile(float percentile) const {
+    if (m_sampleCount == 0) {
+        return 0.0f;
+    }
+
+    // Ранг ближайшего сверху значения; результат - верхняя граница корзины
+    uint64_t rank = static_cast<uint64_t>(percentile / 100.0f * m_sampleCount + 0.5f);
+    if (rank < 1) rank = 1;
+    if (rank > m_sampleCount) rank = m_sampleCount;
+
+    uint64_t accumulated = 0;
+    for (int bucket = 0; bucket < HISTOGRAM_BUCKETS; ++bucket) {
+        accumulated += m_histogram[bucket];
+        if (accumulated >= rank) {
+            float upper = (bucket + 1) * BUCKET_MS;
+            return bucket == HISTOGRAM_BUCKETS - 1 || upper > m_maxMs ? m_maxMs : upper;
+        }
+    }
+    return m_maxMs;
+}
+
+void FrameTimeTracker::ResetHistogram() {
+    std::memset(m_histogram, 0, sizeof(m_histogram));
+    m_sampleCount = 0;
+    m_maxMs = 0.0f;
+}
+
+float FrameTimeTracker::GetGraphSample(int index) const {
+    int oldest = m_graphSize < GRAPH_FRAMES ? 0 : m_graphNext;
+    return m_graph[(oldest + index) % GRAPH_FRAMES];
+}
+
+bool FrameTimeTracker::DumpFlightRecorder(const std::string& path, uint32_t hitchFrame) const {
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "Failed to write flight recorder: " << path << std::endl;
+        return false;
+    }
+
+    file << "{\"hitch_frame\":" << hitchFrame
+         << ",\"threshold_ms\":" << m_hitchThresholdMs
+         << ",\"frames\":[";
+
+    int oldest = m_recorderSize < RECORDER_FRAMES ? 0 : m_recorderNext;
+    for (int i = 0; i < m_recorderSize; ++i) {
+        const FrameSample& sample = m_recorder[(oldest + i) % RECORDER_FRAMES];
+        file << (i ? "," : "") << "\n{\"frame\":" << sample.frame
+             << ",\"time\":" << sample.time
+             << ",\"frame_ms\":" << sample.frameMs
+             << ",\"cpu_ms\":" << sample.cpuMs
+             << ",\"update_ms\":" << sample.updateMs
+             << ",\"render_ms\":" << sample.renderMs
+             << ",\"draw_calls\":" << sample.drawCalls
+             << ",\"triangles\":" << sample.triangles
+             << ",\"resolution\":[" << sample.renderWidth << "," << sample.renderHeight << "]}";
+    }
+    file << "\n]}\n";
+
+    std::cout << "Flight recorder written: " << path << " (" << m_recorderSize << " frames)" << std::endl;
+    return static_cast<bool>(file);
+}
+
+} // namespace Revolt
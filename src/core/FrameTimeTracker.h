@@ -0,0 +1,75 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+namespace Revolt {
+
+// Данные одного кадра для гистограммы, графика и бортового самописца
+struct FrameSample {
+    uint32_t frame;
+    double time;      // Секунды от запуска (glfwGetTime) на начало кадра
+    float frameMs;    // От начала прошлого кадра до начала этого
+    float cpuMs;      // Работа кадра до SwapBuffers
+    float updateMs;
+    float renderMs;
+    uint32_t drawCalls;
+    uint32_t triangles;
+    int renderWidth;
+    int renderHeight;
+};
+
+// Время кадров на CPU: гистограмма с процентилями за весь запуск, история
+// для графика в оверлее и "бортовой самописец" - последние RECORDER_FRAMES
+// кадров, которые сохраняются в JSON, когда кадр дольше порога. Файл пишется
+// через POST_HITCH_FRAMES кадров после рывка, чтобы было видно и восстановление.
+class FrameTimeTracker {
+public:
+    static const int HISTOGRAM_BUCKETS = 2500; // По 0.1 мс до 250 мс, дальше - последняя корзина
+    static const int GRAPH_FRAMES = 240;
+    static const int RECORDER_FRAMES = 512;    // Несколько секунд при 60-140 FPS
+    static const int POST_HITCH_FRAMES = 30;
+    static const int HITCH_COOLDOWN_FRAMES = 120; // Серия рывков даёт один файл
+    static const int MAX_HITCH_DUMPS = 8;
+
+    FrameTimeTracker();
+
+    // Порог рывка в миллисекундах CPU; 0 - самописец не сохраняет файлы
+    void SetHitchThreshold(float milliseconds) { m_hitchThresholdMs = milliseconds; }
+    float GetHitchThreshold() const { return m_hitchThresholdMs; }
+
+    void AddFrame(const FrameSample& sample);
+
+    // Процентиль (0..100) времени CPU с точностью до корзины гистограммы
+    float GetPercentile(float percentile) const;
+    float GetMaxMs() const { return m_maxMs; }
+    uint32_t GetSampleCount() const { return m_sampleCount; }
+    void ResetHistogram();
+
+    // Время CPU кадров для графика: 0 - самый старый, GetGraphSize() - 1 - последний
+    int GetGraphSize() const { return m_graphSize; }
+    float GetGraphSample(int index) const;
+
+    // Сохраняет самописец сейчас (вызывается и автоматически после рывка)
+    bool DumpFlightRecorder(const std::string& path, uint32_t hitchFrame) const;
+
+private:
+    uint32_t m_histogram[HISTOGRAM_BUCKETS];
+    uint32_t m_sampleCount;
+    float m_maxMs;
+
+    float m_graph[GRAPH_FRAMES];
+    int m_graphNext;
+    int m_graphSize;
+
+    FrameSample m_recorder[RECORDER_FRAMES];
+    int m_recorderNext;
+    int m_recorderSize;
+
+    float m_hitchThresholdMs;
+    uint32_t m_hitchFrame;       // Кадр рывка, ожидающего записи
+    bool m_dumpPending;
+    uint32_t m_lastDumpFrame;
+    int m_dumpCount;
+};
+
+} // namespace Revolt
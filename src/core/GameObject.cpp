@@ -7,7 +7,9 @@ GameObject::GameObject()
     , m_rotation{0.0f, 0.0f, 0.0f}
     , m_scale{1.0f, 1.0f, 1.0f}
     , m_transform(Matrix4::Identity())
-    , m_transformDirty(true) {
+    , m_transformDirty(true)
+    , m_currentFrame(0)
+    , m_animTime(0.0f) {
 }
 
 void GameObject::SetPosition(float x, float y, float z) {
@@ -58,16 +60,30 @@ void GameObject::ApplyMaterialToMesh() {
     }
 }
 
+std::shared_ptr<MDLModel> GameObject::GetMDLModel() const {
+    if (!m_mdlModel && m_mdlHandle.IsReady()) {
+        m_mdlModel = m_mdlHandle.Get();
+    }
+    return m_mdlModel;
+}
+
+int GameObject::GetNextFrame() const {
+    std::shared_ptr<MDLModel> model = GetMDLModel();
+    if (!model || model->GetFrameCount() < 2) {
+        return m_currentFrame;
+    }
+    return (m_currentFrame + 1) % model->GetFrameCount();
+}
+
 void GameObject::Update(float deltaTime) {
-    // Пока что оставляем пустым, или добавьте логику обновления если нужно
-    // Например, обновление анимации для MDL моделей:
-    if (m_mdlModel && m_mdlModel->GetFrameCount() > 1) {
-        // Простая анимация - циклическое переключение кадров
-        static float animTime = 0.0f;
-        animTime += deltaTime;
-        if (animTime > 0.1f) { // Смена кадра каждые 0.1 секунды
-            m_currentFrame = (m_currentFrame + 1) % m_mdlModel->GetFrameCount();
-            animTime = 0.0f;
+    std::shared_ptr<MDLModel> model = GetMDLModel();
+    if (model && model->GetFrameCount() > 1) {
+        // Циклическая анимация; между кадрами вершины интерполируются при рендеринге.
+        // Время своё у каждого объекта, остаток переносится, чтобы темп не зависел от FPS.
+        m_animTime += deltaTime;
+        while (m_animTime >= FRAME_DURATION) {
+            m_currentFrame = (m_currentFrame + 1) % model->GetFrameCount();
+            m_animTime -= FRAME_DURATION;
         }
     }
 }
@@ -2,6 +2,7 @@
 #include "../math/Matrix4.h"
 #include "../graphics/Mesh.h"
 #include "../graphics/MDLModel.h" // Добавляем include
+#include "AssetHandle.h"
 #include <memory>
 
 namespace Revolt {
@@ -13,8 +14,12 @@ namespace Revolt {
         std::shared_ptr<Mesh> GetMesh() const { return m_mesh; }
         
         // Добавляем методы для MDL моделей
-        void SetMDLModel(std::shared_ptr<MDLModel> model) { m_mdlModel = model; }
-        std::shared_ptr<MDLModel> GetMDLModel() const { return m_mdlModel; }
+        void SetMDLModel(std::shared_ptr<MDLModel> model) { m_mdlModel = model; m_mdlHandle = AssetHandle<MDLModel>(); }
+        // Модель ещё загружается: GetMDLModel вернёт её, когда она будет готова
+        void SetMDLModel(const AssetHandle<MDLModel>& handle) { m_mdlModel.reset(); m_mdlHandle = handle; }
+        std::shared_ptr<MDLModel> GetMDLModel() const;
+        // Назначенная модель ещё не загружена
+        bool IsLoading() const { return !m_mdlModel && m_mdlHandle.IsPending(); }
         
         void SetMaterial(const Material& material) { 
             m_material = material; 
@@ -23,8 +28,13 @@ namespace Revolt {
         const Material& GetMaterial() const { return m_material; }
         
         // Для анимации MDL моделей
-        void SetCurrentFrame(int frame) { m_currentFrame = frame; }
+        void SetCurrentFrame(int frame) { m_currentFrame = frame; m_animTime = 0.0f; }
         int GetCurrentFrame() const { return m_currentFrame; }
+        // Следующий кадр и доля перехода к нему (0..1) для плавной анимации
+        int GetNextFrame() const;
+        float GetFrameLerp() const { return m_animTime / FRAME_DURATION; }
+        // Буфер смешанного кадра этого объекта
+        MDLPose& GetPose() { return m_pose; }
         
         void SetPosition(float x, float y, float z);
         void SetRotation(float x, float y, float z);
@@ -47,7 +57,8 @@ namespace Revolt {
         void ApplyMaterialToMesh(); // Применяет материал к мешу
         
         std::shared_ptr<Mesh> m_mesh;
-        std::shared_ptr<MDLModel> m_mdlModel; // Новая переменная для MDL моделей
+        mutable std::shared_ptr<MDLModel> m_mdlModel; // Новая переменная для MDL моделей
+        AssetHandle<MDLModel> m_mdlHandle;
         Material m_material;
         
         float m_position[3];
@@ -58,5 +69,9 @@ namespace Revolt {
         bool m_transformDirty;
         
         int m_currentFrame; // Текущий кадр анимации для MDL моделей
+        float m_animTime;   // Время с начала текущего кадра
+        MDLPose m_pose;
+        
+        static constexpr float FRAME_DURATION = 0.1f; // Модели Quake анимируются с частотой 10 кадров/с
     };
 }
\ No newline at end of file
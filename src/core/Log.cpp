@@ -0,0 +1,288 @@
+#include "Log.h"
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+namespace Revolt {
+
+namespace {
+
+struct LogRecord {
+    uint64_t time; // Наносекунды от запуска
+    LogLevel level;
+    LogCategory category;
+    char message[Log::MESSAGE_CAPACITY];
+};
+
+// Ограниченная очередь многих писателей (Д. Вьюков): писатель занимает
+// ячейку сдвигом enqueuePosition через CAS, а её sequence сообщает
+// читателю, что запись закончена
+struct QueueCell {
+    std::atomic<uint64_t> sequence;
+    LogRecord record;
+};
+
+const uint32_t QUEUE_MASK = Log::QUEUE_CAPACITY - 1;
+const int CATEGORY_COUNT = static_cast<int>(LogCategory::Count);
+const std::chrono::milliseconds IDLE_SLEEP(2);
+
+const std::chrono::steady_clock::time_point s_epoch = std::chrono::steady_clock::now();
+
+QueueCell s_cells[Log::QUEUE_CAPACITY];
+std::atomic<uint64_t> s_enqueuePosition(0);
+uint64_t s_dequeuePosition = 0; // Только поток вывода
+std::atomic<bool> s_queueReady(false);
+
+std::atomic<int> s_minLevel(REVOLT_LOG_MIN_LEVEL);
+std::atomic<bool> s_categoryDisabled[CATEGORY_COUNT]; // Нули - всё включено
+std::atomic<uint64_t> s_dropped(0);
+
+std::thread s_writerThread;
+std::atomic<bool> s_running(false);
+std::ofstream s_file;
+
+// Поток нельзя оставить неприсоединённым при выходе (например, если
+// Application::Initialize не удался и Shutdown не вызывался)
+struct WriterGuard {
+    ~WriterGuard() { Log::Stop(); }
+} s_writerGuard;
+
+uint64_t NowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - s_epoch).count());
+}
+
+void FormatRecord(LogRecord& record, uint32_t suppressed, const char* format, va_list args) {
+    int length = std::vsnprintf(record.message, sizeof(record.message), format, args);
+    if (length < 0) {
+        record.message[0] = '\0';
+        length = 0;
+    }
+    if (suppressed > 0 && length < static_cast<int>(sizeof(record.message))) {
+        std::snprintf(record.message + length, sizeof(record.message) - length,
+                      " (%u suppressed)", suppressed);
+    }
+}
+
+void Output(const LogRecord& record) {
+    char prefix[48];
+    std::snprintf(prefix, sizeof(prefix), "[%9.3f] %s %s: ", record.time / 1.0e9,
+                  Log::GetLevelName(record.level), Log::GetCategoryName(record.category));
+
+    std::ostream& console = record.level >= LogLevel::Warning ? std::cerr : std::cout;
+    console << prefix << record.message << '\n';
+    if (s_file.is_open()) {
+        s_file << prefix << record.message << '\n';
+    }
+}
+
+void FlushOutput() {
+    std::cout.flush();
+    std::cerr.flush();
+    if (s_file.is_open()) {
+        s_file.flush();
+    }
+}
+
+void InitializeQueue() {
+    if (s_queueReady.load(std::memory_order_acquire)) {
+        return;
+    }
+    for (uint32_t i = 0; i < Log::QUEUE_CAPACITY; ++i) {
+        s_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    s_enqueuePosition.store(0, std::memory_order_relaxed);
+    s_dequeuePosition = 0;
+    s_queueReady.store(true, std::memory_order_release);
+}
+
+// Ячейка для записи или nullptr, если очередь полна
+QueueCell* ClaimCell(uint64_t& position) {
+    position = s_enqueuePosition.load(std::memory_order_relaxed);
+    for (;;) {
+        QueueCell& cell = s_cells[position & QUEUE_MASK];
+        uint64_t sequence = cell.sequence.load(std::memory_order_acquire);
+        int64_t difference = static_cast<int64_t>(sequence) - static_cast<int64_t>(position);
+        if (difference == 0) {
+            if (s_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                return &cell;
+            }
+        } else if (difference < 0) {
+            return nullptr;
+        } else {
+            position = s_enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool DrainOne() {
+    QueueCell& cell = s_cells[s_dequeuePosition & QUEUE_MASK];
+    uint64_t sequence = cell.sequence.load(std::memory_order_acquire);
+    if (sequence != s_dequeuePosition + 1) {
+        return false;
+    }
+    Output(cell.record);
+    cell.sequence.store(s_dequeuePosition + Log::QUEUE_CAPACITY, std::memory_order_release);
+    ++s_dequeuePosition;
+    return true;
+}
+
+void DrainAll() {
+    while (DrainOne()) {
+    }
+}
+
+void WriterLoop() {
+    bool pendingFlush = false;
+    while (s_running.load(std::memory_order_acquire)) {
+        if (DrainOne()) {
+            pendingFlush = true;
+            continue;
+        }
+        // Очередь пуста: сбрасываем вывод пачкой и ждём
+        if (pendingFlush) {
+            FlushOutput();
+            pendingFlush = false;
+        }
+        std::this_thread::sleep_for(IDLE_SLEEP);
+    }
+    DrainAll();
+    FlushOutput();
+}
+
+void WriteRecord(LogLevel level, LogCategory category, uint32_t suppressed, const char* format, va_list args) {
+    if (!s_running.load(std::memory_order_acquire)) {
+        // Потока нет - выводим сразу
+        LogRecord record;
+        record.time = NowNs();
+        record.level = level;
+        record.category = category;
+        FormatRecord(record, suppressed, format, args);
+        Output(record);
+        FlushOutput();
+        return;
+    }
+
+    uint64_t position = 0;
+    QueueCell* cell = ClaimCell(position);
+    if (!cell) {
+        s_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    cell->record.time = NowNs();
+    cell->record.level = level;
+    cell->record.category = category;
+    FormatRecord(cell->record, suppressed, format, args);
+    cell->sequence.store(position + 1, std::memory_order_release);
+}
+
+} // namespace
+
+bool Log::Start(const char* filePath) {
+    if (s_running.load(std::memory_order_acquire)) {
+        return true;
+    }
+
+    bool fileOpened = true;
+    if (filePath && *filePath) {
+        s_file.open(filePath);
+        if (!s_file) {
+            std::cerr << "Failed to open log file: " << filePath << std::endl;
+            fileOpened = false;
+        }
+    }
+
+    InitializeQueue();
+    s_dropped.store(0, std::memory_order_relaxed);
+    s_running.store(true, std::memory_order_release);
+    s_writerThread = std::thread(WriterLoop);
+    return fileOpened;
+}
+
+void Log::Stop() {
+    if (!s_running.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+    s_writerThread.join();
+
+    uint64_t dropped = s_dropped.load(std::memory_order_relaxed);
+    if (dropped > 0) {
+        std::cerr << "Log: " << dropped << " messages dropped (queue full)" << std::endl;
+    }
+    if (s_file.is_open()) {
+        s_file.close();
+    }
+}
+
+void Log::SetLevel(LogLevel level) {
+    s_minLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+void Log::SetCategoryEnabled(LogCategory category, bool enabled) {
+    s_categoryDisabled[static_cast<int>(category)].store(!enabled, std::memory_order_relaxed);
+}
+
+bool Log::IsEnabled(LogLevel level, LogCategory category) {
+    return static_cast<int>(level) >= s_minLevel.load(std::memory_order_relaxed) &&
+           !s_categoryDisabled[static_cast<int>(category)].load(std::memory_order_relaxed);
+}
+
+void Log::Write(LogLevel level, LogCategory category, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    WriteRecord(level, category, 0, format, args);
+    va_end(args);
+}
+
+void Log::WriteSuppressed(LogLevel level, LogCategory category, uint32_t suppressed, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    WriteRecord(level, category, suppressed, format, args);
+    va_end(args);
+}
+
+uint64_t Log::GetDroppedCount() {
+    return s_dropped.load(std::memory_order_relaxed);
+}
+
+const char* Log::GetLevelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::Trace:   return "TRACE";
+        case LogLevel::Debug:   return "DEBUG";
+        case LogLevel::Info:    return "INFO";
+        case LogLevel::Warning: return "WARN";
+        case LogLevel::Error:   return "ERROR";
+    }
+    return "?";
+}
+
+const char* Log::GetCategoryName(LogCategory category) {
+    switch (category) {
+        case LogCategory::Core:      return "core";
+        case LogCategory::Render:    return "render";
+        case LogCategory::Resources: return "resources";
+        case LogCategory::Scene:     return "scene";
+        default:                     return "?";
+    }
+}
+
+LogRateLimiter::LogRateLimiter(uint32_t intervalMs)
+    : m_intervalNs(static_cast<uint64_t>(intervalMs) * 1000000u), m_nextTime(0), m_suppressed(0) {
+}
+
+bool LogRateLimiter::Allow(uint32_t& suppressed) {
+    uint64_t now = NowNs();
+    uint64_t next = m_nextTime.load(std::memory_order_relaxed);
+    // Из нескольких потоков в интервал проходит только выигравший CAS
+    if (now >= next && m_nextTime.compare_exchange_strong(next, now + m_intervalNs, std::memory_order_relaxed)) {
+        suppressed = m_suppressed.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+    m_suppressed.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+} // namespace Revolt
@@ -0,0 +1,124 @@
+#pragma once
+
+// Журнал с уровнями и категориями. Сообщение форматируется (printf) прямо
+// в ячейку очереди без блокировок и аллокаций, а выводит его фоновый поток -
+// вызывающий не ждёт консоль. Если очередь полна, сообщение отбрасывается
+// и учитывается в GetDroppedCount().
+//
+//     REVOLT_LOG(Info, Resources, "Created new mesh: %s", key.c_str());
+//     // Не чаще раза в секунду; пропущенные посчитаются в следующем сообщении
+//     REVOLT_LOG_LIMITED(Warning, Scene, 1000, "Object has no mesh or MDL model!");
+//
+// Уровни ниже REVOLT_LOG_MIN_LEVEL отсекаются при компиляции: условие
+// постоянное, и вызов вместе с аргументами удаляется оптимизатором.
+
+#include <atomic>
+#include <cstdint>
+
+#define REVOLT_LOG_LEVEL_TRACE   0
+#define REVOLT_LOG_LEVEL_DEBUG   1
+#define REVOLT_LOG_LEVEL_INFO    2
+#define REVOLT_LOG_LEVEL_WARNING 3
+#define REVOLT_LOG_LEVEL_ERROR   4
+
+#ifndef REVOLT_LOG_MIN_LEVEL
+#  ifdef NDEBUG
+#    define REVOLT_LOG_MIN_LEVEL REVOLT_LOG_LEVEL_INFO
+#  else
+#    define REVOLT_LOG_MIN_LEVEL REVOLT_LOG_LEVEL_DEBUG
+#  endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#  define REVOLT_LOG_PRINTF_FORMAT(formatIndex, firstArg) __attribute__((format(printf, formatIndex, firstArg)))
+#else
+#  define REVOLT_LOG_PRINTF_FORMAT(formatIndex, firstArg)
+#endif
+
+namespace Revolt {
+
+enum class LogLevel {
+    Trace = REVOLT_LOG_LEVEL_TRACE,
+    Debug = REVOLT_LOG_LEVEL_DEBUG,
+    Info = REVOLT_LOG_LEVEL_INFO,
+    Warning = REVOLT_LOG_LEVEL_WARNING,
+    Error = REVOLT_LOG_LEVEL_ERROR
+};
+
+enum class LogCategory {
+    Core,
+    Render,
+    Resources,
+    Scene,
+    Count
+};
+
+class Log {
+public:
+    static const int MESSAGE_CAPACITY = 216;  // Длиннее - обрезается
+    static const uint32_t QUEUE_CAPACITY = 4096; // Степень двойки
+
+    // Запускает поток вывода; filePath (может быть nullptr) - копия журнала
+    // в файл. До Start и после Stop сообщения выводятся сразу из вызывающего потока.
+    static bool Start(const char* filePath);
+    // Выводит оставшееся и останавливает поток
+    static void Stop();
+
+    // Фильтры времени выполнения (поверх REVOLT_LOG_MIN_LEVEL)
+    static void SetLevel(LogLevel level);
+    static void SetCategoryEnabled(LogCategory category, bool enabled);
+    static bool IsEnabled(LogLevel level, LogCategory category);
+
+    static void Write(LogLevel level, LogCategory category, const char* format, ...)
+        REVOLT_LOG_PRINTF_FORMAT(3, 4);
+    // То же с числом сообщений, подавленных ограничителем частоты
+    static void WriteSuppressed(LogLevel level, LogCategory category, uint32_t suppressed, const char* format, ...)
+        REVOLT_LOG_PRINTF_FORMAT(4, 5);
+
+    // Отброшено из-за полной очереди с последнего Start
+    static uint64_t GetDroppedCount();
+
+    static const char* GetLevelName(LogLevel level);
+    static const char* GetCategoryName(LogCategory category);
+};
+
+// Ограничитель частоты для одного места вызова: не больше одного
+// сообщения за интервал, остальные только считаются
+class LogRateLimiter {
+public:
+    explicit LogRateLimiter(uint32_t intervalMs);
+
+    // true - сообщение выводить; suppressed - сколько пропущено перед ним
+    bool Allow(uint32_t& suppressed);
+
+private:
+    uint64_t m_intervalNs;
+    std::atomic<uint64_t> m_nextTime;
+    std::atomic<uint32_t> m_suppressed;
+};
+
+} // namespace Revolt
+
+#define REVOLT_LOG_COMPILED(level) \
+    (static_cast<int>(::Revolt::LogLevel::level) >= REVOLT_LOG_MIN_LEVEL)
+
+#define REVOLT_LOG(level, category, ...) \
+    do { \
+        if (REVOLT_LOG_COMPILED(level) && \
+            ::Revolt::Log::IsEnabled(::Revolt::LogLevel::level, ::Revolt::LogCategory::category)) { \
+            ::Revolt::Log::Write(::Revolt::LogLevel::level, ::Revolt::LogCategory::category, __VA_ARGS__); \
+        } \
+    } while (0)
+
+#define REVOLT_LOG_LIMITED(level, category, intervalMs, ...) \
+    do { \
+        if (REVOLT_LOG_COMPILED(level) && \
+            ::Revolt::Log::IsEnabled(::Revolt::LogLevel::level, ::Revolt::LogCategory::category)) { \
+            static ::Revolt::LogRateLimiter revoltLogLimiter(intervalMs); \
+            uint32_t revoltLogSuppressed = 0; \
+            if (revoltLogLimiter.Allow(revoltLogSuppressed)) { \
+                ::Revolt::Log::WriteSuppressed(::Revolt::LogLevel::level, ::Revolt::LogCategory::category, \
+                                               revoltLogSuppressed, __VA_ARGS__); \
+            } \
+        } \
+    } while (0)
@@ -0,0 +1,141 @@
+#include "MappedFile.h"
+#include <cstdio>
+
+#if defined(_WIN32)
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>
+#  define REVOLT_HAS_MMAP 1
+#elif defined(__unix__) || defined(__APPLE__)
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#  define REVOLT_HAS_MMAP 1
+#else
+#  define REVOLT_HAS_MMAP 0
+#endif
+
+namespace Revolt {
+
+MappedFile::MappedFile() : m_data(nullptr), m_size(0), m_mapped(false) {
+}
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+bool MappedFile::Open(const std::string& filename) {
+    Close();
+    return Map(filename) || ReadToBuffer(filename);
+}
+
+void MappedFile::Close() {
+    if (m_mapped) {
+#if defined(_WIN32)
+        UnmapViewOfFile(m_data);
+#elif REVOLT_HAS_MMAP
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+    }
+
+    m_data = nullptr;
+    m_size = 0;
+    m_mapped = false;
+    std::vector<uint8_t>().swap(m_buffer);
+}
+
+bool MappedFile::Map(const std::string& filename) {
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    }
+    // Отображение держит файл само - дескрипторы больше не нужны
+    CloseHandle(file);
+    if (!mapping) {
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!view) {
+        return false;
+    }
+
+    m_data = static_cast<const uint8_t*>(view);
+    m_size = static_cast<size_t>(fileSize.QuadPart);
+    m_mapped = true;
+    return true;
+#elif REVOLT_HAS_MMAP
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    void* view = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (view == MAP_FAILED) {
+        return false;
+    }
+
+#ifdef MADV_WILLNEED
+    // Файлы ресурсов читаются целиком сразу после открытия
+    madvise(view, static_cast<size_t>(info.st_size), MADV_WILLNEED);
+#endif
+
+    m_data = static_cast<const uint8_t*>(view);
+    m_size = static_cast<size_t>(info.st_size);
+    m_mapped = true;
+    return true;
+#else
+    (void)filename;
+    return false;
+#endif
+}
+
+bool MappedFile::ReadToBuffer(const std::string& filename) {
+    FILE* fp = fopen(filename.c_str(), "rb");
+    if (!fp) {
+        return false;
+    }
+
+    long fileSize = -1;
+    if (fseek(fp, 0, SEEK_END) == 0) {
+        fileSize = ftell(fp);
+        fseek(fp, 0, SEEK_SET);
+    }
+
+    bool success = fileSize > 0;
+    if (success) {
+        m_buffer.resize(static_cast<size_t>(fileSize));
+        success = fread(m_buffer.data(), 1, m_buffer.size(), fp) == m_buffer.size();
+    }
+    fclose(fp);
+
+    if (!success) {
+        std::vector<uint8_t>().swap(m_buffer);
+        return false;
+    }
+
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+    return true;
+}
+
+} // namespace Revolt
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Revolt {
+
+// Файл только для чтения, отображённый в память (mmap, MapViewOfFile).
+// Где отображения нет или оно не удалось, файл читается в буфер одним
+// вызовом - для вызывающего разницы нет. Данные выровнены как минимум на 16
+// байт. Пустой файл не открывается.
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const std::string& filename);
+    void Close();
+
+    bool IsOpen() const { return m_data != nullptr; }
+    // false - файл прочитан в буфер
+    bool IsMapped() const { return m_mapped; }
+    const uint8_t* GetData() const { return m_data; }
+    size_t GetSize() const { return m_size; }
+
+    // Есть ли bytes байт начиная с offset (без переполнения)
+    bool Contains(uint64_t offset, uint64_t bytes) const {
+        return offset <= m_size && bytes <= m_size - offset;
+    }
+
+private:
+    bool Map(const std::string& filename);
+    bool ReadToBuffer(const std::string& filename);
+
+    const uint8_t* m_data;
+    size_t m_size;
+    bool m_mapped;
+    std::vector<uint8_t> m_buffer;
+};
+
+} // namespace Revolt
@@ -0,0 +1,135 @@
+#include "Profiler.h"
+
+#if defined(REVOLT_ENABLE_PROFILER) && REVOLT_ENABLE_PROFILER
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace Revolt {
+
+namespace {
+
+struct ZoneEvent {
+    const char* name;
+    uint64_t start;
+    uint64_t end;
+};
+
+// Буфер пишет только свой поток; читатель берёт writeIndex с acquire
+// и видит все события до него
+struct ThreadBuffer {
+    uint32_t threadID;
+    std::atomic<const char*> name;
+    std::atomic<uint64_t> writeIndex;
+    ThreadBuffer* next;
+    ZoneEvent events[Profiler::RING_CAPACITY];
+};
+
+const std::chrono::steady_clock::time_point s_epoch = std::chrono::steady_clock::now();
+
+// Список буферов только растёт: поток добавляет свой через CAS, а буферы
+// не освобождаются, чтобы события завершившихся потоков попадали в трассу
+std::atomic<ThreadBuffer*> s_buffers(nullptr);
+std::atomic<uint32_t> s_nextThreadID(1);
+
+ThreadBuffer& GetThreadBuffer() {
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (!buffer) {
+        buffer = new ThreadBuffer();
+        buffer->threadID = s_nextThreadID.fetch_add(1, std::memory_order_relaxed);
+        buffer->name.store(nullptr, std::memory_order_relaxed);
+        buffer->writeIndex.store(0, std::memory_order_relaxed);
+
+        ThreadBuffer* head = s_buffers.load(std::memory_order_relaxed);
+        do {
+            buffer->next = head;
+        } while (!s_buffers.compare_exchange_weak(head, buffer, std::memory_order_release,
+                                                  std::memory_order_relaxed));
+    }
+    return *buffer;
+}
+
+void WriteEscaped(std::ostream& out, const char* text) {
+    for (; *text; ++text) {
+        if (*text == '"' || *text == '\\') {
+            out << '\\';
+        }
+        out << *text;
+    }
+}
+
+} // namespace
+
+uint64_t Profiler::Now() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - s_epoch).count());
+}
+
+void Profiler::Record(const char* name, uint64_t start, uint64_t end) {
+    ThreadBuffer& buffer = GetThreadBuffer();
+    uint64_t index = buffer.writeIndex.load(std::memory_order_relaxed);
+
+    ZoneEvent& event = buffer.events[index & (RING_CAPACITY - 1)];
+    event.name = name;
+    event.start = start;
+    event.end = end;
+
+    buffer.writeIndex.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::SetThreadName(const char* name) {
+    GetThreadBuffer().name.store(name, std::memory_order_release);
+}
+
+bool Profiler::WriteChromeTrace(const std::string& path) {
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "Failed to write profiler trace: " << path << std::endl;
+        return false;
+    }
+
+    // Время в трассе - микросекунды
+    file << std::fixed << std::setprecision(3);
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    bool first = true;
+    size_t eventCount = 0;
+    for (ThreadBuffer* buffer = s_buffers.load(std::memory_order_acquire); buffer; buffer = buffer->next) {
+        const char* threadName = buffer->name.load(std::memory_order_acquire);
+
+        file << (first ? "" : ",") << "\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":"
+             << buffer->threadID << ",\"args\":{\"name\":\"";
+        if (threadName) {
+            WriteEscaped(file, threadName);
+        } else {
+            file << "Thread " << buffer->threadID;
+        }
+        file << "\"}}";
+        first = false;
+
+        uint64_t end = buffer->writeIndex.load(std::memory_order_acquire);
+        uint64_t begin = end > RING_CAPACITY ? end - RING_CAPACITY : 0;
+
+        for (uint64_t i = begin; i < end; ++i) {
+            const ZoneEvent& event = buffer->events[i & (RING_CAPACITY - 1)];
+            file << ",\n{\"ph\":\"X\",\"name\":\"";
+            WriteEscaped(file, event.name);
+            file << "\",\"pid\":1,\"tid\":" << buffer->threadID
+                 << ",\"ts\":" << event.start / 1000.0
+                 << ",\"dur\":" << (event.end - event.start) / 1000.0 << "}";
+        }
+        eventCount += static_cast<size_t>(end - begin);
+    }
+
+    file << "\n]}\n";
+
+    std::cout << "Profiler trace written: " << path << " (" << eventCount << " zones)" << std::endl;
+    return static_cast<bool>(file);
+}
+
+} // namespace Revolt
+
+#endif
@@ -0,0 +1,71 @@
+#pragma once
+
+// Профилировщик CPU: зоны REVOLT_PROFILE_SCOPE пишутся в кольцевой буфер
+// своего потока без блокировок и выгружаются в формате Chrome trace
+// (chrome://tracing, Perfetto). Без REVOLT_ENABLE_PROFILER все макросы
+// пустые, а класс не объявляется.
+//
+//     void Window::SwapBuffers() {
+//         REVOLT_PROFILE_SCOPE("SwapBuffers");
+//         ...
+//     }
+//
+// Имя зоны - строковый литерал: хранится только указатель.
+
+#if defined(REVOLT_ENABLE_PROFILER) && REVOLT_ENABLE_PROFILER
+
+#include <cstdint>
+#include <string>
+
+namespace Revolt {
+
+class Profiler {
+public:
+    // Событий на поток; старые перезаписываются
+    static const uint32_t RING_CAPACITY = 1u << 16;
+
+    // Наносекунды от запуска программы
+    static uint64_t Now();
+
+    // Записывает завершённую зону в буфер текущего потока
+    static void Record(const char* name, uint64_t start, uint64_t end);
+
+    // Имя потока в трассе (по умолчанию "Thread N")
+    static void SetThreadName(const char* name);
+
+    // Пишет все буферы в JSON trace-event. Вызывается с любого потока;
+    // события, которые другие потоки пишут в этот момент, могут попасть
+    // в файл частично перезаписанными.
+    static bool WriteChromeTrace(const std::string& path);
+};
+
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name) : m_name(name), m_start(Profiler::Now()) {}
+    ~ProfileScope() { Profiler::Record(m_name, m_start, Profiler::Now()); }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* m_name;
+    uint64_t m_start;
+};
+
+} // namespace Revolt
+
+#define REVOLT_PROFILE_CONCAT_IMPL(a, b) a##b
+#define REVOLT_PROFILE_CONCAT(a, b) REVOLT_PROFILE_CONCAT_IMPL(a, b)
+
+#define REVOLT_PROFILE_SCOPE(name) \
+    ::Revolt::ProfileScope REVOLT_PROFILE_CONCAT(revoltProfileScope, __LINE__)(name)
+#define REVOLT_PROFILE_THREAD(name) ::Revolt::Profiler::SetThreadName(name)
+#define REVOLT_PROFILE_WRITE_TRACE(path) ::Revolt::Profiler::WriteChromeTrace(path)
+
+#else
+
+#define REVOLT_PROFILE_SCOPE(name) ((void)0)
+#define REVOLT_PROFILE_THREAD(name) ((void)0)
+#define REVOLT_PROFILE_WRITE_TRACE(path) ((void)0)
+
+#endif
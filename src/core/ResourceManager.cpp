@@ -1,53 +1,385 @@
 #include "ResourceManager.h"
 #include "../graphics/Mesh.h"
 #include "../graphics/MDLModel.h"
-#include <iostream>
+#include "Profiler.h"
+#include "Log.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 
 namespace Revolt {
+    namespace {
+        static_assert(sizeof(Vertex) == 6 * sizeof(float), "Cooked meshes store Vertex as is");
+        static_assert(sizeof(unsigned int) == sizeof(uint32_t), "Cooked indices are 32-bit");
+
+        bool IsMeshType(const std::string& name) {
+            return name == "Pyramid" || name == "Cube" || name == "Torus";
+        }
+
+        bool UploadMesh(Mesh& mesh) {
+            mesh.UploadGeometry();
+            return true;
+        }
+
+        // Распаковка без OpenGL: подготовленный файл, если он свежий, иначе сам .mdl
+        bool DecodeMDLModel(const std::string& filename, MDLModel& model) {
+            std::string cookedPath = Cooked::GetCookedPath(filename, Cooked::MODEL_EXTENSION);
+            if (Cooked::IsFresh(cookedPath, filename, Cooked::MODEL_MAGIC, Cooked::MODEL_VERSION) && model.LoadCooked(cookedPath)) {
+                REVOLT_LOG(Debug, Resources, "Using cooked MDL model: %s", cookedPath.c_str());
+                return true;
+            }
+            return model.ParseFile(filename);
+        }
+
+        // Запись пакета целиком лежит в файле, индексы не выходят за вершины
+        bool IsValidMeshEntry(const MappedFile& file, const Cooked::MeshEntry& entry) {
+            if (!std::memchr(entry.key, 0, sizeof(entry.key)) || entry.vertexCount < 0 || entry.indexCount < 0 ||
+                entry.vertexOffset % Cooked::SECTION_ALIGNMENT != 0 || entry.indexOffset % Cooked::SECTION_ALIGNMENT != 0 ||
+                !file.Contains(entry.vertexOffset, static_cast<uint64_t>(entry.vertexCount) * sizeof(Vertex)) ||
+                !file.Contains(entry.indexOffset, static_cast<uint64_t>(entry.indexCount) * sizeof(uint32_t))) {
+                return false;
+            }
+
+            const uint32_t* indices = reinterpret_cast<const uint32_t*>(file.GetData() + entry.indexOffset);
+            for (int32_t i = 0; i < entry.indexCount; ++i) {
+                if (indices[i] >= static_cast<uint32_t>(entry.vertexCount)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+
+    std::string ResourceManager::MakeMeshKey(const MeshDesc& desc) {
+        return desc.type + "_" + std::to_string(desc.param1) + "_" + std::to_string(desc.param2) + "_" +
+               std::to_string(desc.param3) + "_" + std::to_string(desc.param4);
+    }
+
+    std::shared_ptr<Mesh> ResourceManager::CreateProceduralMesh(const MeshDesc& desc) {
+        if (desc.type == "Pyramid") {
+            return std::make_shared<PyramidMesh>(desc.param1, desc.param2);
+        } else if (desc.type == "Cube") {
+            return std::make_shared<CubeMesh>(desc.param1);
+        } else if (desc.type == "Torus") {
+            return std::make_shared<TorusMesh>(desc.param1, desc.param2, desc.param3, desc.param4);
+        }
+        return nullptr;
+    }
+
+    bool ResourceManager::CookMeshPack(const std::vector<MeshDesc>& meshes, const Cooked::SourceStamp& source, std::vector<uint8_t>& out) {
+        std::vector<Cooked::MeshEntry> entries;
+        std::vector<std::shared_ptr<Mesh>> built;
+        for (const MeshDesc& desc : meshes) {
+            std::string key = MakeMeshKey(desc);
+            bool duplicate = std::any_of(entries.begin(), entries.end(),
+                                         [&key](const Cooked::MeshEntry& entry) { return key == entry.key; });
+            std::shared_ptr<Mesh> mesh = duplicate ? nullptr : CreateProceduralMesh(desc);
+            if (!mesh) {
+                continue;
+            }
+            if (key.size() >= sizeof(Cooked::MeshEntry::key)) {
+                REVOLT_LOG(Error, Resources, "Mesh key is too long to cook: %s", key.c_str());
+                return false;
+            }
+
+            Cooked::MeshEntry entry;
+            std::memset(&entry, 0, sizeof(entry));
+            std::memcpy(entry.key, key.c_str(), key.size());
+            entry.vertexCount = static_cast<int32_t>(mesh->GetVertexCount());
+            entry.indexCount = static_cast<int32_t>(mesh->GetIndexCount());
+            std::memcpy(entry.boundsMin, mesh->GetBounds().min, sizeof(entry.boundsMin));
+            std::memcpy(entry.boundsMax, mesh->GetBounds().max, sizeof(entry.boundsMax));
+            entries.push_back(entry);
+            built.push_back(mesh);
+        }
+
+        Cooked::MeshPackHeader header;
+        std::memset(&header, 0, sizeof(header));
+        header.file.magic = Cooked::MESH_PACK_MAGIC;
+        header.file.version = Cooked::MESH_PACK_VERSION;
+        header.file.source = source;
+        header.meshCount = static_cast<int32_t>(entries.size());
+
+        out.clear();
+        Cooked::AppendSection(out, &header, sizeof(header));
+        // Записи дописываются после геометрии, когда известны смещения
+        header.entryOffset = Cooked::AppendSection(out, entries.data(), entries.size() * sizeof(Cooked::MeshEntry));
+        for (size_t i = 0; i < entries.size(); ++i) {
+            const std::vector<Vertex>& vertices = built[i]->GetVertices();
+            const std::vector<unsigned int>& indices = built[i]->GetIndices();
+            entries[i].vertexOffset = Cooked::AppendSection(out, vertices.data(), vertices.size() * sizeof(Vertex));
+            entries[i].indexOffset = Cooked::AppendSection(out, indices.data(), indices.size() * sizeof(uint32_t));
+        }
+
+        std::memcpy(out.data(), &header, sizeof(header));
+        if (!entries.empty()) {
+            std::memcpy(out.data() + header.entryOffset, entries.data(), entries.size() * sizeof(Cooked::MeshEntry));
+        }
+        return true;
+    }
+
+    int ResourceManager::LoadCookedMeshes(const std::string& scenePath) {
+        REVOLT_PROFILE_SCOPE("ResourceManager::LoadCookedMeshes");
+        std::string cookedPath = Cooked::GetCookedPath(scenePath, Cooked::MESH_PACK_EXTENSION);
+        if (!Cooked::IsFresh(cookedPath, scenePath, Cooked::MESH_PACK_MAGIC, Cooked::MESH_PACK_VERSION)) {
+            return 0;
+        }
+
+        auto file = std::make_shared<MappedFile>();
+        Cooked::MeshPackHeader header;
+        bool valid = file->Open(cookedPath) && file->Contains(0, sizeof(header));
+        if (valid) {
+            std::memcpy(&header, file->GetData(), sizeof(header));
+            valid = header.meshCount >= 0 && header.entryOffset % Cooked::SECTION_ALIGNMENT == 0 &&
+                    file->Contains(header.entryOffset, static_cast<uint64_t>(header.meshCount) * sizeof(Cooked::MeshEntry));
+        }
+
+        const Cooked::MeshEntry* entries = valid ? reinterpret_cast<const Cooked::MeshEntry*>(file->GetData() + header.entryOffset) : nullptr;
+        for (int32_t i = 0; valid && i < header.meshCount; ++i) {
+            valid = IsValidMeshEntry(*file, entries[i]);
+        }
+        if (!valid) {
+            REVOLT_LOG(Error, Resources, "Invalid cooked mesh pack: %s", cookedPath.c_str());
+            return 0;
+        }
+
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        for (int32_t i = 0; i < header.meshCount; ++i) {
+            m_cookedMeshes[entries[i].key] = CookedMeshSource{file, &entries[i]};
+        }
+        REVOLT_LOG(Info, Resources, "Using cooked meshes: %s (%d meshes)", cookedPath.c_str(), header.meshCount);
+        return header.meshCount;
+    }
+
+    std::shared_ptr<Mesh> ResourceManager::CreateMesh(const MeshDesc& desc, const std::string& key) {
+        CookedMeshSource cooked = {};
+        {
+            std::lock_guard<std::mutex> lock(m_cacheMutex);
+            auto it = m_cookedMeshes.find(key);
+            if (it != m_cookedMeshes.end()) {
+                cooked = it->second;
+            }
+        }
+
+        if (!cooked.entry) {
+            return CreateProceduralMesh(desc);
+        }
+
+        const Cooked::MeshEntry& entry = *cooked.entry;
+        const uint8_t* data = cooked.file->GetData();
+        BoundingBox bounds(entry.boundsMin[0], entry.boundsMin[1], entry.boundsMin[2],
+                           entry.boundsMax[0], entry.boundsMax[1], entry.boundsMax[2]);
+        return std::make_shared<CookedMesh>(reinterpret_cast<const Vertex*>(data + entry.vertexOffset), entry.vertexCount,
+                                            reinterpret_cast<const unsigned int*>(data + entry.indexOffset), entry.indexCount, bounds);
+    }
+
     ResourceManager& ResourceManager::GetInstance() {
         static ResourceManager instance;
         return instance;
     }
-    
-    std::shared_ptr<Mesh> ResourceManager::LoadMesh(const std::string& name, float param1, float param2, int param3, int param4) {
-        std::string key = name + "_" + std::to_string(param1) + "_" + std::to_string(param2) + "_" + std::to_string(param3) + "_" + std::to_string(param4);
-        
+
+    std::shared_ptr<ResourceManager::MeshLoadState> ResourceManager::AcquireMesh(const MeshDesc& desc, bool& created) {
+        std::string key = MakeMeshKey(desc);
+
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
         auto it = m_meshCache.find(key);
         if (it != m_meshCache.end()) {
-            std::cout << "Using cached mesh: " << key << std::endl;
+            REVOLT_LOG(Debug, Resources, "Using cached mesh: %s", key.c_str());
+            created = false;
             return it->second;
         }
-        
-        std::shared_ptr<Mesh> mesh;
-        if (name == "Pyramid") {
-            mesh = std::make_shared<PyramidMesh>(param1, param2);
-        } else if (name == "Cube") {
-            mesh = std::make_shared<CubeMesh>(param1);
-        } else if (name == "Torus") {
-            mesh = std::make_shared<TorusMesh>(param1, param2, param3, param4);
+
+        // Сам меш появится после распаковки
+        auto state = std::make_shared<MeshLoadState>(key, nullptr);
+        state->upload = UploadMesh;
+        m_meshCache[key] = state;
+        m_pendingLoads.fetch_add(1, std::memory_order_relaxed);
+        created = true;
+        return state;
+    }
+
+    std::shared_ptr<Mesh> ResourceManager::LoadMesh(const std::string& name, float param1, float param2, int param3, int param4) {
+        REVOLT_PROFILE_SCOPE("ResourceManager::LoadMesh");
+        if (!IsMeshType(name)) {
+            return nullptr;
+        }
+
+        MeshDesc desc;
+        desc.type = name;
+        desc.param1 = param1;
+        desc.param2 = param2;
+        desc.param3 = param3;
+        desc.param4 = param4;
+
+        bool created = false;
+        auto state = AcquireMesh(desc, created);
+        if (created) {
+            state->asset = CreateMesh(desc, state->name);
+            REVOLT_LOG(Info, Resources, "Created new mesh: %s", state->name.c_str());
+            CompleteDecode(state, state->asset != nullptr);
+        }
+        return Wait(AssetHandle<Mesh>(state));
+    }
+
+    AssetHandle<Mesh> ResourceManager::LoadMeshAsync(const std::string& name, float param1, float param2, int param3, int param4) {
+        REVOLT_PROFILE_SCOPE("ResourceManager::LoadMeshAsync");
+        if (!IsMeshType(name)) {
+            return AssetHandle<Mesh>();
         }
-        
-        if (mesh) {
-            std::cout << "Created new mesh: " << key << std::endl;
-            m_meshCache[key] = mesh;
+
+        MeshDesc desc;
+        desc.type = name;
+        desc.param1 = param1;
+        desc.param2 = param2;
+        desc.param3 = param3;
+        desc.param4 = param4;
+
+        bool created = false;
+        auto state = AcquireMesh(desc, created);
+        if (created) {
+            m_workers.Start();
+            m_workers.Submit([this, state, desc] {
+                REVOLT_PROFILE_SCOPE("ResourceManager::CreateMesh");
+                state->asset = CreateMesh(desc, state->name);
+                REVOLT_LOG(Info, Resources, "Created new mesh: %s", state->name.c_str());
+                CompleteDecode(state, state->asset != nullptr);
+            });
         }
-        
-        return mesh;
+        return AssetHandle<Mesh>(state);
     }
-    
-    std::shared_ptr<MDLModel> ResourceManager::LoadMDLModel(const std::string& filename) {
+
+    void ResourceManager::SetPalettizedSkins(bool enabled) {
+        if (!m_skinAtlas.SetFormat(enabled ? TextureAtlas::Format::Indexed : TextureAtlas::Format::RGBA)) {
+            REVOLT_LOG(Error, Resources, "Skin format can't change after models are loaded");
+        }
+    }
+
+    std::shared_ptr<ResourceManager::MDLLoadState> ResourceManager::AcquireMDLModel(const std::string& filename, bool& created) {
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
         auto it = m_mdlCache.find(filename);
         if (it != m_mdlCache.end()) {
-            std::cout << "Using cached MDL model: " << filename << std::endl;
+            REVOLT_LOG(Debug, Resources, "Using cached MDL model: %s", filename.c_str());
+            created = false;
             return it->second;
         }
-        
-        auto model = std::make_shared<MDLModel>();
-        if (model->LoadFromFile(filename)) {
-            m_mdlCache[filename] = model;
-            return model;
+
+        auto state = std::make_shared<MDLLoadState>(filename, std::make_shared<MDLModel>());
+        state->upload = [this, filename](MDLModel& model) { return UploadMDLModel(filename, model); };
+        m_mdlCache[filename] = state;
+        m_pendingLoads.fetch_add(1, std::memory_order_relaxed);
+        created = true;
+        return state;
+    }
+
+    bool ResourceManager::UploadMDLModel(const std::string& filename, MDLModel& model) {
+        REVOLT_PROFILE_SCOPE("ResourceManager::UploadMDLModel");
+        model.AddSkinsToAtlas(m_skinAtlas);
+        model.CreateGPUResources();
+        m_skinAtlas.PrintStats();
+        REVOLT_LOG(Info, Resources, "Loaded MDL model: %s (%d frames, %d skins)", filename.c_str(),
+                   model.GetFrameCount(), model.GetSkinCount());
+        return true;
+    }
+
+    std::shared_ptr<MDLModel> ResourceManager::LoadMDLModel(const std::string& filename) {
+        REVOLT_PROFILE_SCOPE("ResourceManager::LoadMDLModel");
+        bool created = false;
+        auto state = AcquireMDLModel(filename, created);
+        if (created) {
+            CompleteDecode(state, DecodeMDLModel(filename, *state->asset));
         }
-        
-        return nullptr;
+        return Wait(AssetHandle<MDLModel>(state));
+    }
+
+    AssetHandle<MDLModel> ResourceManager::LoadMDLModelAsync(const std::string& filename) {
+        REVOLT_PROFILE_SCOPE("ResourceManager::LoadMDLModelAsync");
+        bool created = false;
+        auto state = AcquireMDLModel(filename, created);
+        if (created) {
+            m_workers.Start();
+            m_workers.Submit([this, state] {
+                REVOLT_PROFILE_SCOPE("ResourceManager::ParseMDL");
+                CompleteDecode(state, DecodeMDLModel(state->name, *state->asset));
+            });
+        }
+        return AssetHandle<MDLModel>(state);
+    }
+
+    void ResourceManager::CompleteDecode(const std::shared_ptr<AssetLoadState>& state, bool success) {
+        if (!success) {
+            REVOLT_LOG(Error, Resources, "Failed to load resource: %s", state->name.c_str());
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_uploadMutex);
+            if (success) {
+                m_uploads.push_back(state);
+                state->status.store(AssetStatus::Uploading, std::memory_order_release);
+            } else {
+                state->status.store(AssetStatus::Failed, std::memory_order_release);
+                m_pendingLoads.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+        m_decodeDone.notify_all();
+    }
+
+    void ResourceManager::FinishLoad(AssetLoadState& state) {
+        std::shared_ptr<AssetLoadState> upload;
+        {
+            std::unique_lock<std::mutex> lock(m_uploadMutex);
+            m_decodeDone.wait(lock, [&state] {
+                return state.status.load(std::memory_order_acquire) != AssetStatus::Loading;
+            });
+
+            // Очередь разбирает только главный поток, так что Uploading означает "в очереди"
+            auto it = std::find_if(m_uploads.begin(), m_uploads.end(),
+                                   [&state](const std::shared_ptr<AssetLoadState>& pending) { return pending.get() == &state; });
+            if (it == m_uploads.end()) {
+                return;
+            }
+            upload = *it;
+            m_uploads.erase(it);
+        }
+        RunUpload(*upload);
+    }
+
+    void ResourceManager::RunUpload(AssetLoadState& state) {
+        bool success = state.Upload();
+        if (!success) {
+            REVOLT_LOG(Error, Resources, "Failed to create GPU resources: %s", state.name.c_str());
+        }
+        state.status.store(success ? AssetStatus::Ready : AssetStatus::Failed, std::memory_order_release);
+        m_pendingLoads.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    int ResourceManager::ProcessUploads(float budgetMs) {
+        REVOLT_PROFILE_SCOPE("ResourceManager::ProcessUploads");
+        auto start = std::chrono::steady_clock::now();
+        int processed = 0;
+
+        for (;;) {
+            std::shared_ptr<AssetLoadState> state;
+            {
+                std::lock_guard<std::mutex> lock(m_uploadMutex);
+                if (m_uploads.empty()) {
+                    break;
+                }
+                state = m_uploads.front();
+                m_uploads.pop_front();
+            }
+
+            RunUpload(*state);
+            ++processed;
+
+            std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            if (elapsed.count() >= budgetMs) {
+                break;
+            }
+        }
+        return processed;
+    }
+
+    void ResourceManager::Shutdown() {
+        m_workers.Stop();
     }
-}
\ No newline at end of file
+}
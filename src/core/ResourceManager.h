@@ -1,25 +1,125 @@
 #pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <string>
+#include <vector>
+#include "AssetHandle.h"
+#include "MappedFile.h"
+#include "WorkerPool.h"
+#include "../graphics/CookedAsset.h"
+#include "../graphics/TextureAtlas.h"
 
 namespace Revolt {
     class Mesh;
     class MDLModel; // Добавляем forward declaration
-    
+
+    // Загрузка идёт в два этапа: чтение и распаковка файла на рабочих потоках,
+    // затем создание текстур и буферов на главном потоке в ProcessUploads.
+    // Повторные запросы того же ресурса, в том числе пока он загружается,
+    // получают общее состояние - файл читается один раз. Неудачные загрузки
+    // тоже кэшируются. Синхронные Load* и Wait вызываются только из главного
+    // потока: они доделывают загрузку сами, не дожидаясь ProcessUploads.
+    // Свежие подготовленные файлы (.rmdl, .rmesh - см. CookedAsset.h)
+    // используются вместо исходников.
     class ResourceManager {
     public:
+        static constexpr float DEFAULT_UPLOAD_BUDGET_MS = 2.0f;
+
+        // Процедурный меш с параметрами, как его описывает сцена
+        struct MeshDesc {
+            std::string type;
+            float param1 = 1.0f;
+            float param2 = 1.0f;
+            int param3 = 16;
+            int param4 = 8;
+        };
+
+        // Ключ кэша мешей; под ним же меш лежит в подготовленном пакете
+        static std::string MakeMeshKey(const MeshDesc& desc);
+        // Строит геометрию в обход кэша, без OpenGL; nullptr для неизвестного типа
+        static std::shared_ptr<Mesh> CreateProceduralMesh(const MeshDesc& desc);
+        // Пакет .rmesh с геометрией мешей (повторы пишутся один раз)
+        static bool CookMeshPack(const std::vector<MeshDesc>& meshes, const Cooked::SourceStamp& source, std::vector<uint8_t>& out);
+
         static ResourceManager& GetInstance();
-        
+
         // Загружает меш по имени типа ("Pyramid", "Cube", "Torus") с параметрами
         std::shared_ptr<Mesh> LoadMesh(const std::string& name, float param1 = 1.0f, float param2 = 1.0f, int param3 = 16, int param4 = 8);
-        
+        // Геометрия строится на рабочем потоке; для неизвестного типа handle невалиден
+        AssetHandle<Mesh> LoadMeshAsync(const std::string& name, float param1 = 1.0f, float param2 = 1.0f, int param3 = 16, int param4 = 8);
+
+        // Подключает пакет мешей, подготовленный для сцены, если он свежий:
+        // меши из него дальше берутся готовыми. Возвращает их число
+        int LoadCookedMeshes(const std::string& scenePath);
+
         // Загружает MDL модель
         std::shared_ptr<MDLModel> LoadMDLModel(const std::string& filename);
-        
+        AssetHandle<MDLModel> LoadMDLModelAsync(const std::string& filename);
+
+        // Блокирует до конца загрузки; nullptr, если она не удалась
+        template <typename T>
+        std::shared_ptr<T> Wait(const AssetHandle<T>& handle) {
+            if (!handle.IsValid()) {
+                return nullptr;
+            }
+            FinishLoad(*handle.m_state);
+            return handle.Get();
+        }
+
+        // Создаёт объекты GL для распакованных ресурсов, пока не выйдет бюджет
+        // (хотя бы один ресурс за вызов). Возвращает число обработанных.
+        int ProcessUploads(float budgetMs = DEFAULT_UPLOAD_BUDGET_MS);
+        // Загрузки, ещё не ставшие Ready или Failed
+        int GetPendingCount() const { return m_pendingLoads.load(std::memory_order_relaxed); }
+
+        // Останавливает рабочие потоки; незавершённые загрузки бросаются
+        void Shutdown();
+
+        // Общий атлас скинов всех загруженных MDL моделей
+        const TextureAtlas& GetSkinAtlas() const { return m_skinAtlas; }
+
+        // Хранить скины индексами палитры (нужен шейдер рендерера).
+        // Действует только до загрузки первой модели.
+        void SetPalettizedSkins(bool enabled);
+
     private:
+        typedef TypedAssetLoadState<Mesh> MeshLoadState;
+        typedef TypedAssetLoadState<MDLModel> MDLLoadState;
+
         ResourceManager() = default;
-        std::unordered_map<std::string, std::shared_ptr<Mesh>> m_meshCache;
-        std::unordered_map<std::string, std::shared_ptr<MDLModel>> m_mdlCache; // Кэш для MDL моделей
+
+        // Меш из подготовленного пакета в файле, который держится, пока на него есть ссылки
+        struct CookedMeshSource {
+            std::shared_ptr<MappedFile> file;
+            const Cooked::MeshEntry* entry;
+        };
+
+        std::shared_ptr<MeshLoadState> AcquireMesh(const MeshDesc& desc, bool& created);
+        std::shared_ptr<Mesh> CreateMesh(const MeshDesc& desc, const std::string& key);
+        std::shared_ptr<MDLLoadState> AcquireMDLModel(const std::string& filename, bool& created);
+        bool UploadMDLModel(const std::string& filename, MDLModel& model);
+
+        // Переводит загрузку в Uploading (в очередь главного потока) или Failed
+        void CompleteDecode(const std::shared_ptr<AssetLoadState>& state, bool success);
+        void FinishLoad(AssetLoadState& state);
+        void RunUpload(AssetLoadState& state);
+
+        std::mutex m_cacheMutex;
+        std::unordered_map<std::string, std::shared_ptr<MeshLoadState>> m_meshCache;
+        std::unordered_map<std::string, CookedMeshSource> m_cookedMeshes;
+        std::unordered_map<std::string, std::shared_ptr<MDLLoadState>> m_mdlCache; // Кэш для MDL моделей
+        TextureAtlas m_skinAtlas;
+
+        std::mutex m_uploadMutex;
+        std::condition_variable m_decodeDone;
+        std::deque<std::shared_ptr<AssetLoadState>> m_uploads;
+        std::atomic<int> m_pendingLoads{0};
+
+        // Последним: потоки останавливаются раньше, чем разрушаются кэши и очереди
+        WorkerPool m_workers;
     };
-}
\ No newline at end of file
+}
@@ -20,6 +20,12 @@ void Scene::RemoveGameObject(GameObject* object) {
     );
 }
 
+void Scene::Truncate(size_t count) {
+    if (count < m_objects.size()) {
+        m_objects.erase(m_objects.begin() + count, m_objects.end());
+    }
+}
+
 void Scene::Update(float deltaTime) {
     // Просто вызываем Update для всех объектов
     for (auto& obj : m_objects) {
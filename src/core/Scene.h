@@ -9,7 +9,11 @@ namespace Revolt {
         Scene();
         
         GameObject* CreateGameObject();
+        // Место под count новых объектов - перед созданием их пачкой
+        void Reserve(size_t count) { m_objects.reserve(m_objects.size() + count); }
         void RemoveGameObject(GameObject* object);
+        // Удаляет объекты, созданные после первых count
+        void Truncate(size_t count);
         
         const std::vector<std::unique_ptr<GameObject>>& GetObjects() const { return m_objects; }
         
@@ -2,191 +2,625 @@
 #include "Scene.h"
 #include "Camera.h"
 #include "ResourceManager.h"
+#include "MappedFile.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cstring>
 #include <fstream>
+#include <functional>
+#include <iterator>
+#include <unordered_map>
 #include <nlohmann/json.hpp>
 
 using json = nlohmann::json;
 
 namespace Revolt {
 
-bool SceneLoader::LoadSceneFromFile(const std::string& filepath, Scene& scene, Camera& camera) {
-    std::cout << "Loading scene from: " << filepath << std::endl;
-    
-    std::ifstream file(filepath);
-    if (!file.is_open()) {
-        std::cerr << "Failed to open scene file: " << filepath << std::endl;
-        CreateDemoScene(scene, camera);
-        return false;
+namespace {
+    // Параметры процедурного меша с умолчаниями сцены; false - тип не процедурный.
+    // Общая для загрузки и RevoltCook, чтобы ключи мешей совпадали
+    bool ReadMeshDesc(const json& objData, const std::string& type, ResourceManager::MeshDesc& desc) {
+        const json params = objData.contains("parameters") ? objData["parameters"] : json::object();
+        desc = ResourceManager::MeshDesc();
+        desc.type = type;
+        if (type == "Pyramid") {
+            desc.param1 = params.value("base", 1.0f);
+            desc.param2 = params.value("height", 1.5f);
+        } else if (type == "Cube") {
+            desc.param1 = params.value("size", 0.8f);
+        } else if (type == "Torus") {
+            desc.param1 = params.value("majorRadius", 1.0f);
+            desc.param2 = params.value("minorRadius", 0.3f);
+            desc.param3 = params.value("majorSegments", 16);
+            desc.param4 = params.value("minorSegments", 8);
+        } else {
+            return false;
+        }
+        return true;
     }
-    
-    try {
-        json sceneData = json::parse(file);
+
+    // Имена процедурных мешей по порядку Cooked::SceneResourceType
+    const char* const MESH_TYPE_NAMES[] = {"Pyramid", "Cube", "Torus"};
+
+    // Первые count чисел массива key, если их там не меньше
+    void ReadFloats(const json& data, const char* key, float* out, size_t count) {
+        if (data.contains(key) && data[key].size() >= count) {
+            const auto& values = data[key];
+            for (size_t i = 0; i < count; ++i) {
+                out[i] = values[i];
+            }
+        }
+    }
+
+    // Камера с умолчаниями сцены
+    struct CameraDesc {
+        float fov = 1.0472f;
+        float aspect = 16.0f / 9.0f; // Фиксированное соотношение сторон, если не задано
+        float nearPlane = 0.1f;
+        float farPlane = 100.0f;
+        float position[3] = {0.0f, 0.0f, 2.0f};
+        float lookAt[3] = {0.0f, 0.0f, 0.0f};
+    };
+
+    void ReadCamera(const json& camData, CameraDesc& desc) {
+        desc = CameraDesc();
+        if (!camData.is_object()) {
+            return;
+        }
+        desc.fov = camData.value("fov", desc.fov);
+        desc.aspect = camData.value("aspect", desc.aspect);
+        desc.nearPlane = camData.value("near", desc.nearPlane);
+        desc.farPlane = camData.value("far", desc.farPlane);
+        // Позиция берётся только вместе с lookAt
+        if (camData.contains("position") && camData.contains("lookAt") &&
+            camData["position"].size() >= 3 && camData["lookAt"].size() >= 3) {
+            ReadFloats(camData, "position", desc.position, 3);
+            ReadFloats(camData, "lookAt", desc.lookAt, 3);
+        }
+    }
+
+    // Объект сцены из записи JSON. Объект создаётся всегда, даже для записи
+    // без типа или с неизвестным типом - так было и при чтении всего документа
+    void LoadObject(const json& objData, Scene& scene, ResourceManager& resourceManager) {
+        GameObject* obj = scene.CreateGameObject();
+        std::shared_ptr<Mesh> mesh;
         
-        // Загрузка камеры с проверками
-        if (!sceneData.contains("camera")) {
-            std::cerr << "No camera data in scene file" << std::endl;
-            CreateDemoScene(scene, camera);
-            return false;
+        // Проверяем обязательные поля
+        if (!objData.contains("type")) {
+            std::cerr << "Object missing type" << std::endl;
+            return;
         }
         
-        const auto& camData = sceneData["camera"];
+        // Загрузка трансформации с проверками (ПЕРЕМЕЩАЕМ ЭТО ВЫШЕ)
+        float posX = 0.0f, posY = 0.0f, posZ = 0.0f;
+        float rotX = 0.0f, rotY = 0.0f, rotZ = 0.0f;
+        float scaleX = 1.0f, scaleY = 1.0f, scaleZ = 1.0f;
+        
+        if (objData.contains("position") && objData["position"].size() >= 3) {
+            const auto& position = objData["position"];
+            posX = position[0]; posY = position[1]; posZ = position[2];
+        }
         
-        // Используем фиксированное соотношение сторон или из данных
-        float aspect = camData.contains("aspect") ? camData["aspect"] : (16.0f / 9.0f);
-        float fov = camData.contains("fov") ? camData["fov"] : 1.0472f;
-        float nearPlane = camData.contains("near") ? camData["near"] : 0.1f;
-        float farPlane = camData.contains("far") ? camData["far"] : 100.0f;
+        if (objData.contains("rotation") && objData["rotation"].size() >= 3) {
+            const auto& rotation = objData["rotation"];
+            rotX = rotation[0]; rotY = rotation[1]; rotZ = rotation[2];
+        }
+        
+        if (objData.contains("scale") && objData["scale"].size() >= 3) {
+            const auto& scale = objData["scale"];
+            scaleX = scale[0]; scaleY = scale[1]; scaleZ = scale[2];
+        }
         
-        camera.SetPerspective(fov, aspect, nearPlane, farPlane);
+        std::string type = objData["type"];
         
-        // Позиция и lookAt с проверками
-        if (camData.contains("position") && camData.contains("lookAt")) {
-            const auto& pos = camData["position"];
-            const auto& lookAt = camData["lookAt"];
+        ResourceManager::MeshDesc meshDesc;
+        if (ReadMeshDesc(objData, type, meshDesc)) {
+            mesh = resourceManager.LoadMesh(meshDesc.type, meshDesc.param1, meshDesc.param2, meshDesc.param3, meshDesc.param4);
+        } else if (type == "MDLModel") {
+            // Загрузка MDL модели
+            if (objData.contains("filename")) {
+                std::string filename = objData["filename"];
+                // Файл читается в фоне; объект появится, когда модель догрузится,
+                // а об ошибке сообщит ResourceManager
+                obj->SetMDLModel(resourceManager.LoadMDLModelAsync(filename));
+                std::cout << "Loading MDL model: " << filename << std::endl;
+            }
+        } else {
+            std::cerr << "Unknown object type: " << type << std::endl;
+            return;
+        }
+        
+        if (mesh || obj->GetMDLModel() || obj->IsLoading()) {
+            if (mesh) {
+                obj->SetMesh(mesh);
+            }
             
-            if (pos.size() >= 3 && lookAt.size() >= 3) {
-                camera.LookAt(pos[0], pos[1], pos[2], lookAt[0], lookAt[1], lookAt[2]);
-            } else {
-                camera.LookAt(0.0f, 0.0f, 2.0f, 0.0f, 0.0f, 0.0f);
+            // Загрузка материала с проверками
+            Material material(1.0f, 1.0f, 1.0f); // Белый по умолчанию
+            if (objData.contains("material") && objData["material"].contains("color")) {
+                const auto& color = objData["material"]["color"];
+                if (color.size() >= 3) {
+                    float r = color[0];
+                    float g = color[1];
+                    float b = color[2];
+                    float a = (color.size() >= 4) ? color[3].get<float>() : 1.0f;
+                    material = Material(r, g, b, a);
+                }
+            }
+            obj->SetMaterial(material);
+        
+            // ДЕБАГ: выводим ВСЕ параметры
+            std::cout << "Loaded " << type << " - ";
+            // Параметры - с подставленными умолчаниями: в записи их может не быть
+            if (type == "Pyramid") {
+                std::cout << "base: " << meshDesc.param1 << ", height: " << meshDesc.param2;
+            } else if (type == "Cube") {
+                std::cout << "size: " << meshDesc.param1;
+            } else if (type == "Torus") {
+                std::cout << "majorRadius: " << meshDesc.param1 << ", minorRadius: " << meshDesc.param2;
+            } else if (type == "MDLModel") {
+                std::cout << "filename: " << objData["filename"];
             }
+            std::cout << ", color: (" << material.GetR() << ", " << material.GetG() << ", " << material.GetB() << ", " << material.GetA()
+                      << ")" << std::endl;
+        }
+        
+        // Устанавливаем трансформацию
+        obj->SetPosition(posX, posY, posZ);
+        
+        // Применяем специальные повороты для разных типов объектов
+        if (type == "Torus") {
+            obj->SetRotation(rotX + 90.0f, rotY, rotZ);
+        } else if (type == "MDLModel") {
+            obj->SetRotation(rotX, rotY, rotZ);
         } else {
-            camera.LookAt(0.0f, 0.0f, 2.0f, 0.0f, 0.0f, 0.0f);
+            obj->SetRotation(rotX, rotY, rotZ);
         }
         
-        // Загрузка объектов с проверками
-        if (!sceneData.contains("objects")) {
-            std::cerr << "No objects in scene file" << std::endl;
-            CreateDemoScene(scene, camera);
+        obj->SetScale(scaleX, scaleY, scaleZ);
+        obj->UpdateTransform();
+    }
+
+    // Потоковый разбор сцены через SAX. В памяти только текущая запись - камера
+    // или один элемент "objects", а не весь документ; запись передаётся
+    // обработчику, как только закрыта. Остальные значения верхнего уровня
+    // пропускаются без сохранения.
+    class SceneReader : public json::json_sax_t {
+    public:
+        typedef std::function<void(const json&)> RecordHandler;
+
+        SceneReader(RecordHandler onCamera, RecordHandler onObject)
+            : m_onCamera(std::move(onCamera)), m_onObject(std::move(onObject)) {
+        }
+
+        // false - синтаксическая ошибка (GetError). Исключения обработчиков
+        // выходят наружу
+        bool Read(std::istream& input) { return json::sax_parse(input, this); }
+
+        bool HasCamera() const { return m_hasCamera; }
+        bool HasObjects() const { return m_hasObjects; }
+        const std::string& GetError() const { return m_error; }
+
+        bool null() override { return Value(json()); }
+        bool boolean(bool value) override { return Value(json(value)); }
+        bool number_integer(number_integer_t value) override { return Value(json(value)); }
+        bool number_unsigned(number_unsigned_t value) override { return Value(json(value)); }
+        bool number_float(number_float_t value, const string_t&) override { return Value(json(value)); }
+        bool string(string_t& value) override { return Value(json(std::move(value))); }
+        // В тексте JSON двоичных значений не бывает
+        bool binary(binary_t&) override { return Value(json()); }
+
+        bool start_object(std::size_t) override { return Open(json::object()); }
+        bool start_array(std::size_t) override { return Open(json::array()); }
+        bool end_object() override { return Close(); }
+        bool end_array() override { return Close(); }
+
+        bool key(string_t& value) override {
+            m_key = value;
+            return true;
+        }
+
+        bool parse_error(std::size_t, const std::string&, const json::exception& error) override {
+            m_error = error.what();
             return false;
         }
-        
-        auto& resourceManager = ResourceManager::GetInstance();
-        for (const auto& objData : sceneData["objects"]) {
-            auto obj = scene.CreateGameObject();
-            std::shared_ptr<Mesh> mesh;
-            
-            // Проверяем обязательные поля
+
+    private:
+        enum class Record {
+            None,
+            Camera,
+            Object
+        };
+
+        // Чем станет значение, которое начинается вне записи
+        Record Classify() {
+            if (m_depth == 1 && m_key == "camera") {
+                return Record::Camera;
+            }
+            if (m_depth == 1 && m_key == "objects") {
+                m_hasObjects = true;
+            }
+            return m_depth == 2 && m_inObjects ? Record::Object : Record::None;
+        }
+
+        bool Value(json&& value) {
+            if (!m_stack.empty()) {
+                Insert(std::move(value));
+                return true;
+            }
+
+            Record record = Classify();
+            if (record != Record::None) {
+                m_record = std::move(value);
+                Deliver(record);
+            }
+            return true;
+        }
+
+        bool Open(json&& container) {
+            if (!m_stack.empty()) {
+                m_stack.push_back(Insert(std::move(container)));
+                return true;
+            }
+
+            bool isObjects = m_depth == 1 && m_key == "objects";
+            m_recordType = Classify();
+            if (m_recordType == Record::None) {
+                // Вне записей хватает глубины вложенности
+                m_inObjects = isObjects && container.is_array();
+                ++m_depth;
+                return true;
+            }
+            m_record = std::move(container);
+            m_stack.push_back(&m_record);
+            return true;
+        }
+
+        bool Close() {
+            if (m_stack.empty()) {
+                --m_depth;
+                if (m_depth <= 1) {
+                    m_inObjects = false;
+                }
+                return true;
+            }
+
+            m_stack.pop_back();
+            if (m_stack.empty()) {
+                Deliver(m_recordType);
+            }
+            return true;
+        }
+
+        // Вложенное значение текущей записи; адрес стабилен, пока пишутся его потомки
+        json* Insert(json&& value) {
+            json& parent = *m_stack.back();
+            if (parent.is_array()) {
+                parent.push_back(std::move(value));
+                return &parent.back();
+            }
+            json& slot = parent[m_key];
+            slot = std::move(value);
+            return &slot;
+        }
+
+        void Deliver(Record record) {
+            if (record == Record::Camera) {
+                m_hasCamera = true;
+                m_onCamera(m_record);
+            } else {
+                m_onObject(m_record);
+            }
+            m_record = json();
+        }
+
+        RecordHandler m_onCamera;
+        RecordHandler m_onObject;
+
+        int m_depth = 0;            // Открытые контейнеры вне записи
+        bool m_inObjects = false;   // Внутри массива "objects" верхнего уровня
+        std::string m_key;
+        bool m_hasCamera = false;
+        bool m_hasObjects = false;
+        std::string m_error;
+
+        json m_record;
+        Record m_recordType = Record::None;
+        std::vector<json*> m_stack; // Открытые контейнеры записи
+    };
+}
+
+bool SceneLoader::LoadSceneFromFile(const std::string& filepath, Scene& scene, Camera& camera) {
+    REVOLT_PROFILE_SCOPE("SceneLoader::LoadSceneFromFile");
+    std::cout << "Loading scene from: " << filepath << std::endl;
+    
+    // Готовая геометрия мешей сцены, если RevoltCook её подготовил
+    auto& resourceManager = ResourceManager::GetInstance();
+    resourceManager.LoadCookedMeshes(filepath);
+    
+    std::string compiledPath = Cooked::GetCookedPath(filepath, Cooked::SCENE_EXTENSION);
+    if (Cooked::IsFresh(compiledPath, filepath, Cooked::SCENE_MAGIC, Cooked::SCENE_VERSION) &&
+        LoadCompiledScene(compiledPath, scene, camera)) {
+        return true;
+    }
+    
+    std::ifstream file(filepath);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open scene file: " << filepath << std::endl;
+        CreateDemoScene(scene, camera);
+        return false;
+    }
+    
+    // Объекты создаются по мере разбора. Если сцена окажется негодной,
+    // они удаляются и подставляется демо-сцена
+    size_t firstObject = scene.GetObjects().size();
+    size_t objectCount = 0;
+    SceneReader reader(
+        [&camera](const json& camData) {
+            CameraDesc desc;
+            ReadCamera(camData, desc);
+            camera.SetPerspective(desc.fov, desc.aspect, desc.nearPlane, desc.farPlane);
+            camera.LookAt(desc.position[0], desc.position[1], desc.position[2],
+                          desc.lookAt[0], desc.lookAt[1], desc.lookAt[2]);
+        },
+        [&](const json& objData) {
+            LoadObject(objData, scene, resourceManager);
+            ++objectCount;
+        });
+    
+    try {
+        if (!reader.Read(file)) {
+            std::cerr << "Error loading scene: " << reader.GetError() << std::endl;
+        } else if (!reader.HasCamera()) {
+            std::cerr << "No camera data in scene file" << std::endl;
+        } else if (!reader.HasObjects()) {
+            std::cerr << "No objects in scene file" << std::endl;
+        } else {
+            std::cout << "Scene loaded successfully: " << objectCount << " objects" << std::endl;
+            return true;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error loading scene: " << e.what() << std::endl;
+    }
+    
+    scene.Truncate(firstObject);
+    CreateDemoScene(scene, camera);
+    return false;
+}
+
+bool SceneLoader::CollectAssets(const std::string& filepath, std::vector<ResourceManager::MeshDesc>& meshes,
+                                std::vector<std::string>& models) {
+    std::ifstream file(filepath);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open scene file: " << filepath << std::endl;
+        return false;
+    }
+    
+    SceneReader reader(
+        [](const json&) {},
+        [&](const json& objData) {
             if (!objData.contains("type")) {
-                std::cerr << "Object missing type" << std::endl;
-                continue;
+                return;
             }
             
-            // Загрузка трансформации с проверками (ПЕРЕМЕЩАЕМ ЭТО ВЫШЕ)
-            float posX = 0.0f, posY = 0.0f, posZ = 0.0f;
-            float rotX = 0.0f, rotY = 0.0f, rotZ = 0.0f;
-            float scaleX = 1.0f, scaleY = 1.0f, scaleZ = 1.0f;
-            
-            if (objData.contains("position") && objData["position"].size() >= 3) {
-                const auto& position = objData["position"];
-                posX = position[0]; posY = position[1]; posZ = position[2];
+            std::string type = objData["type"];
+            ResourceManager::MeshDesc desc;
+            if (ReadMeshDesc(objData, type, desc)) {
+                meshes.push_back(desc);
+            } else if (type == "MDLModel" && objData.contains("filename")) {
+                models.push_back(objData["filename"]);
             }
-            
-            if (objData.contains("rotation") && objData["rotation"].size() >= 3) {
-                const auto& rotation = objData["rotation"];
-                rotX = rotation[0]; rotY = rotation[1]; rotZ = rotation[2];
+        });
+    
+    try {
+        if (!reader.Read(file)) {
+            std::cerr << "Error reading scene: " << reader.GetError() << std::endl;
+            return false;
+        }
+        return true;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "Error reading scene: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool SceneLoader::LoadCompiledScene(const std::string& filepath, Scene& scene, Camera& camera) {
+    REVOLT_PROFILE_SCOPE("SceneLoader::LoadCompiledScene");
+    MappedFile file;
+    Cooked::SceneHeader header;
+    bool valid = file.Open(filepath) && file.Contains(0, sizeof(header));
+    if (valid) {
+        std::memcpy(&header, file.GetData(), sizeof(header));
+        valid = header.resourceCount >= 0 && header.objectCount >= 0 &&
+                header.resourceOffset % Cooked::SECTION_ALIGNMENT == 0 && header.objectOffset % Cooked::SECTION_ALIGNMENT == 0 &&
+                file.Contains(header.resourceOffset, static_cast<uint64_t>(header.resourceCount) * sizeof(Cooked::SceneResource)) &&
+                file.Contains(header.objectOffset, static_cast<uint64_t>(header.objectCount) * sizeof(Cooked::SceneObject)) &&
+                file.Contains(header.stringOffset, header.stringSize);
+    }
+    
+    const Cooked::SceneResource* resources =
+        valid ? reinterpret_cast<const Cooked::SceneResource*>(file.GetData() + header.resourceOffset) : nullptr;
+    const Cooked::SceneObject* objects =
+        valid ? reinterpret_cast<const Cooked::SceneObject*>(file.GetData() + header.objectOffset) : nullptr;
+    const char* strings = valid ? reinterpret_cast<const char*>(file.GetData() + header.stringOffset) : nullptr;
+    for (int32_t i = 0; valid && i < header.resourceCount; ++i) {
+        const Cooked::SceneResource& resource = resources[i];
+        valid = resource.type >= 0 && resource.type < static_cast<int32_t>(Cooked::SceneResourceType::Count);
+        if (valid && resource.type == static_cast<int32_t>(Cooked::SceneResourceType::MDLModel)) {
+            valid = resource.nameOffset < header.stringSize &&
+                    std::memchr(strings + resource.nameOffset, 0, header.stringSize - resource.nameOffset) != nullptr;
+        }
+    }
+    for (int32_t i = 0; valid && i < header.objectCount; ++i) {
+        valid = objects[i].resource >= -1 && objects[i].resource < header.resourceCount;
+    }
+    if (!valid) {
+        std::cerr << "Invalid compiled scene file: " << filepath << std::endl;
+        return false;
+    }
+    
+    camera.SetPerspective(header.cameraFov, header.cameraAspect, header.cameraNear, header.cameraFar);
+    camera.LookAt(header.cameraPosition[0], header.cameraPosition[1], header.cameraPosition[2],
+                  header.cameraLookAt[0], header.cameraLookAt[1], header.cameraLookAt[2]);
+    
+    // Каждый ресурс запрашивается один раз, а не на каждый объект
+    auto& resourceManager = ResourceManager::GetInstance();
+    std::vector<std::shared_ptr<Mesh>> meshes(header.resourceCount);
+    std::vector<AssetHandle<MDLModel>> models(header.resourceCount);
+    for (int32_t i = 0; i < header.resourceCount; ++i) {
+        const Cooked::SceneResource& resource = resources[i];
+        if (resource.type == static_cast<int32_t>(Cooked::SceneResourceType::MDLModel)) {
+            models[i] = resourceManager.LoadMDLModelAsync(strings + resource.nameOffset);
+        } else {
+            meshes[i] = resourceManager.LoadMesh(MESH_TYPE_NAMES[resource.type], resource.param1, resource.param2,
+                                                 resource.param3, resource.param4);
+        }
+    }
+    
+    scene.Reserve(header.objectCount);
+    for (int32_t i = 0; i < header.objectCount; ++i) {
+        const Cooked::SceneObject& object = objects[i];
+        GameObject* obj = scene.CreateGameObject();
+        if (object.resource >= 0) {
+            if (meshes[object.resource]) {
+                obj->SetMesh(meshes[object.resource]);
+            } else {
+                obj->SetMDLModel(models[object.resource]);
             }
-            
-            if (objData.contains("scale") && objData["scale"].size() >= 3) {
-                const auto& scale = objData["scale"];
-                scaleX = scale[0]; scaleY = scale[1]; scaleZ = scale[2];
+            obj->SetMaterial(Material(object.color[0], object.color[1], object.color[2], object.color[3]));
+        }
+        obj->SetPosition(object.position[0], object.position[1], object.position[2]);
+        obj->SetRotation(object.rotation[0], object.rotation[1], object.rotation[2]);
+        obj->SetScale(object.scale[0], object.scale[1], object.scale[2]);
+        obj->UpdateTransform();
+    }
+    
+    std::cout << "Compiled scene loaded: " << header.objectCount << " objects, "
+              << header.resourceCount << " resources" << std::endl;
+    return true;
+}
+
+bool SceneLoader::CompileScene(const std::string& filepath, const Cooked::SourceStamp& source, std::vector<uint8_t>& out) {
+    std::ifstream file(filepath);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open scene file: " << filepath << std::endl;
+        return false;
+    }
+    
+    Cooked::SceneHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.file.magic = Cooked::SCENE_MAGIC;
+    header.file.version = Cooked::SCENE_VERSION;
+    header.file.source = source;
+    
+    std::vector<Cooked::SceneResource> resources;
+    std::vector<Cooked::SceneObject> objects;
+    std::string strings;
+    std::unordered_map<std::string, int32_t> resourceIndices;
+    
+    SceneReader reader(
+        [&header](const json& camData) {
+            // Те же умолчания, что и при загрузке JSON
+            CameraDesc desc;
+            ReadCamera(camData, desc);
+            header.cameraFov = desc.fov;
+            header.cameraAspect = desc.aspect;
+            header.cameraNear = desc.nearPlane;
+            header.cameraFar = desc.farPlane;
+            std::copy(desc.position, desc.position + 3, header.cameraPosition);
+            std::copy(desc.lookAt, desc.lookAt + 3, header.cameraLookAt);
+        },
+        [&](const json& objData) {
+            // Загрузчик JSON оставил бы на их месте пустые объекты без трансформации
+            if (!objData.contains("type")) {
+                std::cerr << "Object missing type, skipped" << std::endl;
+                return;
             }
             
             std::string type = objData["type"];
+            Cooked::SceneResource resource;
+            std::memset(&resource, 0, sizeof(resource));
+            std::string resourceKey;
+            std::string filename;
             
-            if (type == "Pyramid") {
-                const auto& params = objData.contains("parameters") ? objData["parameters"] : json::object();
-                float base = params.contains("base") ? params["base"] : 1.0f;
-                float height = params.contains("height") ? params["height"] : 1.5f;
-                mesh = resourceManager.LoadMesh("Pyramid", base, height);
-            } else if (type == "Cube") {
-                const auto& params = objData.contains("parameters") ? objData["parameters"] : json::object();
-                float size = params.contains("size") ? params["size"] : 0.8f;
-                mesh = resourceManager.LoadMesh("Cube", size);
-            } else if (type == "Torus") {
-                const auto& params = objData.contains("parameters") ? objData["parameters"] : json::object();
-                float majorRadius = params.contains("majorRadius") ? params["majorRadius"] : 1.0f;
-                float minorRadius = params.contains("minorRadius") ? params["minorRadius"] : 0.3f;
-                int majorSegments = params.contains("majorSegments") ? params["majorSegments"] : 16;
-                int minorSegments = params.contains("minorSegments") ? params["minorSegments"] : 8;
-                mesh = resourceManager.LoadMesh("Torus", majorRadius, minorRadius, majorSegments, minorSegments);
+            ResourceManager::MeshDesc meshDesc;
+            if (ReadMeshDesc(objData, type, meshDesc)) {
+                resource.type = static_cast<int32_t>(std::find(std::begin(MESH_TYPE_NAMES), std::end(MESH_TYPE_NAMES), type) -
+                                                     std::begin(MESH_TYPE_NAMES));
+                resource.param1 = meshDesc.param1;
+                resource.param2 = meshDesc.param2;
+                resource.param3 = meshDesc.param3;
+                resource.param4 = meshDesc.param4;
+                resourceKey = ResourceManager::MakeMeshKey(meshDesc);
             } else if (type == "MDLModel") {
-                // Загрузка MDL модели
                 if (objData.contains("filename")) {
-                    std::string filename = objData["filename"];
-                    auto mdlModel = resourceManager.LoadMDLModel(filename);
-                    if (mdlModel) {
-                        obj->SetMDLModel(mdlModel);
-                        std::cout << "Loaded MDL model: " << filename << std::endl;
-                    } else {
-                        std::cerr << "Failed to load MDL model: " << filename << std::endl;
-                    }
+                    resource.type = static_cast<int32_t>(Cooked::SceneResourceType::MDLModel);
+                    filename = objData["filename"];
+                    resourceKey = "MDL:" + filename;
                 }
             } else {
-                std::cerr << "Unknown object type: " << type << std::endl;
-                continue;
+                std::cerr << "Unknown object type, skipped: " << type << std::endl;
+                return;
             }
             
-            if (mesh || obj->GetMDLModel()) {
-                if (mesh) {
-                    obj->SetMesh(mesh);
-                }
-                
-                // Загрузка материала с проверками
-                Material material(1.0f, 1.0f, 1.0f); // Белый по умолчанию
-                if (objData.contains("material") && objData["material"].contains("color")) {
-                    const auto& color = objData["material"]["color"];
-                    if (color.size() >= 3) {
-                        float r = color[0];
-                        float g = color[1];
-                        float b = color[2];
-                        float a = (color.size() >= 4) ? color[3] : 1.0f;
-                        material = Material(r, g, b, a);
-                    }
-                }
-                obj->SetMaterial(material);
+            Cooked::SceneObject object;
+            std::memset(&object, 0, sizeof(object));
+            object.scale[0] = object.scale[1] = object.scale[2] = 1.0f;
+            object.color[0] = object.color[1] = object.color[2] = object.color[3] = 1.0f;
+            object.resource = -1;
             
-                // ДЕБАГ: выводим ВСЕ параметры
-                std::cout << "Loaded " << type << " - ";
-                if (type == "Pyramid") {
-                    const auto& params = objData["parameters"];
-                    std::cout << "base: " << params["base"] << ", height: " << params["height"];
-                } else if (type == "Cube") {
-                    const auto& params = objData["parameters"];
-                    std::cout << "size: " << params["size"];
-                } else if (type == "Torus") {
-                    const auto& params = objData["parameters"];
-                    std::cout << "majorRadius: " << params["majorRadius"] << ", minorRadius: " << params["minorRadius"];
-                } else if (type == "MDLModel") {
-                    std::cout << "filename: " << objData["filename"];
+            if (!resourceKey.empty()) {
+                auto it = resourceIndices.find(resourceKey);
+                if (it == resourceIndices.end()) {
+                    if (resource.type == static_cast<int32_t>(Cooked::SceneResourceType::MDLModel)) {
+                        resource.nameOffset = static_cast<uint32_t>(strings.size());
+                        strings.append(filename).push_back('\0');
+                    }
+                    it = resourceIndices.emplace(resourceKey, static_cast<int32_t>(resources.size())).first;
+                    resources.push_back(resource);
                 }
-                std::cout << ", color: (" << material.GetR() << ", " << material.GetG() << ", " << material.GetB() << ", " << material.GetA()
-                          << ")" << std::endl;
+                object.resource = it->second;
             }
             
-            // Устанавливаем трансформацию
-            obj->SetPosition(posX, posY, posZ);
-            
-            // Применяем специальные повороты для разных типов объектов
+            ReadFloats(objData, "position", object.position, 3);
+            ReadFloats(objData, "rotation", object.rotation, 3);
+            ReadFloats(objData, "scale", object.scale, 3);
+            if (objData.contains("material") && objData["material"].contains("color")) {
+                ReadFloats(objData["material"], "color", object.color, objData["material"]["color"].size() >= 4 ? 4 : 3);
+            }
             if (type == "Torus") {
-                obj->SetRotation(rotX + 90.0f, rotY, rotZ);
-            } else if (type == "MDLModel") {
-                obj->SetRotation(rotX, rotY, rotZ);
-            } else {
-                obj->SetRotation(rotX, rotY, rotZ);
+                object.rotation[0] += 90.0f;
             }
-            
-            obj->SetScale(scaleX, scaleY, scaleZ);
-            obj->UpdateTransform();
+            objects.push_back(object);
+        });
+    
+    try {
+        if (!reader.Read(file)) {
+            std::cerr << "Error compiling scene: " << reader.GetError() << std::endl;
+            return false;
+        }
+        // Без них загрузчик подставляет демо-сцену - компилировать нечего
+        if (!reader.HasCamera() || !reader.HasObjects()) {
+            std::cerr << "Scene has no camera or objects: " << filepath << std::endl;
+            return false;
         }
-        
-        std::cout << "Scene loaded successfully: " << sceneData["objects"].size() << " objects" << std::endl;
-        return true;
-        
     } catch (const std::exception& e) {
-        std::cerr << "Error loading scene: " << e.what() << std::endl;
-        CreateDemoScene(scene, camera);
+        std::cerr << "Error compiling scene: " << e.what() << std::endl;
         return false;
     }
+    
+    header.resourceCount = static_cast<int32_t>(resources.size());
+    header.objectCount = static_cast<int32_t>(objects.size());
+    
+    out.clear();
+    Cooked::AppendSection(out, &header, sizeof(header));
+    header.resourceOffset = Cooked::AppendSection(out, resources.data(), resources.size() * sizeof(Cooked::SceneResource));
+    header.objectOffset = Cooked::AppendSection(out, objects.data(), objects.size() * sizeof(Cooked::SceneObject));
+    header.stringOffset = Cooked::AppendSection(out, strings.data(), strings.size());
+    header.stringSize = strings.size();
+    std::memcpy(out.data(), &header, sizeof(header));
+    return true;
 }
 
 void SceneLoader::CreateDemoScene(Scene& scene, Camera& camera) {
@@ -1,8 +1,10 @@
 #pragma once
 #include <string>
 #include <iostream>
+#include <vector>
 #include "Scene.h"
 #include "Camera.h"
+#include "ResourceManager.h"
 
 namespace Revolt {
 
@@ -10,6 +12,15 @@ class SceneLoader {
 public:
     static bool LoadSceneFromFile(const std::string& filepath, Scene& scene, Camera& camera);
     static void CreateDemoScene(Scene& scene, Camera& camera);
+    // Процедурные меши и файлы MDL, на которые ссылается сцена, - для RevoltCook
+    static bool CollectAssets(const std::string& filepath, std::vector<ResourceManager::MeshDesc>& meshes,
+                              std::vector<std::string>& models);
+    // Двоичная сцена (.rscn) из JSON - для RevoltCook. LoadSceneFromFile берёт
+    // её вместо JSON, если она свежая
+    static bool CompileScene(const std::string& filepath, const Cooked::SourceStamp& source, std::vector<uint8_t>& out);
+
+private:
+    static bool LoadCompiledScene(const std::string& filepath, Scene& scene, Camera& camera);
 };
 
 } // namespace Revolt
\ No newline at end of file
@@ -1,10 +1,13 @@
 #include "Window.h"
+#include "graphics/GLExtensions.h"
+#include "graphics/GLState.h"
+#include "core/Profiler.h"
 #include <iostream>
 
 namespace Revolt {
 
 Window::Window(int width, int height, const std::string& title)
-    : m_renderWidth(width), m_renderHeight(height), m_title(title), m_window(nullptr) {
+    : m_renderWidth(width), m_renderHeight(height), m_title(title), m_window(nullptr), m_headless(false) {
     // Разрешение рендеринга устанавливается через конструктор (320x240, 512x384 и т.д.)
     m_screenWidth = 0;
     m_screenHeight = 0;
@@ -22,14 +25,6 @@ bool Window::Initialize() {
         return false;
     }
 
-    // Получаем монитор и его видеорежим
-    GLFWmonitor* primaryMonitor = glfwGetPrimaryMonitor();
-    const GLFWvidmode* videoMode = glfwGetVideoMode(primaryMonitor);
-
-    // Сохраняем нативное разрешение экрана
-    m_screenWidth = videoMode->width;
-    m_screenHeight = videoMode->height;
-
     // Устанавливаем версию OpenGL (совместимый профиль)
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 2);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
@@ -38,22 +33,27 @@ bool Window::Initialize() {
     // Отключаем масштабирование и сглаживание
     glfwWindowHint(GLFW_SCALE_TO_MONITOR, GLFW_FALSE);
     
-    // Создаем полноэкранное окно в нативном разрешении
-    m_window = glfwCreateWindow(m_screenWidth, m_screenHeight, m_title.c_str(), primaryMonitor, nullptr);
-    
-    if (!m_window) {
-        std::cerr << "Failed to create fullscreen window" << std::endl;
+    bool created = m_headless ? CreateHeadlessWindow() : CreateFullscreenWindow();
+    if (!created) {
         glfwTerminate();
         return false;
     }
 
     glfwMakeContextCurrent(m_window);
     
+    // В безголовом режиме кадры не показываются - vsync только мешает замерам
+    if (m_headless) {
+        glfwSwapInterval(0);
+    }
+    
+    // Загружаем расширения сразу: ресурсы сцены создаются до инициализации рендерера
+    GLExtensions::Initialize();
+    
     // Устанавливаем обработчик клавиш
     glfwSetKeyCallback(m_window, KeyCallback);
     
     // Настройки OpenGL для точного рендеринга
-    glEnable(GL_DEPTH_TEST);
+    GLState::Enable(GL_DEPTH_TEST);
     
     // Устанавливаем начальный вьюпорт
     glViewport(0, 0, m_screenWidth, m_screenHeight);
@@ -65,6 +65,51 @@ bool Window::Initialize() {
     return true;
 }
 
+bool Window::CreateFullscreenWindow() {
+    // Получаем монитор и его видеорежим
+    GLFWmonitor* primaryMonitor = glfwGetPrimaryMonitor();
+    const GLFWvidmode* videoMode = primaryMonitor ? glfwGetVideoMode(primaryMonitor) : nullptr;
+    if (!videoMode) {
+        std::cerr << "No monitor available (use --headless)" << std::endl;
+        return false;
+    }
+
+    // Сохраняем нативное разрешение экрана
+    m_screenWidth = videoMode->width;
+    m_screenHeight = videoMode->height;
+    
+    // Создаем полноэкранное окно в нативном разрешении
+    m_window = glfwCreateWindow(m_screenWidth, m_screenHeight, m_title.c_str(), primaryMonitor, nullptr);
+    
+    if (!m_window) {
+        std::cerr << "Failed to create fullscreen window" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Window::CreateHeadlessWindow() {
+    // "Экран" совпадает с разрешением рендеринга: окно никто не видит
+    m_screenWidth = m_renderWidth;
+    m_screenHeight = m_renderHeight;
+    
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    m_window = glfwCreateWindow(m_screenWidth, m_screenHeight, m_title.c_str(), nullptr, nullptr);
+    
+    if (!m_window) {
+        // Например, X-сервер без GLX (Xvfb) - пробуем программный OSMesa
+        std::cerr << "Failed to create hidden window, trying OSMesa context" << std::endl;
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+        m_window = glfwCreateWindow(m_screenWidth, m_screenHeight, m_title.c_str(), nullptr, nullptr);
+    }
+    
+    if (!m_window) {
+        std::cerr << "Failed to create headless window" << std::endl;
+        return false;
+    }
+    return true;
+}
+
 void Window::SetupViewportForScene() {
     // Больше не нужно - теперь рендеринг управляется через FBO
     
@@ -86,10 +131,12 @@ void Window::ClearBlackBars() {
 }
 
 void Window::SwapBuffers() {
+    REVOLT_PROFILE_SCOPE("Window::SwapBuffers");
     glfwSwapBuffers(m_window);
 }
 
 void Window::PollEvents() {
+    REVOLT_PROFILE_SCOPE("Window::PollEvents");
     glfwPollEvents();
 }
 
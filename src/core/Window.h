@@ -10,6 +10,12 @@ public:
     Window(int width, int height, const std::string& title);
     ~Window();
 
+    // Безголовый режим (до Initialize): невидимое окно в разрешении рендеринга
+    // вместо полноэкранного, без vsync. Если обычный контекст создать нельзя,
+    // пробуется программный OSMesa.
+    void SetHeadless(bool headless) { m_headless = headless; }
+    bool IsHeadless() const { return m_headless; }
+
     bool Initialize();
     void SwapBuffers();
     void PollEvents();
@@ -38,6 +44,8 @@ public:
 
 private:
     static void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
+    bool CreateFullscreenWindow();
+    bool CreateHeadlessWindow();
     
     int m_renderWidth;   // Разрешение рендеринга (320x240, 512x384 и т.д.)
     int m_renderHeight;  // Разрешение рендеринга
@@ -45,6 +53,7 @@ private:
     int m_screenHeight;  // Разрешение экрана
     std::string m_title;
     GLFWwindow* m_window;
+    bool m_headless;
 };
 
 } // namespace Revolt
\ No newline at end of file
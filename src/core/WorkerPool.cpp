@@ -0,0 +1,76 @@
+#include "WorkerPool.h"
+#include "Profiler.h"
+#include <algorithm>
+
+namespace Revolt {
+
+namespace {
+    // Загрузка упирается в диск, больше потоков не ускоряет её
+    const unsigned int MAX_THREADS = 4;
+}
+
+WorkerPool::~WorkerPool() {
+    Stop();
+}
+
+void WorkerPool::Start(unsigned int threadCount) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_threads.empty()) {
+        return;
+    }
+
+    if (threadCount == 0) {
+        unsigned int cores = std::thread::hardware_concurrency();
+        threadCount = std::min(std::max(cores, 2u) - 1, MAX_THREADS);
+    }
+
+    m_stopping = false;
+    for (unsigned int i = 0; i < threadCount; ++i) {
+        m_threads.emplace_back(&WorkerPool::WorkerLoop, this);
+    }
+}
+
+void WorkerPool::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_threads.empty()) {
+            return;
+        }
+        m_stopping = true;
+        m_jobs.clear();
+    }
+    m_condition.notify_all();
+
+    for (std::thread& thread : m_threads) {
+        thread.join();
+    }
+    m_threads.clear();
+}
+
+void WorkerPool::Submit(std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back(std::move(job));
+    }
+    m_condition.notify_one();
+}
+
+void WorkerPool::WorkerLoop() {
+    REVOLT_PROFILE_THREAD("Worker");
+
+    for (;;) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+            if (m_stopping) {
+                return;
+            }
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+        job();
+    }
+}
+
+} // namespace Revolt
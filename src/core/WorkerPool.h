@@ -0,0 +1,41 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Revolt {
+
+// Фиксированный набор рабочих потоков с общей очередью задач (FIFO).
+// Потоки создаются при первом Start; задачи не должны обращаться к OpenGL -
+// контекст есть только у главного потока.
+class WorkerPool {
+public:
+    WorkerPool() = default;
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // threadCount == 0 - по числу ядер, оставляя одно главному потоку.
+    // Повторный вызов ничего не делает
+    void Start(unsigned int threadCount = 0);
+    // Дожидается выполняемых задач; ещё не начатые отбрасываются
+    void Stop();
+    bool IsRunning() const { return !m_threads.empty(); }
+
+    void Submit(std::function<void()> job);
+
+private:
+    void WorkerLoop();
+
+    std::vector<std::thread> m_threads;
+    std::deque<std::function<void()>> m_jobs;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stopping = false;
+};
+
+} // namespace Revolt
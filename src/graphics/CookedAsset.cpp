@@ -0,0 +1,127 @@
+#include "CookedAsset.h"
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <thread>
+#include <sys/stat.h>
+
+#if defined(_WIN32)
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>
+#  include <process.h>
+#else
+#  include <unistd.h>
+#endif
+
+namespace Revolt {
+namespace Cooked {
+
+static_assert(sizeof(FileHeader) == 32, "Cooked file header layout changed");
+static_assert(sizeof(ModelHeader) == 184, "Cooked model header layout changed");
+static_assert(sizeof(MeshPackHeader) == 48, "Cooked mesh pack header layout changed");
+static_assert(sizeof(MeshEntry) == 144, "Cooked mesh entry layout changed");
+static_assert(sizeof(SceneHeader) == 112, "Compiled scene header layout changed");
+static_assert(sizeof(SceneResource) == 24 && sizeof(SceneObject) == 56, "Compiled scene record layout changed");
+
+uint64_t HashBytes(const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+bool GetSourceStamp(const std::string& path, SourceStamp& stamp) {
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) {
+        return false;
+    }
+    stamp.contentHash = 0;
+    stamp.size = static_cast<uint64_t>(info.st_size);
+    stamp.modifiedTime = static_cast<int64_t>(info.st_mtime);
+    return true;
+}
+
+std::string GetCookedPath(const std::string& sourcePath, const char* extension) {
+    size_t slash = sourcePath.find_last_of("/\\");
+    size_t dot = sourcePath.rfind('.');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return sourcePath + extension;
+    }
+    return sourcePath.substr(0, dot) + extension;
+}
+
+bool ReadFileHeader(const std::string& cookedPath, FileHeader& header) {
+    FILE* fp = fopen(cookedPath.c_str(), "rb");
+    if (!fp) {
+        return false;
+    }
+    bool success = fread(&header, sizeof(FileHeader), 1, fp) == 1;
+    fclose(fp);
+    return success;
+}
+
+bool IsFresh(const std::string& cookedPath, const std::string& sourcePath, uint32_t magic, uint32_t version) {
+    FileHeader header;
+    if (!ReadFileHeader(cookedPath, header) || header.magic != magic || header.version != version) {
+        return false;
+    }
+
+    SourceStamp source;
+    if (!GetSourceStamp(sourcePath, source)) {
+        return true;
+    }
+    return source.size == header.source.size && source.modifiedTime == header.source.modifiedTime;
+}
+
+uint64_t AppendSection(std::vector<uint8_t>& out, const void* data, size_t size) {
+    size_t offset = (out.size() + SECTION_ALIGNMENT - 1) & ~(SECTION_ALIGNMENT - 1);
+    out.resize(offset + size, 0);
+    if (size > 0) {
+        std::memcpy(out.data() + offset, data, size);
+    }
+    return offset;
+}
+
+bool WriteFileAtomic(const std::string& path, const std::vector<uint8_t>& data) {
+    // Своё имя у каждого писателя: RevoltCook и RevoltBench могут писать один файл одновременно
+#if defined(_WIN32)
+    unsigned long processId = static_cast<unsigned long>(_getpid());
+#else
+    unsigned long processId = static_cast<unsigned long>(getpid());
+#endif
+    char suffix[64];
+    std::snprintf(suffix, sizeof(suffix), ".%lu.%zx.tmp", processId,
+                  std::hash<std::thread::id>()(std::this_thread::get_id()));
+    std::string tempPath = path + suffix;
+    FILE* fp = fopen(tempPath.c_str(), "wb");
+    if (!fp) {
+        return false;
+    }
+    bool success = fwrite(data.data(), 1, data.size(), fp) == data.size();
+    success = fclose(fp) == 0 && success;
+
+    // Замена атомарна: читатель видит либо старый файл, либо новый.
+    // rename в Windows существующий файл не заменяет
+    if (success) {
+#if defined(_WIN32)
+        success = MoveFileExA(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+        success = std::rename(tempPath.c_str(), path.c_str()) == 0;
+#endif
+    }
+    if (!success) {
+        std::remove(tempPath.c_str());
+    }
+    return success;
+}
+
+} // namespace Cooked
+} // namespace Revolt
@@ -0,0 +1,147 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "MDLFile.h"
+
+// Подготовленные (cooked) ресурсы: .rmdl рядом с каждой .mdl, а рядом с файлом
+// сцены - .rmesh с процедурными мешами, на которые она ссылается, и .rscn -
+// сама сцена в двоичном виде. Их пишет
+// RevoltCook, а ResourceManager берёт их вместо исходников, если они свежие.
+// Данные лежат так, как их использует рантайм: вершины уже разделены по шву,
+// индексы готовы, кадры упакованы (MDLVertex), скины - в обоих форматах
+// загрузки. Разделы выровнены на SECTION_ALIGNMENT; порядок байт -
+// little-endian, как и в .mdl.
+
+namespace Revolt {
+namespace Cooked {
+
+const uint32_t MODEL_MAGIC = 0x4C444D52;     // "RMDL"
+const uint32_t MESH_PACK_MAGIC = 0x48534D52; // "RMSH"
+const uint32_t SCENE_MAGIC = 0x4E435352;     // "RSCN"
+// Увеличивать при любом изменении раскладки или того, как готовятся данные
+const uint32_t MODEL_VERSION = 1;
+const uint32_t MESH_PACK_VERSION = 1;
+const uint32_t SCENE_VERSION = 1;
+const size_t SECTION_ALIGNMENT = 16;
+
+const char* const MODEL_EXTENSION = ".rmdl";
+const char* const MESH_PACK_EXTENSION = ".rmesh";
+const char* const SCENE_EXTENSION = ".rscn";
+
+// Исходник, из которого подготовлен файл. Рантайм сверяет размер и время
+// изменения, RevoltCook пропускает файлы с тем же хэшем содержимого
+struct SourceStamp {
+    uint64_t contentHash;
+    uint64_t size;
+    int64_t modifiedTime;
+};
+
+struct FileHeader {
+    uint32_t magic;
+    uint32_t version;
+    SourceStamp source;
+};
+
+struct ModelHeader {
+    FileHeader file;
+    MDLHeader mdl;
+    int32_t renderVertexCount;
+    int32_t indexCount;
+    int32_t frameCount;
+    int32_t skinCount;
+    int32_t reserved;
+    uint64_t texCoordOffset; // float s, t на вершину - до переноса в атлас
+    uint64_t indexOffset;    // uint32 на индекс
+    uint64_t frameOffset;    // MDLVertex[frameCount * renderVertexCount]
+    uint64_t boundsOffset;   // float min[3], max[3] на кадр
+    uint64_t skinOffset;     // Индексы палитры, skinWidth * skinHeight на скин
+    uint64_t skinRGBAOffset; // То же в RGBA, по 4 байта на пиксель
+};
+
+struct MeshPackHeader {
+    FileHeader file;
+    int32_t meshCount;
+    int32_t reserved;
+    uint64_t entryOffset;    // MeshEntry[meshCount]
+};
+
+struct MeshEntry {
+    char key[96];            // Ключ кэша ResourceManager, с нулём в конце
+    int32_t vertexCount;
+    int32_t indexCount;
+    float boundsMin[3];
+    float boundsMax[3];
+    uint64_t vertexOffset;   // Vertex[vertexCount]
+    uint64_t indexOffset;    // uint32[indexCount]
+};
+
+// Ресурс сцены; объекты ссылаются на него индексом в таблице
+enum class SceneResourceType : int32_t {
+    Pyramid,
+    Cube,
+    Torus,
+    MDLModel,
+    Count
+};
+
+struct SceneHeader {
+    FileHeader file;
+    float cameraPosition[3];
+    float cameraLookAt[3];
+    float cameraFov;
+    float cameraAspect;
+    float cameraNear;
+    float cameraFar;
+    int32_t resourceCount;
+    int32_t objectCount;
+    uint64_t resourceOffset; // SceneResource[resourceCount]
+    uint64_t objectOffset;   // SceneObject[objectCount]
+    uint64_t stringOffset;   // Имена файлов, каждое с нулём в конце
+    uint64_t stringSize;
+};
+
+struct SceneResource {
+    int32_t type;            // SceneResourceType
+    int32_t param3;
+    int32_t param4;
+    float param1;
+    float param2;
+    uint32_t nameOffset;     // Для MDL: имя файла в таблице строк
+};
+
+// Объект в том виде, в каком его создаёт загрузчик: поворот уже с поправкой
+// для типа ресурса, цвет со значениями по умолчанию
+struct SceneObject {
+    float position[3];
+    float rotation[3];
+    float scale[3];
+    float color[4];
+    int32_t resource;        // -1 - объект без ресурса
+};
+
+// FNV-1a, 64 бита
+uint64_t HashBytes(const void* data, size_t size);
+
+// Размер и время изменения; хэш не считается (0). false - файла нет
+bool GetSourceStamp(const std::string& path, SourceStamp& stamp);
+
+// Тот же путь с заменённым расширением
+std::string GetCookedPath(const std::string& sourcePath, const char* extension);
+
+// Читает только заголовок
+bool ReadFileHeader(const std::string& cookedPath, FileHeader& header);
+
+// Файл нужного типа и версии, а исходник с момента подготовки не менялся
+// (или его нет вовсе - поставляется только подготовленный файл)
+bool IsFresh(const std::string& cookedPath, const std::string& sourcePath, uint32_t magic, uint32_t version);
+
+// Дописывает раздел с выравниванием и возвращает его смещение
+uint64_t AppendSection(std::vector<uint8_t>& out, const void* data, size_t size);
+
+// Пишет во временный файл и переименовывает - читатель не увидит файл наполовину
+bool WriteFileAtomic(const std::string& path, const std::vector<uint8_t>& data);
+
+} // namespace Cooked
+} // namespace Revolt
@@ -1,23 +1,48 @@
 #include "Framebuffer.h"
+#include "GLExtensions.h"
+#include "GLState.h"
+#include "../core/Profiler.h"
 #include <iostream>
 #include <vector>
 
 namespace Revolt {
 
 Framebuffer::Framebuffer(int width, int height) 
-    : m_width(width), m_height(height), m_textureID(0) {
+    : m_width(width), m_height(height), m_textureID(0), m_fboID(0), m_depthBufferID(0) {
 }
 
 Framebuffer::~Framebuffer() {
+    Release();
+}
+
+void Framebuffer::Release() {
+    if (m_fboID) {
+        GLExtensions::DeleteFramebuffers(1, &m_fboID);
+        m_fboID = 0;
+    }
+    if (m_depthBufferID) {
+        GLExtensions::DeleteRenderbuffers(1, &m_depthBufferID);
+        m_depthBufferID = 0;
+    }
     if (m_textureID) {
-        glDeleteTextures(1, &m_textureID);
+        GLState::DeleteTextures(1, &m_textureID);
+        m_textureID = 0;
     }
 }
 
+bool Framebuffer::Resize(int width, int height) {
+    m_width = width;
+    m_height = height;
+    return Initialize();
+}
+
 bool Framebuffer::Initialize() {
+    // Повторная инициализация (смена разрешения) - освобождаем старые объекты
+    Release();
+    
     // Создаем текстуру для низкого разрешения
     glGenTextures(1, &m_textureID);
-    glBindTexture(GL_TEXTURE_2D, m_textureID);
+    GLState::BindTexture(m_textureID);
     
     // Выделяем память для текстуры (инициализируем нейтральным серым цветом)
     std::vector<unsigned char> textureData(m_width * m_height * 3, 0);
@@ -35,29 +60,70 @@ bool Framebuffer::Initialize() {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
     
+    // Рендерим сразу в текстуру, если драйвер поддерживает FBO
+    if (GLExtensions::HasFramebufferObject() && !CreateFBO()) {
+        std::cerr << "Framebuffer object incomplete, falling back to back buffer copy" << std::endl;
+    }
+    
+    return true;
+}
+
+bool Framebuffer::CreateFBO() {
+    // Буфер глубины для низкого разрешения
+    GLExtensions::GenRenderbuffers(1, &m_depthBufferID);
+    GLExtensions::BindRenderbuffer(GL_RENDERBUFFER, m_depthBufferID);
+    GLExtensions::RenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, m_width, m_height);
+    GLExtensions::BindRenderbuffer(GL_RENDERBUFFER, 0);
+    
+    GLExtensions::GenFramebuffers(1, &m_fboID);
+    GLExtensions::BindFramebuffer(GL_FRAMEBUFFER, m_fboID);
+    GLExtensions::FramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_textureID, 0);
+    GLExtensions::FramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_depthBufferID);
+    
+    GLenum status = GLExtensions::CheckFramebufferStatus(GL_FRAMEBUFFER);
+    GLExtensions::BindFramebuffer(GL_FRAMEBUFFER, 0);
+    
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        GLExtensions::DeleteFramebuffers(1, &m_fboID);
+        GLExtensions::DeleteRenderbuffers(1, &m_depthBufferID);
+        m_fboID = 0;
+        m_depthBufferID = 0;
+        return false;
+    }
+    
     return true;
 }
 
 void Framebuffer::BeginRender() {
+    if (m_fboID) {
+        GLExtensions::BindFramebuffer(GL_FRAMEBUFFER, m_fboID);
+    }
+    
     // Устанавливаем вьюпорт для рендеринга в низком разрешении
     glViewport(0, 0, m_width, m_height);
     
     // Очищаем буферы НЕЙТРАЛЬНЫМ СЕРЫМ цветом
     glClearColor(0.2f, 0.2f, 0.2f, 1.0f);  // ИСПРАВЛЕНО: убрали синий оттенок
+    GLState::DepthMask(true); // Маска глубины действует и на glClear
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
 
 void Framebuffer::EndRender() {
-    // Читаем пиксели из framebuffer'а
-    std::vector<unsigned char> pixelData(m_width * m_height * 3);
-    glReadPixels(0, 0, m_width, m_height, GL_RGB, GL_UNSIGNED_BYTE, pixelData.data());
+    REVOLT_PROFILE_SCOPE("Framebuffer::EndRender");
+    if (m_fboID) {
+        // Кадр уже лежит в текстуре - просто возвращаемся к экранному буферу
+        GLExtensions::BindFramebuffer(GL_FRAMEBUFFER, 0);
+        return;
+    }
     
-    // Копируем в текстуру
-    glBindTexture(GL_TEXTURE_2D, m_textureID);
-    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_width, m_height, GL_RGB, GL_UNSIGNED_BYTE, pixelData.data());
+    // Запасной путь: копируем из заднего буфера в текстуру на стороне GPU,
+    // без промежуточного буфера в памяти CPU
+    GLState::BindTexture(m_textureID);
+    glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, m_width, m_height);
 }
 
 void Framebuffer::RenderToScreen(int screenWidth, int screenHeight) {
+    REVOLT_PROFILE_SCOPE("Framebuffer::RenderToScreen");
     // Возвращаемся к полноэкранному вьюпорту
     glViewport(0, 0, screenWidth, screenHeight);
     
@@ -66,20 +132,20 @@ void Framebuffer::RenderToScreen(int screenWidth, int screenHeight) {
     glClear(GL_COLOR_BUFFER_BIT);
     
     // Устанавливаем ортографическую проекцию для 2D рендеринга
-    glMatrixMode(GL_PROJECTION);
+    GLState::MatrixMode(GL_PROJECTION);
     glLoadIdentity();
     glOrtho(0, screenWidth, screenHeight, 0, -1, 1);  // Обратите внимание: Y инвертирован!
     
-    glMatrixMode(GL_MODELVIEW);
+    GLState::MatrixMode(GL_MODELVIEW);
     glLoadIdentity();
     
     // Отключаем ненужные для 2D функции
-    glDisable(GL_DEPTH_TEST);
-    glDisable(GL_LIGHTING);
+    GLState::Disable(GL_DEPTH_TEST);
+    GLState::Disable(GL_LIGHTING);
     
     // Включаем текстуру
-    glEnable(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, m_textureID);
+    GLState::Enable(GL_TEXTURE_2D);
+    GLState::BindTexture(m_textureID);
     
     // Вычисляем размеры для сохранения соотношения сторон
     float renderAspect = (float)m_width / (float)m_height;
@@ -111,10 +177,8 @@ void Framebuffer::RenderToScreen(int screenWidth, int screenHeight) {
     glTexCoord2f(0.0f, 0.0f); glVertex2f((float)drawX, (float)(drawY + drawHeight));
     glEnd();
     
-    // Восстанавливаем настройки
-    glDisable(GL_TEXTURE_2D);
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_LIGHTING);
+    // Состояние не восстанавливаем: Renderer::BeginFrame включает нужное сам,
+    // а повторы отбрасывает GLState
 }
 
 } // namespace Revolt
\ No newline at end of file
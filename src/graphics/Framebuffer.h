@@ -7,19 +7,29 @@ class Framebuffer {
 public:
     Framebuffer(int width, int height);
     ~Framebuffer();
-    
+
+    Framebuffer(const Framebuffer&) = delete;
+    Framebuffer& operator=(const Framebuffer&) = delete;
+
     bool Initialize();
+    bool Resize(int width, int height); // Пересоздаёт ресурсы под новое разрешение
     void BeginRender();
     void EndRender();
     void RenderToScreen(int screenWidth, int screenHeight);
-    
+
     int GetWidth() const { return m_width; }
     int GetHeight() const { return m_height; }
+    bool IsUsingFBO() const { return m_fboID != 0; }
 
 private:
+    bool CreateFBO();
+    void Release();
+
     int m_width;
     int m_height;
     GLuint m_textureID;
+    GLuint m_fboID;          // 0 - FBO недоступен, используем копирование из заднего буфера
+    GLuint m_depthBufferID;
 };
 
-} // namespace Revolt
\ No newline at end of file
+} // namespace Revolt
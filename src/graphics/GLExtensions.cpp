@@ -0,0 +1,210 @@
+#include "GLExtensions.h"
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+namespace Revolt {
+
+bool GLExtensions::s_initialized = false;
+int GLExtensions::s_versionMajor = 1;
+int GLExtensions::s_versionMinor = 1;
+bool GLExtensions::s_hasFramebufferObject = false;
+bool GLExtensions::s_hasVertexBufferObject = false;
+bool GLExtensions::s_hasShaders = false;
+bool GLExtensions::s_hasInstancing = false;
+bool GLExtensions::s_hasTimerQuery = false;
+
+GLExtensions::PFNGENFRAMEBUFFERS GLExtensions::GenFramebuffers = nullptr;
+GLExtensions::PFNDELETEFRAMEBUFFERS GLExtensions::DeleteFramebuffers = nullptr;
+GLExtensions::PFNBINDFRAMEBUFFER GLExtensions::BindFramebuffer = nullptr;
+GLExtensions::PFNFRAMEBUFFERTEXTURE2D GLExtensions::FramebufferTexture2D = nullptr;
+GLExtensions::PFNCHECKFRAMEBUFFERSTATUS GLExtensions::CheckFramebufferStatus = nullptr;
+GLExtensions::PFNGENRENDERBUFFERS GLExtensions::GenRenderbuffers = nullptr;
+GLExtensions::PFNDELETERENDERBUFFERS GLExtensions::DeleteRenderbuffers = nullptr;
+GLExtensions::PFNBINDRENDERBUFFER GLExtensions::BindRenderbuffer = nullptr;
+GLExtensions::PFNRENDERBUFFERSTORAGE GLExtensions::RenderbufferStorage = nullptr;
+GLExtensions::PFNFRAMEBUFFERRENDERBUFFER GLExtensions::FramebufferRenderbuffer = nullptr;
+
+GLExtensions::PFNGENBUFFERS GLExtensions::GenBuffers = nullptr;
+GLExtensions::PFNDELETEBUFFERS GLExtensions::DeleteBuffers = nullptr;
+GLExtensions::PFNBINDBUFFER GLExtensions::BindBuffer = nullptr;
+GLExtensions::PFNBUFFERDATA GLExtensions::BufferData = nullptr;
+GLExtensions::PFNBUFFERSUBDATA GLExtensions::BufferSubData = nullptr;
+
+GLExtensions::PFNCREATESHADER GLExtensions::CreateShader = nullptr;
+GLExtensions::PFNDELETESHADER GLExtensions::DeleteShader = nullptr;
+GLExtensions::PFNSHADERSOURCE GLExtensions::ShaderSource = nullptr;
+GLExtensions::PFNCOMPILESHADER GLExtensions::CompileShader = nullptr;
+GLExtensions::PFNGETSHADERIV GLExtensions::GetShaderiv = nullptr;
+GLExtensions::PFNGETSHADERINFOLOG GLExtensions::GetShaderInfoLog = nullptr;
+GLExtensions::PFNCREATEPROGRAM GLExtensions::CreateProgram = nullptr;
+GLExtensions::PFNDELETEPROGRAM GLExtensions::DeleteProgram = nullptr;
+GLExtensions::PFNATTACHSHADER GLExtensions::AttachShader = nullptr;
+GLExtensions::PFNBINDATTRIBLOCATION GLExtensions::BindAttribLocation = nullptr;
+GLExtensions::PFNLINKPROGRAM GLExtensions::LinkProgram = nullptr;
+GLExtensions::PFNGETPROGRAMIV GLExtensions::GetProgramiv = nullptr;
+GLExtensions::PFNGETPROGRAMINFOLOG GLExtensions::GetProgramInfoLog = nullptr;
+GLExtensions::PFNUSEPROGRAM GLExtensions::UseProgram = nullptr;
+GLExtensions::PFNGETUNIFORMLOCATION GLExtensions::GetUniformLocation = nullptr;
+GLExtensions::PFNUNIFORM1I GLExtensions::Uniform1i = nullptr;
+GLExtensions::PFNUNIFORM1F GLExtensions::Uniform1f = nullptr;
+GLExtensions::PFNUNIFORMFV GLExtensions::Uniform3fv = nullptr;
+GLExtensions::PFNUNIFORMFV GLExtensions::Uniform4fv = nullptr;
+GLExtensions::PFNUNIFORMMATRIX4FV GLExtensions::UniformMatrix4fv = nullptr;
+GLExtensions::PFNVERTEXATTRIBPOINTER GLExtensions::VertexAttribPointer = nullptr;
+GLExtensions::PFNENABLEVERTEXATTRIBARRAY GLExtensions::EnableVertexAttribArray = nullptr;
+GLExtensions::PFNDISABLEVERTEXATTRIBARRAY GLExtensions::DisableVertexAttribArray = nullptr;
+GLExtensions::PFNACTIVETEXTURE GLExtensions::ActiveTexture = nullptr;
+
+GLExtensions::PFNGENQUERIES GLExtensions::GenQueries = nullptr;
+GLExtensions::PFNDELETEQUERIES GLExtensions::DeleteQueries = nullptr;
+GLExtensions::PFNBEGINQUERY GLExtensions::BeginQuery = nullptr;
+GLExtensions::PFNENDQUERY GLExtensions::EndQuery = nullptr;
+GLExtensions::PFNGETQUERYOBJECTIV GLExtensions::GetQueryObjectiv = nullptr;
+GLExtensions::PFNGETQUERYOBJECTUI64V GLExtensions::GetQueryObjectui64v = nullptr;
+
+GLExtensions::PFNDRAWELEMENTSINSTANCED GLExtensions::DrawElementsInstanced = nullptr;
+GLExtensions::PFNVERTEXATTRIBDIVISOR GLExtensions::VertexAttribDivisor = nullptr;
+
+namespace {
+
+template <typename T>
+bool LoadProc(T& proc, const std::string& name) {
+    proc = reinterpret_cast<T>(glfwGetProcAddress(name.c_str()));
+    return proc != nullptr;
+}
+
+} // namespace
+
+bool GLExtensions::Initialize() {
+    if (s_initialized) {
+        return true;
+    }
+
+    // Строка версии начинается с "major.minor" (например, "2.1 Mesa 23.0")
+    const char* version = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+    if (!version || std::sscanf(version, "%d.%d", &s_versionMajor, &s_versionMinor) != 2) {
+        s_versionMajor = 1;
+        s_versionMinor = 1;
+    }
+
+    // ARB-версия входит в ядро OpenGL 3.0 и экспортируется без суффикса
+    if (glfwExtensionSupported("GL_ARB_framebuffer_object")) {
+        s_hasFramebufferObject = LoadFramebufferObject("");
+    } else if (glfwExtensionSupported("GL_EXT_framebuffer_object")) {
+        s_hasFramebufferObject = LoadFramebufferObject("EXT");
+    }
+
+    // Буферы вершин - ядро OpenGL 1.5, до этого только ARB-расширение
+    if (HasVersion(1, 5)) {
+        s_hasVertexBufferObject = LoadVertexBufferObject("");
+    } else if (glfwExtensionSupported("GL_ARB_vertex_buffer_object")) {
+        s_hasVertexBufferObject = LoadVertexBufferObject("ARB");
+    }
+    
+    // GLSL 1.20 - ядро OpenGL 2.1; загружаем функции 2.0
+    if (HasVersion(2, 0)) {
+        s_hasShaders = LoadShaders();
+    }
+    
+    // Инстансинг нужен только вместе с шейдерами: фиксированный конвейер
+    // не читает пользовательские атрибуты
+    if (s_hasShaders && s_hasVertexBufferObject) {
+        if (HasVersion(3, 3)) {
+            s_hasInstancing = LoadInstancing("");
+        } else if (glfwExtensionSupported("GL_ARB_draw_instanced") && 
+                   glfwExtensionSupported("GL_ARB_instanced_arrays")) {
+            s_hasInstancing = LoadInstancing("ARB");
+        }
+    }
+    
+    // Объекты запросов - ядро 1.5; 64-битный результат есть в ядре 3.3,
+    // в ARB_timer_query без суффикса и в EXT_timer_query с суффиксом EXT
+    if (HasVersion(1, 5)) {
+        if (HasVersion(3, 3) || glfwExtensionSupported("GL_ARB_timer_query")) {
+            s_hasTimerQuery = LoadTimerQuery("");
+        } else if (glfwExtensionSupported("GL_EXT_timer_query")) {
+            s_hasTimerQuery = LoadTimerQuery("EXT");
+        }
+    }
+    
+    std::cout << "Vertex buffer objects: " << (s_hasVertexBufferObject ? "yes" : "no") << std::endl;
+    std::cout << "Framebuffer objects: " << (s_hasFramebufferObject ? "yes" : "no") << std::endl;
+    std::cout << "Shaders: " << (s_hasShaders ? "yes" : "no") << std::endl;
+    std::cout << "Instancing: " << (s_hasInstancing ? "yes" : "no") << std::endl;
+    std::cout << "Timer queries: " << (s_hasTimerQuery ? "yes" : "no") << std::endl;
+
+    s_initialized = true;
+    return true;
+}
+
+bool GLExtensions::HasVersion(int major, int minor) {
+    return s_versionMajor > major || (s_versionMajor == major && s_versionMinor >= minor);
+}
+
+bool GLExtensions::LoadFramebufferObject(const char* suffix) {
+    const std::string s(suffix);
+    return LoadProc(GenFramebuffers, "glGenFramebuffers" + s) &&
+           LoadProc(DeleteFramebuffers, "glDeleteFramebuffers" + s) &&
+           LoadProc(BindFramebuffer, "glBindFramebuffer" + s) &&
+           LoadProc(FramebufferTexture2D, "glFramebufferTexture2D" + s) &&
+           LoadProc(CheckFramebufferStatus, "glCheckFramebufferStatus" + s) &&
+           LoadProc(GenRenderbuffers, "glGenRenderbuffers" + s) &&
+           LoadProc(DeleteRenderbuffers, "glDeleteRenderbuffers" + s) &&
+           LoadProc(BindRenderbuffer, "glBindRenderbuffer" + s) &&
+           LoadProc(RenderbufferStorage, "glRenderbufferStorage" + s) &&
+           LoadProc(FramebufferRenderbuffer, "glFramebufferRenderbuffer" + s);
+}
+
+bool GLExtensions::LoadVertexBufferObject(const char* suffix) {
+    const std::string s(suffix);
+    return LoadProc(GenBuffers, "glGenBuffers" + s) &&
+           LoadProc(DeleteBuffers, "glDeleteBuffers" + s) &&
+           LoadProc(BindBuffer, "glBindBuffer" + s) &&
+           LoadProc(BufferData, "glBufferData" + s) &&
+           LoadProc(BufferSubData, "glBufferSubData" + s);
+}
+
+bool GLExtensions::LoadShaders() {
+    return LoadProc(CreateShader, "glCreateShader") &&
+           LoadProc(DeleteShader, "glDeleteShader") &&
+           LoadProc(ShaderSource, "glShaderSource") &&
+           LoadProc(CompileShader, "glCompileShader") &&
+           LoadProc(GetShaderiv, "glGetShaderiv") &&
+           LoadProc(GetShaderInfoLog, "glGetShaderInfoLog") &&
+           LoadProc(CreateProgram, "glCreateProgram") &&
+           LoadProc(DeleteProgram, "glDeleteProgram") &&
+           LoadProc(AttachShader, "glAttachShader") &&
+           LoadProc(BindAttribLocation, "glBindAttribLocation") &&
+           LoadProc(LinkProgram, "glLinkProgram") &&
+           LoadProc(GetProgramiv, "glGetProgramiv") &&
+           LoadProc(GetProgramInfoLog, "glGetProgramInfoLog") &&
+           LoadProc(UseProgram, "glUseProgram") &&
+           LoadProc(GetUniformLocation, "glGetUniformLocation") &&
+           LoadProc(Uniform1i, "glUniform1i") &&
+           LoadProc(Uniform1f, "glUniform1f") &&
+           LoadProc(Uniform3fv, "glUniform3fv") &&
+           LoadProc(Uniform4fv, "glUniform4fv") &&
+           LoadProc(UniformMatrix4fv, "glUniformMatrix4fv") &&
+           LoadProc(VertexAttribPointer, "glVertexAttribPointer") &&
+           LoadProc(EnableVertexAttribArray, "glEnableVertexAttribArray") &&
+           LoadProc(DisableVertexAttribArray, "glDisableVertexAttribArray") &&
+           LoadProc(ActiveTexture, "glActiveTexture");
+}
+
+bool GLExtensions::LoadTimerQuery(const char* suffix) {
+    return LoadProc(GenQueries, "glGenQueries") &&
+           LoadProc(DeleteQueries, "glDeleteQueries") &&
+           LoadProc(BeginQuery, "glBeginQuery") &&
+           LoadProc(EndQuery, "glEndQuery") &&
+           LoadProc(GetQueryObjectiv, "glGetQueryObjectiv") &&
+           LoadProc(GetQueryObjectui64v, "glGetQueryObjectui64v" + std::string(suffix));
+}
+
+bool GLExtensions::LoadInstancing(const char* suffix) {
+    const std::string s(suffix);
+    return LoadProc(DrawElementsInstanced, "glDrawElementsInstanced" + s) &&
+           LoadProc(VertexAttribDivisor, "glVertexAttribDivisor" + s);
+}
+
+} // namespace Revolt
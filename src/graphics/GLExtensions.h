@@ -0,0 +1,229 @@
+#pragma once
+#include <GLFW/glfw3.h>
+#include <cstddef>
+#include <cstdint>
+
+// Windows SDK поставляет только заголовки OpenGL 1.1, поэтому всё, что новее,
+// загружаем вручную через glfwGetProcAddress.
+#if defined(_WIN32)
+#define REVOLT_GLAPI __stdcall
+#else
+#define REVOLT_GLAPI
+#endif
+
+// OpenGL 1.2 / 1.3
+#ifndef GL_CLAMP_TO_EDGE
+#define GL_CLAMP_TO_EDGE                0x812F
+#endif
+#ifndef GL_TEXTURE0
+#define GL_TEXTURE0                     0x84C0
+#endif
+#ifndef GL_TEXTURE1
+#define GL_TEXTURE1                     0x84C1
+#endif
+
+// Framebuffer object (ARB_framebuffer_object / EXT_framebuffer_object - значения совпадают)
+#ifndef GL_FRAMEBUFFER
+#define GL_FRAMEBUFFER                  0x8D40
+#endif
+#ifndef GL_RENDERBUFFER
+#define GL_RENDERBUFFER                 0x8D41
+#endif
+#ifndef GL_COLOR_ATTACHMENT0
+#define GL_COLOR_ATTACHMENT0            0x8CE0
+#endif
+#ifndef GL_DEPTH_ATTACHMENT
+#define GL_DEPTH_ATTACHMENT             0x8D00
+#endif
+#ifndef GL_FRAMEBUFFER_COMPLETE
+#define GL_FRAMEBUFFER_COMPLETE         0x8CD5
+#endif
+#ifndef GL_DEPTH_COMPONENT24
+#define GL_DEPTH_COMPONENT24            0x81A6
+#endif
+
+// Vertex buffer object (OpenGL 1.5 / ARB_vertex_buffer_object)
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER                 0x8892
+#endif
+#ifndef GL_ELEMENT_ARRAY_BUFFER
+#define GL_ELEMENT_ARRAY_BUFFER         0x8893
+#endif
+#ifndef GL_STREAM_DRAW
+#define GL_STREAM_DRAW                  0x88E0
+#endif
+#ifndef GL_STATIC_DRAW
+#define GL_STATIC_DRAW                  0x88E4
+#endif
+#ifndef GL_DYNAMIC_DRAW
+#define GL_DYNAMIC_DRAW                 0x88E8
+#endif
+
+// Запросы (OpenGL 1.5) и таймеры (ARB_timer_query / EXT_timer_query)
+#ifndef GL_QUERY_RESULT
+#define GL_QUERY_RESULT                 0x8866
+#endif
+#ifndef GL_QUERY_RESULT_AVAILABLE
+#define GL_QUERY_RESULT_AVAILABLE       0x8867
+#endif
+#ifndef GL_TIME_ELAPSED
+#define GL_TIME_ELAPSED                 0x88BF
+#endif
+
+// Шейдеры (OpenGL 2.0)
+#ifndef GL_FRAGMENT_SHADER
+#define GL_FRAGMENT_SHADER              0x8B30
+#endif
+#ifndef GL_VERTEX_SHADER
+#define GL_VERTEX_SHADER                0x8B31
+#endif
+#ifndef GL_COMPILE_STATUS
+#define GL_COMPILE_STATUS               0x8B81
+#endif
+#ifndef GL_LINK_STATUS
+#define GL_LINK_STATUS                  0x8B82
+#endif
+#ifndef GL_INFO_LOG_LENGTH
+#define GL_INFO_LOG_LENGTH              0x8B84
+#endif
+
+namespace Revolt {
+
+class GLExtensions {
+public:
+    // Загружает указатели на функции. Требует текущий контекст OpenGL,
+    // повторные вызовы ничего не делают.
+    static bool Initialize();
+
+    static bool HasFramebufferObject() { return s_hasFramebufferObject; }
+    static bool HasVertexBufferObject() { return s_hasVertexBufferObject; }
+    static bool HasShaders() { return s_hasShaders; }
+    // ARB_draw_instanced + ARB_instanced_arrays (или OpenGL 3.3)
+    static bool HasInstancing() { return s_hasInstancing; }
+    // ARB_timer_query (ядро 3.3) или EXT_timer_query
+    static bool HasTimerQuery() { return s_hasTimerQuery; }
+
+    // Версия контекста из glGetString(GL_VERSION)
+    static bool HasVersion(int major, int minor);
+
+    typedef void (REVOLT_GLAPI *PFNGENFRAMEBUFFERS)(GLsizei n, GLuint* framebuffers);
+    typedef void (REVOLT_GLAPI *PFNDELETEFRAMEBUFFERS)(GLsizei n, const GLuint* framebuffers);
+    typedef void (REVOLT_GLAPI *PFNBINDFRAMEBUFFER)(GLenum target, GLuint framebuffer);
+    typedef void (REVOLT_GLAPI *PFNFRAMEBUFFERTEXTURE2D)(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level);
+    typedef GLenum (REVOLT_GLAPI *PFNCHECKFRAMEBUFFERSTATUS)(GLenum target);
+    typedef void (REVOLT_GLAPI *PFNGENRENDERBUFFERS)(GLsizei n, GLuint* renderbuffers);
+    typedef void (REVOLT_GLAPI *PFNDELETERENDERBUFFERS)(GLsizei n, const GLuint* renderbuffers);
+    typedef void (REVOLT_GLAPI *PFNBINDRENDERBUFFER)(GLenum target, GLuint renderbuffer);
+    typedef void (REVOLT_GLAPI *PFNRENDERBUFFERSTORAGE)(GLenum target, GLenum internalformat, GLsizei width, GLsizei height);
+    typedef void (REVOLT_GLAPI *PFNFRAMEBUFFERRENDERBUFFER)(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer);
+
+    typedef void (REVOLT_GLAPI *PFNGENBUFFERS)(GLsizei n, GLuint* buffers);
+    typedef void (REVOLT_GLAPI *PFNDELETEBUFFERS)(GLsizei n, const GLuint* buffers);
+    typedef void (REVOLT_GLAPI *PFNBINDBUFFER)(GLenum target, GLuint buffer);
+    typedef void (REVOLT_GLAPI *PFNBUFFERDATA)(GLenum target, ptrdiff_t size, const void* data, GLenum usage);
+    typedef void (REVOLT_GLAPI *PFNBUFFERSUBDATA)(GLenum target, ptrdiff_t offset, ptrdiff_t size, const void* data);
+
+    typedef GLuint (REVOLT_GLAPI *PFNCREATESHADER)(GLenum type);
+    typedef void (REVOLT_GLAPI *PFNDELETESHADER)(GLuint shader);
+    typedef void (REVOLT_GLAPI *PFNSHADERSOURCE)(GLuint shader, GLsizei count, const char* const* strings, const GLint* lengths);
+    typedef void (REVOLT_GLAPI *PFNCOMPILESHADER)(GLuint shader);
+    typedef void (REVOLT_GLAPI *PFNGETSHADERIV)(GLuint shader, GLenum pname, GLint* params);
+    typedef void (REVOLT_GLAPI *PFNGETSHADERINFOLOG)(GLuint shader, GLsizei maxLength, GLsizei* length, char* infoLog);
+    typedef GLuint (REVOLT_GLAPI *PFNCREATEPROGRAM)();
+    typedef void (REVOLT_GLAPI *PFNDELETEPROGRAM)(GLuint program);
+    typedef void (REVOLT_GLAPI *PFNATTACHSHADER)(GLuint program, GLuint shader);
+    typedef void (REVOLT_GLAPI *PFNBINDATTRIBLOCATION)(GLuint program, GLuint index, const char* name);
+    typedef void (REVOLT_GLAPI *PFNLINKPROGRAM)(GLuint program);
+    typedef void (REVOLT_GLAPI *PFNGETPROGRAMIV)(GLuint program, GLenum pname, GLint* params);
+    typedef void (REVOLT_GLAPI *PFNGETPROGRAMINFOLOG)(GLuint program, GLsizei maxLength, GLsizei* length, char* infoLog);
+    typedef void (REVOLT_GLAPI *PFNUSEPROGRAM)(GLuint program);
+    typedef GLint (REVOLT_GLAPI *PFNGETUNIFORMLOCATION)(GLuint program, const char* name);
+    typedef void (REVOLT_GLAPI *PFNUNIFORM1I)(GLint location, GLint v0);
+    typedef void (REVOLT_GLAPI *PFNUNIFORM1F)(GLint location, GLfloat v0);
+    typedef void (REVOLT_GLAPI *PFNUNIFORMFV)(GLint location, GLsizei count, const GLfloat* value);
+    typedef void (REVOLT_GLAPI *PFNUNIFORMMATRIX4FV)(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+    typedef void (REVOLT_GLAPI *PFNVERTEXATTRIBPOINTER)(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer);
+    typedef void (REVOLT_GLAPI *PFNENABLEVERTEXATTRIBARRAY)(GLuint index);
+    typedef void (REVOLT_GLAPI *PFNDISABLEVERTEXATTRIBARRAY)(GLuint index);
+    typedef void (REVOLT_GLAPI *PFNACTIVETEXTURE)(GLenum texture);
+
+    typedef void (REVOLT_GLAPI *PFNGENQUERIES)(GLsizei n, GLuint* ids);
+    typedef void (REVOLT_GLAPI *PFNDELETEQUERIES)(GLsizei n, const GLuint* ids);
+    typedef void (REVOLT_GLAPI *PFNBEGINQUERY)(GLenum target, GLuint id);
+    typedef void (REVOLT_GLAPI *PFNENDQUERY)(GLenum target);
+    typedef void (REVOLT_GLAPI *PFNGETQUERYOBJECTIV)(GLuint id, GLenum pname, GLint* params);
+    typedef void (REVOLT_GLAPI *PFNGETQUERYOBJECTUI64V)(GLuint id, GLenum pname, uint64_t* params);
+
+    typedef void (REVOLT_GLAPI *PFNDRAWELEMENTSINSTANCED)(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instanceCount);
+    typedef void (REVOLT_GLAPI *PFNVERTEXATTRIBDIVISOR)(GLuint index, GLuint divisor);
+
+    static PFNGENFRAMEBUFFERS GenFramebuffers;
+    static PFNDELETEFRAMEBUFFERS DeleteFramebuffers;
+    static PFNBINDFRAMEBUFFER BindFramebuffer;
+    static PFNFRAMEBUFFERTEXTURE2D FramebufferTexture2D;
+    static PFNCHECKFRAMEBUFFERSTATUS CheckFramebufferStatus;
+    static PFNGENRENDERBUFFERS GenRenderbuffers;
+    static PFNDELETERENDERBUFFERS DeleteRenderbuffers;
+    static PFNBINDRENDERBUFFER BindRenderbuffer;
+    static PFNRENDERBUFFERSTORAGE RenderbufferStorage;
+    static PFNFRAMEBUFFERRENDERBUFFER FramebufferRenderbuffer;
+
+    static PFNGENBUFFERS GenBuffers;
+    static PFNDELETEBUFFERS DeleteBuffers;
+    static PFNBINDBUFFER BindBuffer;
+    static PFNBUFFERDATA BufferData;
+    static PFNBUFFERSUBDATA BufferSubData;
+
+    static PFNCREATESHADER CreateShader;
+    static PFNDELETESHADER DeleteShader;
+    static PFNSHADERSOURCE ShaderSource;
+    static PFNCOMPILESHADER CompileShader;
+    static PFNGETSHADERIV GetShaderiv;
+    static PFNGETSHADERINFOLOG GetShaderInfoLog;
+    static PFNCREATEPROGRAM CreateProgram;
+    static PFNDELETEPROGRAM DeleteProgram;
+    static PFNATTACHSHADER AttachShader;
+    static PFNBINDATTRIBLOCATION BindAttribLocation;
+    static PFNLINKPROGRAM LinkProgram;
+    static PFNGETPROGRAMIV GetProgramiv;
+    static PFNGETPROGRAMINFOLOG GetProgramInfoLog;
+    static PFNUSEPROGRAM UseProgram;
+    static PFNGETUNIFORMLOCATION GetUniformLocation;
+    static PFNUNIFORM1I Uniform1i;
+    static PFNUNIFORM1F Uniform1f;
+    static PFNUNIFORMFV Uniform3fv;
+    static PFNUNIFORMFV Uniform4fv;
+    static PFNUNIFORMMATRIX4FV UniformMatrix4fv;
+    static PFNVERTEXATTRIBPOINTER VertexAttribPointer;
+    static PFNENABLEVERTEXATTRIBARRAY EnableVertexAttribArray;
+    static PFNDISABLEVERTEXATTRIBARRAY DisableVertexAttribArray;
+    static PFNACTIVETEXTURE ActiveTexture; // Ядро 1.3, загружается вместе с шейдерами
+
+    static PFNGENQUERIES GenQueries;
+    static PFNDELETEQUERIES DeleteQueries;
+    static PFNBEGINQUERY BeginQuery;
+    static PFNENDQUERY EndQuery;
+    static PFNGETQUERYOBJECTIV GetQueryObjectiv;
+    static PFNGETQUERYOBJECTUI64V GetQueryObjectui64v;
+
+    static PFNDRAWELEMENTSINSTANCED DrawElementsInstanced;
+    static PFNVERTEXATTRIBDIVISOR VertexAttribDivisor;
+
+private:
+    static bool LoadFramebufferObject(const char* suffix);
+    static bool LoadVertexBufferObject(const char* suffix);
+    static bool LoadShaders();
+    static bool LoadInstancing(const char* suffix);
+    static bool LoadTimerQuery(const char* suffix);
+
+    static bool s_initialized;
+    static int s_versionMajor;
+    static int s_versionMinor;
+    static bool s_hasFramebufferObject;
+    static bool s_hasVertexBufferObject;
+    static bool s_hasShaders;
+    static bool s_hasInstancing;
+    static bool s_hasTimerQuery;
+};
+
+} // namespace Revolt
@@ -0,0 +1,235 @@
+#include "GLState.h"
+#include "GLExtensions.h"
+#include <cstring>
+
+namespace Revolt {
+
+GLState::TriState GLState::s_caps[GLState::CAP_COUNT];
+GLState::TriState GLState::s_textureEnabled[GLState::MAX_TEXTURE_UNITS];
+int GLState::s_activeUnit = 0;
+GLuint GLState::s_boundTextures[GLState::MAX_TEXTURE_UNITS];
+bool GLState::s_boundValid[GLState::MAX_TEXTURE_UNITS];
+GLenum GLState::s_blendSource = 0;
+GLenum GLState::s_blendDestination = 0;
+bool GLState::s_blendValid = false;
+GLState::TriState GLState::s_depthMask = GLState::STATE_UNKNOWN;
+GLenum GLState::s_matrixMode = 0;
+GLenum GLState::s_colorMaterialFace = 0;
+GLenum GLState::s_colorMaterialMode = 0;
+bool GLState::s_colorMaterialValid = false;
+GLState::LightState GLState::s_lights[GLState::MAX_LIGHTS];
+
+GLState::FrameStats GLState::s_frame = {0, 0};
+GLState::FrameStats GLState::s_lastFrame = {0, 0};
+
+namespace {
+
+int GetLightParamIndex(GLenum pname) {
+    switch (pname) {
+        case GL_AMBIENT:  return 0;
+        case GL_DIFFUSE:  return 1;
+        case GL_SPECULAR: return 2;
+        default:          return -1;
+    }
+}
+
+} // namespace
+
+void GLState::Invalidate() {
+    for (TriState& cap : s_caps) {
+        cap = STATE_UNKNOWN;
+    }
+    for (int unit = 0; unit < MAX_TEXTURE_UNITS; ++unit) {
+        s_textureEnabled[unit] = STATE_UNKNOWN;
+        s_boundValid[unit] = false;
+    }
+    s_activeUnit = -1;
+    s_blendValid = false;
+    s_depthMask = STATE_UNKNOWN;
+    s_matrixMode = 0;
+    s_colorMaterialValid = false;
+    for (LightState& light : s_lights) {
+        light.colorValid[0] = light.colorValid[1] = light.colorValid[2] = false;
+        light.positionValid = false;
+    }
+}
+
+void GLState::BeginFrame() {
+    s_lastFrame = s_frame;
+    s_frame.issued = 0;
+    s_frame.elided = 0;
+}
+
+bool GLState::Issue(bool changed) {
+    if (changed) {
+        ++s_frame.issued;
+    } else {
+        ++s_frame.elided;
+    }
+    return changed;
+}
+
+int GLState::GetCapIndex(GLenum cap) {
+    switch (cap) {
+        case GL_BLEND:          return CAP_BLEND;
+        case GL_DEPTH_TEST:     return CAP_DEPTH_TEST;
+        case GL_LIGHTING:       return CAP_LIGHTING;
+        case GL_TEXTURE_2D:     return CAP_TEXTURE_2D;
+        case GL_COLOR_MATERIAL: return CAP_COLOR_MATERIAL;
+        case GL_NORMALIZE:      return CAP_NORMALIZE;
+        case GL_CULL_FACE:      return CAP_CULL_FACE;
+    }
+    if (cap >= GL_LIGHT0 && cap < GL_LIGHT0 + MAX_LIGHTS) {
+        return CAP_LIGHT0 + static_cast<int>(cap - GL_LIGHT0);
+    }
+    return -1;
+}
+
+GLState::TriState& GLState::GetCapState(int index) {
+    // GL_TEXTURE_2D включается для каждого блока отдельно; пока блок
+    // неизвестен, считаем неизвестным и флаг
+    if (index == CAP_TEXTURE_2D) {
+        static TriState unknown;
+        if (s_activeUnit < 0) {
+            unknown = STATE_UNKNOWN;
+            return unknown;
+        }
+        return s_textureEnabled[s_activeUnit];
+    }
+    return s_caps[index];
+}
+
+void GLState::SetEnabled(GLenum cap, bool enabled) {
+    int index = GetCapIndex(cap);
+    if (index < 0) {
+        Issue(true);
+        if (enabled) glEnable(cap); else glDisable(cap);
+        return;
+    }
+
+    TriState& state = GetCapState(index);
+    TriState wanted = enabled ? STATE_ENABLED : STATE_DISABLED;
+    if (Issue(state != wanted)) {
+        if (enabled) glEnable(cap); else glDisable(cap);
+        state = wanted;
+    }
+}
+
+void GLState::Enable(GLenum cap) {
+    SetEnabled(cap, true);
+}
+
+void GLState::Disable(GLenum cap) {
+    SetEnabled(cap, false);
+}
+
+void GLState::ActiveTexture(GLenum unit) {
+    int index = static_cast<int>(unit - GL_TEXTURE0);
+    if (Issue(index != s_activeUnit || index >= MAX_TEXTURE_UNITS)) {
+        GLExtensions::ActiveTexture(unit);
+        s_activeUnit = index < MAX_TEXTURE_UNITS ? index : -1;
+    }
+}
+
+bool GLState::BindTexture(GLuint texture) {
+    // Без glActiveTexture (нет шейдеров) активен всегда блок 0
+    int unit = s_activeUnit >= 0 ? s_activeUnit : 0;
+    bool known = s_activeUnit >= 0 || !GLExtensions::ActiveTexture;
+    if (Issue(!known || !s_boundValid[unit] || s_boundTextures[unit] != texture)) {
+        glBindTexture(GL_TEXTURE_2D, texture);
+        if (known) {
+            s_boundTextures[unit] = texture;
+            s_boundValid[unit] = true;
+        }
+        return true;
+    }
+    return false;
+}
+
+void GLState::DeleteTextures(GLsizei count, const GLuint* textures) {
+    glDeleteTextures(count, textures);
+    // Удалённая привязанная текстура заменяется на 0
+    for (GLsizei i = 0; i < count; ++i) {
+        for (int unit = 0; unit < MAX_TEXTURE_UNITS; ++unit) {
+            if (s_boundValid[unit] && s_boundTextures[unit] == textures[i]) {
+                s_boundTextures[unit] = 0;
+            }
+        }
+    }
+}
+
+void GLState::BlendFunc(GLenum source, GLenum destination) {
+    if (Issue(!s_blendValid || s_blendSource != source || s_blendDestination != destination)) {
+        glBlendFunc(source, destination);
+        s_blendSource = source;
+        s_blendDestination = destination;
+        s_blendValid = true;
+    }
+}
+
+void GLState::DepthMask(bool write) {
+    TriState wanted = write ? STATE_ENABLED : STATE_DISABLED;
+    if (Issue(s_depthMask != wanted)) {
+        glDepthMask(write ? GL_TRUE : GL_FALSE);
+        s_depthMask = wanted;
+    }
+}
+
+void GLState::MatrixMode(GLenum mode) {
+    if (Issue(s_matrixMode != mode)) {
+        glMatrixMode(mode);
+        s_matrixMode = mode;
+    }
+}
+
+void GLState::ColorMaterial(GLenum face, GLenum mode) {
+    if (Issue(!s_colorMaterialValid || s_colorMaterialFace != face || s_colorMaterialMode != mode)) {
+        glColorMaterial(face, mode);
+        s_colorMaterialFace = face;
+        s_colorMaterialMode = mode;
+        s_colorMaterialValid = true;
+    }
+}
+
+void GLState::Light(GLenum light, GLenum pname, const GLfloat* params) {
+    int index = static_cast<int>(light - GL_LIGHT0);
+    int param = GetLightParamIndex(pname);
+    if (index < 0 || index >= MAX_LIGHTS || param < 0) {
+        Issue(true);
+        glLightfv(light, pname, params);
+        if (pname == GL_POSITION && index >= 0 && index < MAX_LIGHTS) {
+            s_lights[index].positionValid = false;
+        }
+        return;
+    }
+
+    LightState& state = s_lights[index];
+    bool changed = !state.colorValid[param] || std::memcmp(state.color[param], params, sizeof(state.color[param])) != 0;
+    if (Issue(changed)) {
+        glLightfv(light, pname, params);
+        std::memcpy(state.color[param], params, sizeof(state.color[param]));
+        state.colorValid[param] = true;
+    }
+}
+
+void GLState::LightPosition(GLenum light, const GLfloat position[4], const GLfloat modelView[16]) {
+    int index = static_cast<int>(light - GL_LIGHT0);
+    if (index < 0 || index >= MAX_LIGHTS) {
+        Issue(true);
+        glLightfv(light, GL_POSITION, position);
+        return;
+    }
+
+    LightState& state = s_lights[index];
+    bool changed = !state.positionValid ||
+                   std::memcmp(state.position, position, sizeof(state.position)) != 0 ||
+                   std::memcmp(state.modelView, modelView, sizeof(state.modelView)) != 0;
+    if (Issue(changed)) {
+        glLightfv(light, GL_POSITION, position);
+        std::memcpy(state.position, position, sizeof(state.position));
+        std::memcpy(state.modelView, modelView, sizeof(state.modelView));
+        state.positionValid = true;
+    }
+}
+
+} // namespace Revolt
@@ -0,0 +1,106 @@
+#pragma once
+#include <GLFW/glfw3.h>
+#include <cstdint>
+
+namespace Revolt {
+
+// Теневая копия состояния OpenGL: повторная установка того же значения
+// не доходит до драйвера. Все подсистемы меняют отслеживаемое состояние
+// только через этот класс; после чужих изменений (glPushAttrib/glPopAttrib,
+// сторонний код) нужно вызвать Invalidate().
+//
+// Отслеживаются: флаги glEnable из списка ниже, привязанные текстуры
+// (GL_TEXTURE_2D, два блока), активный блок, функция смешивания, маска
+// глубины, режим матрицы, glColorMaterial и параметры источников света.
+// Остальные флаги glEnable передаются драйверу без кэширования.
+class GLState {
+public:
+    static const int MAX_TEXTURE_UNITS = 2;
+    static const int MAX_LIGHTS = 8;
+
+    // Статистика за кадр: сколько вызовов ушло в драйвер и сколько отброшено
+    struct FrameStats {
+        uint32_t issued;
+        uint32_t elided;
+    };
+
+    // Сбрасывает всё в "неизвестно" - следующая установка обязательно выполнится
+    static void Invalidate();
+
+    // Закрывает статистику кадра (доступна через GetLastFrameStats) и начинает новую
+    static void BeginFrame();
+    static const FrameStats& GetLastFrameStats() { return s_lastFrame; }
+
+    static void Enable(GLenum cap);
+    static void Disable(GLenum cap);
+    static void SetEnabled(GLenum cap, bool enabled);
+
+    static void ActiveTexture(GLenum unit);
+    // Привязка к GL_TEXTURE_2D текущего блока; true, если вызов дошёл до драйвера
+    static bool BindTexture(GLuint texture);
+    // glDeleteTextures + сброс привязок к удалённым именам (их может получить новая текстура)
+    static void DeleteTextures(GLsizei count, const GLuint* textures);
+
+    static void BlendFunc(GLenum source, GLenum destination);
+    static void DepthMask(bool write);
+    static void MatrixMode(GLenum mode);
+    static void ColorMaterial(GLenum face, GLenum mode);
+
+    // GL_AMBIENT, GL_DIFFUSE, GL_SPECULAR (4 числа); остальное без кэширования
+    static void Light(GLenum light, GLenum pname, const GLfloat* params);
+    // Позиция переводится в координаты глаза текущей MODELVIEW, поэтому
+    // вызывающий передаёт загруженную матрицу - она входит в ключ кэша
+    static void LightPosition(GLenum light, const GLfloat position[4], const GLfloat modelView[16]);
+
+private:
+    enum Cap {
+        CAP_BLEND,
+        CAP_DEPTH_TEST,
+        CAP_LIGHTING,
+        CAP_TEXTURE_2D, // Для каждого блока отдельно, см. s_textureEnabled
+        CAP_COLOR_MATERIAL,
+        CAP_NORMALIZE,
+        CAP_CULL_FACE,
+        CAP_LIGHT0,     // GL_LIGHT0..GL_LIGHT7 подряд
+        CAP_COUNT = CAP_LIGHT0 + MAX_LIGHTS
+    };
+
+    // Нулевое значение статических массивов - "неизвестно"
+    enum TriState : uint8_t {
+        STATE_UNKNOWN = 0,
+        STATE_DISABLED,
+        STATE_ENABLED
+    };
+
+    struct LightState {
+        bool colorValid[3]; // GL_AMBIENT, GL_DIFFUSE, GL_SPECULAR
+        GLfloat color[3][4];
+        bool positionValid;
+        GLfloat position[4];
+        GLfloat modelView[16];
+    };
+
+    static int GetCapIndex(GLenum cap);
+    static TriState& GetCapState(int index);
+    static bool Issue(bool changed);
+
+    static TriState s_caps[CAP_COUNT];
+    static TriState s_textureEnabled[MAX_TEXTURE_UNITS];
+    static int s_activeUnit;           // -1 - неизвестно, при запуске блок 0
+    static GLuint s_boundTextures[MAX_TEXTURE_UNITS];
+    static bool s_boundValid[MAX_TEXTURE_UNITS];
+    static GLenum s_blendSource;
+    static GLenum s_blendDestination;
+    static bool s_blendValid;
+    static TriState s_depthMask;
+    static GLenum s_matrixMode;        // 0 - неизвестно
+    static GLenum s_colorMaterialFace;
+    static GLenum s_colorMaterialMode;
+    static bool s_colorMaterialValid;
+    static LightState s_lights[MAX_LIGHTS];
+
+    static FrameStats s_frame;
+    static FrameStats s_lastFrame;
+};
+
+} // namespace Revolt
@@ -0,0 +1,114 @@
+#include "GPUTimer.h"
+#include "GLExtensions.h"
+#include <iostream>
+
+namespace Revolt {
+
+GPUTimer::GPUTimer()
+    : m_currentFrame(0), m_activePass(-1), m_initialized(false), m_hasResults(false), m_droppedFrames(0) {
+    for (FrameSlot& slot : m_frames) {
+        slot.count = 0;
+    }
+    for (float& time : m_passTimes) {
+        time = 0.0f;
+    }
+}
+
+GPUTimer::~GPUTimer() {
+    // Контекст мог быть уничтожен раньше
+    if (m_initialized && glfwGetCurrentContext()) {
+        for (FrameSlot& slot : m_frames) {
+            GLExtensions::DeleteQueries(MAX_SEGMENTS, slot.queries);
+        }
+    }
+}
+
+bool GPUTimer::Initialize() {
+    if (m_initialized) {
+        return true;
+    }
+    if (!GLExtensions::HasTimerQuery()) {
+        std::cout << "GPU pass timing unavailable (no timer queries)" << std::endl;
+        return false;
+    }
+
+    for (FrameSlot& slot : m_frames) {
+        GLExtensions::GenQueries(MAX_SEGMENTS, slot.queries);
+        slot.count = 0;
+    }
+    m_initialized = true;
+    return true;
+}
+
+void GPUTimer::BeginFrame() {
+    if (!m_initialized) {
+        return;
+    }
+
+    EndPass();
+    m_currentFrame = (m_currentFrame + 1) % FRAMES_IN_FLIGHT;
+    Collect(m_frames[m_currentFrame]);
+}
+
+void GPUTimer::Collect(FrameSlot& slot) {
+    if (slot.count == 0) {
+        return;
+    }
+
+    // Запросы завершаются по порядку: готов последний - готовы все
+    GLint available = 0;
+    GLExtensions::GetQueryObjectiv(slot.queries[slot.count - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+
+    if (available) {
+        uint64_t totals[PASS_COUNT] = {};
+        for (int i = 0; i < slot.count; ++i) {
+            uint64_t elapsed = 0;
+            GLExtensions::GetQueryObjectui64v(slot.queries[i], GL_QUERY_RESULT, &elapsed);
+            totals[slot.passes[i]] += elapsed;
+        }
+        for (int pass = 0; pass < PASS_COUNT; ++pass) {
+            m_passTimes[pass] = static_cast<float>(totals[pass] / 1.0e6);
+        }
+        m_hasResults = true;
+    } else {
+        // Ждать не будем: запросы просто переиспользуются
+        ++m_droppedFrames;
+    }
+    slot.count = 0;
+}
+
+void GPUTimer::BeginPass(Pass pass) {
+    if (!m_initialized || m_activePass == pass) {
+        return;
+    }
+
+    EndPass();
+
+    FrameSlot& slot = m_frames[m_currentFrame];
+    if (slot.count >= MAX_SEGMENTS) {
+        return;
+    }
+    GLExtensions::BeginQuery(GL_TIME_ELAPSED, slot.queries[slot.count]);
+    slot.passes[slot.count] = pass;
+    ++slot.count;
+    m_activePass = pass;
+}
+
+void GPUTimer::EndPass() {
+    if (m_activePass < 0) {
+        return;
+    }
+    GLExtensions::EndQuery(GL_TIME_ELAPSED);
+    m_activePass = -1;
+}
+
+const char* GPUTimer::GetPassName(Pass pass) {
+    switch (pass) {
+        case PASS_SCENE:  return "Scene";
+        case PASS_TEXT:   return "Text";
+        case PASS_SCREEN: return "Screen";
+        default:          return "Unknown";
+    }
+}
+
+} // namespace Revolt
@@ -0,0 +1,68 @@
+#pragma once
+#include <GLFW/glfw3.h>
+#include <cstdint>
+
+namespace Revolt {
+
+// Время проходов на GPU через запросы GL_TIME_ELAPSED. Результаты читаются,
+// когда слот кадра используется снова (через FRAMES_IN_FLIGHT - 1 кадров),
+// и только если уже готовы - ожидания GPU нет. Без ARB/EXT_timer_query
+// все вызовы ничего не делают, а IsAvailable() возвращает false.
+//
+// Одновременно может идти только один запрос GL_TIME_ELAPSED, поэтому
+// проходы не вкладываются: BeginPass завершает текущий. Один проход может
+// встречаться за кадр несколько раз - отрезки суммируются.
+class GPUTimer {
+public:
+    enum Pass {
+        PASS_SCENE,  // Сцена в низком разрешении и копирование в текстуру
+        PASS_TEXT,   // Отладочный текст
+        PASS_SCREEN, // Растягивание на экран
+        PASS_COUNT
+    };
+
+    static const int FRAMES_IN_FLIGHT = 4;
+    static const int MAX_SEGMENTS = 8; // Отрезков (запросов) на кадр
+
+    GPUTimer();
+    ~GPUTimer();
+
+    GPUTimer(const GPUTimer&) = delete;
+    GPUTimer& operator=(const GPUTimer&) = delete;
+
+    // Создаёт запросы; повторный вызов ничего не делает
+    bool Initialize();
+    bool IsAvailable() const { return m_initialized; }
+
+    // Забирает готовые результаты старого кадра и начинает новый
+    void BeginFrame();
+    void BeginPass(Pass pass);
+    void EndPass();
+
+    // Миллисекунды последнего прочитанного кадра
+    float GetPassTime(Pass pass) const { return m_passTimes[pass]; }
+    bool HasResults() const { return m_hasResults; }
+    // Кадры, результаты которых не успели к повторному использованию слота
+    uint32_t GetDroppedFrames() const { return m_droppedFrames; }
+
+    static const char* GetPassName(Pass pass);
+
+private:
+    struct FrameSlot {
+        GLuint queries[MAX_SEGMENTS];
+        Pass passes[MAX_SEGMENTS];
+        int count;
+    };
+
+    void Collect(FrameSlot& slot);
+
+    FrameSlot m_frames[FRAMES_IN_FLIGHT];
+    int m_currentFrame;
+    int m_activePass;   // -1 - запрос не идёт
+    bool m_initialized;
+    float m_passTimes[PASS_COUNT];
+    bool m_hasResults;
+    uint32_t m_droppedFrames;
+};
+
+} // namespace Revolt
@@ -0,0 +1,182 @@
+#include "MDLFile.h"
+#include <cstring>
+#include <iostream>
+
+namespace Revolt {
+
+namespace {
+    const int32_t MDL_IDENT = 1330660425; // "IDPO"
+    const int32_t MDL_VERSION = 6;
+    // bboxMin, bboxMax и имя перед вершинами кадра
+    const size_t FRAME_HEADER_SIZE = 2 * sizeof(MDLVertex) + 16;
+
+    static_assert(sizeof(MDLHeader) == 84, "MDLHeader must match the file layout");
+    static_assert(sizeof(MDLTexCoord) == 12 && sizeof(MDLTriangle) == 16 && sizeof(MDLVertex) == 4,
+                  "MDL structs must match the file layout");
+
+    // Сдвигает offset на bytes, если они есть в файле. Размеры считаются
+    // в 64 битах: произведения полей заголовка не переполняются
+    bool Advance(uint64_t& offset, uint64_t bytes, const MappedFile& file) {
+        if (!file.Contains(offset, bytes)) {
+            return false;
+        }
+        offset += bytes;
+        return true;
+    }
+
+    // Поместятся ли count записей по recordSize байт после offset. Проверка
+    // делением: счётчик из повреждённого заголовка не должен дойти до reserve
+    bool FitsRecords(uint64_t offset, int32_t count, uint64_t recordSize, const MappedFile& file) {
+        uint64_t size = file.GetSize();
+        return offset <= size && static_cast<uint64_t>(count) <= (size - offset) / recordSize;
+    }
+
+    int32_t ReadInt32(const uint8_t* data) {
+        int32_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+}
+
+MDLFile::MDLFile() : m_header(), m_texCoords(nullptr), m_triangles(nullptr) {
+}
+
+MDLFile::~MDLFile() {
+    Close();
+}
+
+bool MDLFile::Open(const std::string& filename) {
+    Close();
+
+    if (!m_file.Open(filename)) {
+        std::cerr << "Failed to open MDL file: " << filename << std::endl;
+        return false;
+    }
+
+    if (!Validate(filename)) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void MDLFile::Close() {
+    m_file.Close();
+    m_skinOffsets.clear();
+    m_frameOffsets.clear();
+    m_texCoords = nullptr;
+    m_triangles = nullptr;
+    m_alignedTexCoords.clear();
+    m_alignedTriangles.clear();
+}
+
+bool MDLFile::Validate(const std::string& filename) {
+    const uint8_t* data = m_file.GetData();
+    if (!m_file.Contains(0, sizeof(MDLHeader))) {
+        std::cerr << "MDL file is truncated: " << filename << std::endl;
+        return false;
+    }
+    std::memcpy(&m_header, data, sizeof(MDLHeader));
+
+    // Check magic number and version
+    if (m_header.ident != MDL_IDENT) {
+        std::cerr << "Invalid MDL file (bad magic number)" << std::endl;
+        return false;
+    }
+
+    if (m_header.version != MDL_VERSION) {
+        std::cerr << "Unsupported MDL version: " << m_header.version << std::endl;
+        return false;
+    }
+
+    if (m_header.numSkins < 0 || m_header.skinWidth <= 0 || m_header.skinHeight <= 0 ||
+        m_header.numVerts < 0 || m_header.numTris < 0 || m_header.numFrames < 0) {
+        std::cerr << "Invalid MDL header counts: " << filename << std::endl;
+        return false;
+    }
+
+    const uint64_t skinSize = static_cast<uint64_t>(m_header.skinWidth) * static_cast<uint64_t>(m_header.skinHeight);
+    const uint64_t numVerts = static_cast<uint64_t>(m_header.numVerts);
+    uint64_t offset = sizeof(MDLHeader);
+    bool truncated = false;
+
+    truncated = !FitsRecords(offset, m_header.numSkins, sizeof(int32_t) + skinSize, m_file);
+    if (!truncated) {
+        m_skinOffsets.reserve(m_header.numSkins);
+    }
+    for (int i = 0; i < m_header.numSkins && !truncated; ++i) {
+        if (!Advance(offset, sizeof(int32_t), m_file)) {
+            truncated = true;
+            break;
+        }
+        // For now, we only handle single skins (not groups)
+        if (ReadInt32(data + offset - sizeof(int32_t)) != 0) {
+            std::cerr << "Group skins not supported yet" << std::endl;
+            return false;
+        }
+        m_skinOffsets.push_back(static_cast<size_t>(offset));
+        truncated = !Advance(offset, skinSize, m_file);
+    }
+
+    uint64_t texCoordOffset = offset;
+    truncated = truncated || !Advance(offset, numVerts * sizeof(MDLTexCoord), m_file);
+    uint64_t triangleOffset = offset;
+    truncated = truncated || !Advance(offset, static_cast<uint64_t>(m_header.numTris) * sizeof(MDLTriangle), m_file);
+
+    truncated = truncated || !FitsRecords(offset, m_header.numFrames,
+                                          sizeof(int32_t) + FRAME_HEADER_SIZE + numVerts * sizeof(MDLVertex), m_file);
+    if (!truncated) {
+        m_frameOffsets.reserve(m_header.numFrames);
+    }
+    for (int i = 0; i < m_header.numFrames && !truncated; ++i) {
+        if (!Advance(offset, sizeof(int32_t), m_file)) {
+            truncated = true;
+            break;
+        }
+        // For now, we only handle simple frames
+        if (ReadInt32(data + offset - sizeof(int32_t)) != 0) {
+            std::cerr << "Group frames not supported yet" << std::endl;
+            return false;
+        }
+        m_frameOffsets.push_back(static_cast<size_t>(offset));
+        truncated = !Advance(offset, FRAME_HEADER_SIZE + numVerts * sizeof(MDLVertex), m_file);
+    }
+
+    if (truncated) {
+        std::cerr << "MDL file is truncated: " << filename << std::endl;
+        return false;
+    }
+
+    // Отображение выровнено по странице, буфер - по malloc, так что
+    // выравнивание зависит только от смещения раздела в файле
+    if (texCoordOffset % alignof(MDLTexCoord) == 0) {
+        m_texCoords = reinterpret_cast<const MDLTexCoord*>(data + texCoordOffset);
+    } else {
+        m_alignedTexCoords.resize(m_header.numVerts);
+        std::memcpy(m_alignedTexCoords.data(), data + texCoordOffset, m_alignedTexCoords.size() * sizeof(MDLTexCoord));
+        m_texCoords = m_alignedTexCoords.data();
+    }
+
+    if (triangleOffset % alignof(MDLTriangle) == 0) {
+        m_triangles = reinterpret_cast<const MDLTriangle*>(data + triangleOffset);
+    } else {
+        m_alignedTriangles.resize(m_header.numTris);
+        std::memcpy(m_alignedTriangles.data(), data + triangleOffset, m_alignedTriangles.size() * sizeof(MDLTriangle));
+        m_triangles = m_alignedTriangles.data();
+    }
+
+    return true;
+}
+
+MDLFile::FrameView MDLFile::GetFrame(int frame) const {
+    const uint8_t* data = m_file.GetData() + m_frameOffsets[frame];
+
+    FrameView view;
+    std::memcpy(&view.bboxMin, data, sizeof(MDLVertex));
+    std::memcpy(&view.bboxMax, data + sizeof(MDLVertex), sizeof(MDLVertex));
+    view.name = reinterpret_cast<const char*>(data + 2 * sizeof(MDLVertex));
+    view.vertices = reinterpret_cast<const MDLVertex*>(data + FRAME_HEADER_SIZE);
+    return view;
+}
+
+} // namespace Revolt
@@ -0,0 +1,99 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../core/MappedFile.h"
+
+namespace Revolt {
+
+struct MDLHeader {
+    int32_t ident;           // Magic number: "IDPO"
+    int32_t version;         // Must be 6
+    float scale[3];          // Scale factor
+    float translate[3];      // Translation vector
+    float boundingRadius;
+    float eyePosition[3];    // Eyes' position
+    int32_t numSkins;        // Number of textures
+    int32_t skinWidth;       // Texture width
+    int32_t skinHeight;      // Texture height
+    int32_t numVerts;        // Number of vertices
+    int32_t numTris;         // Number of triangles
+    int32_t numFrames;       // Number of frames
+    int32_t syncType;        // 0 = synchron, 1 = random
+    int32_t flags;           // State flag
+    float size;
+};
+
+struct MDLTexCoord {
+    int32_t onSeam;
+    int32_t s, t;
+};
+
+struct MDLTriangle {
+    int32_t facesFront;      // 0 = backface, 1 = frontface
+    int32_t vertices[3];     // Vertex indices
+};
+
+struct MDLVertex {
+    uint8_t v[3];           // Compressed coordinates
+    uint8_t normalIndex;    // Normal vector index
+};
+
+// Файл .mdl, отображённый в память. Open за один проход проверяет, что все
+// разделы целиком лежат в файле, после чего скины, текстурные координаты,
+// треугольники и кадры доступны указателями прямо в отображение, без копий.
+// Указатели действительны до Close или разрушения объекта.
+class MDLFile {
+public:
+    // Простой кадр: границы, имя и numVerts упакованных вершин
+    struct FrameView {
+        MDLVertex bboxMin;
+        MDLVertex bboxMax;
+        const char* name;            // 16 байт, ноль в конце не гарантирован
+        const MDLVertex* vertices;
+    };
+
+    MDLFile();
+    ~MDLFile();
+
+    MDLFile(const MDLFile&) = delete;
+    MDLFile& operator=(const MDLFile&) = delete;
+
+    bool Open(const std::string& filename);
+    void Close();
+    bool IsOpen() const { return m_file.IsOpen(); }
+    // false - файл прочитан в буфер
+    bool IsMapped() const { return m_file.IsMapped(); }
+    size_t GetSize() const { return m_file.GetSize(); }
+
+    const MDLHeader& GetHeader() const { return m_header; }
+
+    int GetSkinCount() const { return static_cast<int>(m_skinOffsets.size()); }
+    // Индексы палитры, skinWidth * skinHeight байт
+    const uint8_t* GetSkinPixels(int skin) const { return m_file.GetData() + m_skinOffsets[skin]; }
+
+    // numVerts и numTris элементов
+    const MDLTexCoord* GetTexCoords() const { return m_texCoords; }
+    const MDLTriangle* GetTriangles() const { return m_triangles; }
+
+    int GetFrameCount() const { return static_cast<int>(m_frameOffsets.size()); }
+    FrameView GetFrame(int frame) const;
+
+private:
+    bool Validate(const std::string& filename);
+
+    MappedFile m_file;
+
+    MDLHeader m_header;
+    std::vector<size_t> m_skinOffsets;  // Начало пикселей каждого скина
+    std::vector<size_t> m_frameOffsets; // Начало bboxMin каждого кадра
+    const MDLTexCoord* m_texCoords;
+    const MDLTriangle* m_triangles;
+
+    // Копии разделов, не выровненных в файле на 4 байта (скин нечётного размера)
+    std::vector<MDLTexCoord> m_alignedTexCoords;
+    std::vector<MDLTriangle> m_alignedTriangles;
+};
+
+} // namespace Revolt
@@ -0,0 +1,205 @@
+#include "MDLLerp.h"
+#include <cmath>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define REVOLT_LERP_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define REVOLT_LERP_SSE2
+#endif
+
+namespace Revolt {
+
+namespace {
+
+// Ниже этой длины нормаль не нормализуется (встречные нормали при t = 0.5)
+const float MIN_NORMAL_LENGTH_SQ = 1e-12f;
+
+void LerpScalar(const float* from, const float* to, float t, float* out, size_t count) {
+    for (size_t v = 0; v < count; ++v, from += 6, to += 6, out += 6) {
+        for (int k = 0; k < 6; ++k) {
+            out[k] = from[k] + (to[k] - from[k]) * t;
+        }
+        
+        float lengthSq = out[3] * out[3] + out[4] * out[4] + out[5] * out[5];
+        if (lengthSq > MIN_NORMAL_LENGTH_SQ) {
+            float invLength = 1.0f / std::sqrt(lengthSq);
+            out[3] *= invLength;
+            out[4] *= invLength;
+            out[5] *= invLength;
+        }
+    }
+}
+
+// Четыре вершины по 6 float занимают 6 регистров по 4 float:
+//   r0 = p0x p0y p0z n0x    r3 = p2x p2y p2z n2x
+//   r1 = n0y n0z p1x p1y    r4 = n2y n2z p3x p3y
+//   r2 = p1z n1x n1y n1z    r5 = p3z n3x n3y n3z
+// Пары (r0,r3), (r1,r4), (r2,r5) устроены одинаково, поэтому нормали собираются
+// в SoA двумя перестановками, а обратные длины раскладываются обратно масками.
+// _mm256_shuffle_ps работает внутри 128-битных половин, так что AVX-версия
+// обрабатывает две такие четвёрки сразу: младшие половины - вершины 0-3, старшие - 4-7.
+
+#if defined(REVOLT_LERP_AVX2)
+
+inline __m256 Load2x4(const float* low, const float* high) {
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(low)), _mm_loadu_ps(high), 1);
+}
+
+inline void Store2x4(float* low, float* high, __m256 value) {
+    _mm_storeu_ps(low, _mm256_castps256_ps128(value));
+    _mm_storeu_ps(high, _mm256_extractf128_ps(value, 1));
+}
+
+inline __m256 Lerp8(__m256 a, __m256 b, __m256 t) {
+#if defined(__FMA__)
+    return _mm256_fmadd_ps(_mm256_sub_ps(b, a), t, a);
+#else
+    return _mm256_add_ps(a, _mm256_mul_ps(_mm256_sub_ps(b, a), t));
+#endif
+}
+
+inline __m256 Select8(__m256 mask, __m256 a, __m256 b) {
+    return _mm256_blendv_ps(b, a, mask);
+}
+
+size_t LerpAVX2(const float* from, const float* to, float t, float* out, size_t count) {
+    const __m256 vt = _mm256_set1_ps(t);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 minLengthSq = _mm256_set1_ps(MIN_NORMAL_LENGTH_SQ);
+    const __m256 mask0 = _mm256_castsi256_ps(_mm256_setr_epi32(0, 0, 0, -1, 0, 0, 0, -1));
+    const __m256 mask1 = _mm256_castsi256_ps(_mm256_setr_epi32(-1, -1, 0, 0, -1, -1, 0, 0));
+    const __m256 mask2 = _mm256_castsi256_ps(_mm256_setr_epi32(0, -1, -1, -1, 0, -1, -1, -1));
+    
+    size_t blocks = count / 8;
+    for (size_t b = 0; b < blocks; ++b, from += 48, to += 48, out += 48) {
+        __m256 r[6];
+        for (int k = 0; k < 6; ++k) {
+            __m256 a = Load2x4(from + k * 4, from + 24 + k * 4);
+            __m256 c = Load2x4(to + k * 4, to + 24 + k * 4);
+            r[k] = Lerp8(a, c, vt);
+        }
+        
+        __m256 nx = _mm256_shuffle_ps(_mm256_shuffle_ps(r[0], r[2], _MM_SHUFFLE(1, 1, 3, 3)),
+                                      _mm256_shuffle_ps(r[3], r[5], _MM_SHUFFLE(1, 1, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+        __m256 ny = _mm256_shuffle_ps(_mm256_shuffle_ps(r[1], r[2], _MM_SHUFFLE(2, 2, 0, 0)),
+                                      _mm256_shuffle_ps(r[4], r[5], _MM_SHUFFLE(2, 2, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+        __m256 nz = _mm256_shuffle_ps(_mm256_shuffle_ps(r[1], r[2], _MM_SHUFFLE(3, 3, 1, 1)),
+                                      _mm256_shuffle_ps(r[4], r[5], _MM_SHUFFLE(3, 3, 1, 1)), _MM_SHUFFLE(2, 0, 2, 0));
+        
+        __m256 lengthSq = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx, nx), _mm256_mul_ps(ny, ny)), _mm256_mul_ps(nz, nz));
+        __m256 valid = _mm256_cmp_ps(lengthSq, minLengthSq, _CMP_GT_OQ);
+        __m256 inv = Select8(valid, _mm256_div_ps(one, _mm256_sqrt_ps(lengthSq)), one);
+        
+        // inv = s0 s1 s2 s3 в каждой половине
+        __m256 s0 = _mm256_shuffle_ps(inv, inv, _MM_SHUFFLE(0, 0, 0, 0));
+        __m256 s1 = _mm256_shuffle_ps(inv, inv, _MM_SHUFFLE(1, 1, 1, 1));
+        __m256 s2 = _mm256_shuffle_ps(inv, inv, _MM_SHUFFLE(2, 2, 2, 2));
+        __m256 s3 = _mm256_shuffle_ps(inv, inv, _MM_SHUFFLE(3, 3, 3, 3));
+        r[0] = _mm256_mul_ps(r[0], Select8(mask0, s0, one));
+        r[1] = _mm256_mul_ps(r[1], Select8(mask1, s0, one));
+        r[2] = _mm256_mul_ps(r[2], Select8(mask2, s1, one));
+        r[3] = _mm256_mul_ps(r[3], Select8(mask0, s2, one));
+        r[4] = _mm256_mul_ps(r[4], Select8(mask1, s2, one));
+        r[5] = _mm256_mul_ps(r[5], Select8(mask2, s3, one));
+        
+        for (int k = 0; k < 6; ++k) {
+            Store2x4(out + k * 4, out + 24 + k * 4, r[k]);
+        }
+    }
+    return blocks * 8;
+}
+
+#elif defined(REVOLT_LERP_SSE2)
+
+inline __m128 Select4(__m128 mask, __m128 a, __m128 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+size_t LerpSSE2(const float* from, const float* to, float t, float* out, size_t count) {
+    const __m128 vt = _mm_set1_ps(t);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 minLengthSq = _mm_set1_ps(MIN_NORMAL_LENGTH_SQ);
+    const __m128 mask0 = _mm_castsi128_ps(_mm_setr_epi32(0, 0, 0, -1));
+    const __m128 mask1 = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, 0, 0));
+    const __m128 mask2 = _mm_castsi128_ps(_mm_setr_epi32(0, -1, -1, -1));
+    
+    size_t blocks = count / 4;
+    for (size_t b = 0; b < blocks; ++b, from += 24, to += 24, out += 24) {
+        __m128 r[6];
+        for (int k = 0; k < 6; ++k) {
+            __m128 a = _mm_loadu_ps(from + k * 4);
+            __m128 c = _mm_loadu_ps(to + k * 4);
+            r[k] = _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(c, a), vt));
+        }
+        
+        __m128 nx = _mm_shuffle_ps(_mm_shuffle_ps(r[0], r[2], _MM_SHUFFLE(1, 1, 3, 3)),
+                                   _mm_shuffle_ps(r[3], r[5], _MM_SHUFFLE(1, 1, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 ny = _mm_shuffle_ps(_mm_shuffle_ps(r[1], r[2], _MM_SHUFFLE(2, 2, 0, 0)),
+                                   _mm_shuffle_ps(r[4], r[5], _MM_SHUFFLE(2, 2, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 nz = _mm_shuffle_ps(_mm_shuffle_ps(r[1], r[2], _MM_SHUFFLE(3, 3, 1, 1)),
+                                   _mm_shuffle_ps(r[4], r[5], _MM_SHUFFLE(3, 3, 1, 1)), _MM_SHUFFLE(2, 0, 2, 0));
+        
+        __m128 lengthSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, nx), _mm_mul_ps(ny, ny)), _mm_mul_ps(nz, nz));
+        __m128 valid = _mm_cmpgt_ps(lengthSq, minLengthSq);
+        __m128 inv = Select4(valid, _mm_div_ps(one, _mm_sqrt_ps(lengthSq)), one);
+        
+        __m128 s0 = _mm_shuffle_ps(inv, inv, _MM_SHUFFLE(0, 0, 0, 0));
+        __m128 s1 = _mm_shuffle_ps(inv, inv, _MM_SHUFFLE(1, 1, 1, 1));
+        __m128 s2 = _mm_shuffle_ps(inv, inv, _MM_SHUFFLE(2, 2, 2, 2));
+        __m128 s3 = _mm_shuffle_ps(inv, inv, _MM_SHUFFLE(3, 3, 3, 3));
+        r[0] = _mm_mul_ps(r[0], Select4(mask0, s0, one));
+        r[1] = _mm_mul_ps(r[1], Select4(mask1, s0, one));
+        r[2] = _mm_mul_ps(r[2], Select4(mask2, s1, one));
+        r[3] = _mm_mul_ps(r[3], Select4(mask0, s2, one));
+        r[4] = _mm_mul_ps(r[4], Select4(mask1, s2, one));
+        r[5] = _mm_mul_ps(r[5], Select4(mask2, s3, one));
+        
+        for (int k = 0; k < 6; ++k) {
+            _mm_storeu_ps(out + k * 4, r[k]);
+        }
+    }
+    return blocks * 4;
+}
+
+#endif
+
+} // namespace
+
+void LerpFrameVertices(const MDLRenderVertex* from, const MDLRenderVertex* to, float t,
+                       MDLRenderVertex* out, size_t count) {
+    static_assert(sizeof(MDLRenderVertex) == 6 * sizeof(float), "MDLRenderVertex must be 6 packed floats");
+    
+    const float* a = reinterpret_cast<const float*>(from);
+    const float* b = reinterpret_cast<const float*>(to);
+    float* result = reinterpret_cast<float*>(out);
+    size_t done = 0;
+    
+#if defined(REVOLT_LERP_AVX2)
+    done = LerpAVX2(a, b, t, result, count);
+#elif defined(REVOLT_LERP_SSE2)
+    done = LerpSSE2(a, b, t, result, count);
+#endif
+    
+    // Хвост, не кратный ширине вектора
+    LerpScalar(a + done * 6, b + done * 6, t, result + done * 6, count - done);
+}
+
+void LerpFrameVerticesScalar(const MDLRenderVertex* from, const MDLRenderVertex* to, float t,
+                             MDLRenderVertex* out, size_t count) {
+    LerpScalar(reinterpret_cast<const float*>(from), reinterpret_cast<const float*>(to), t,
+               reinterpret_cast<float*>(out), count);
+}
+
+const char* GetLerpKernelName() {
+#if defined(REVOLT_LERP_AVX2)
+    return "AVX2";
+#elif defined(REVOLT_LERP_SSE2)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+} // namespace Revolt
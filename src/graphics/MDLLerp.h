@@ -0,0 +1,21 @@
+#pragma once
+#include "MDLModel.h"
+#include <cstddef>
+
+namespace Revolt {
+
+// Линейная интерполяция двух распакованных кадров:
+// out = from + (to - from) * t для позиций и нормалей, нормали затем нормализуются.
+// Векторная версия выбирается при сборке: AVX2 (REVOLT_ENABLE_AVX2), SSE2 или скалярная.
+// Буферы могут быть не выровнены; out может совпадать с from или to.
+void LerpFrameVertices(const MDLRenderVertex* from, const MDLRenderVertex* to, float t,
+                       MDLRenderVertex* out, size_t count);
+
+// Эталонная скалярная версия (для проверки и сравнения в бенчмарке)
+void LerpFrameVerticesScalar(const MDLRenderVertex* from, const MDLRenderVertex* to, float t,
+                             MDLRenderVertex* out, size_t count);
+
+// "AVX2", "SSE2" или "scalar"
+const char* GetLerpKernelName();
+
+} // namespace Revolt
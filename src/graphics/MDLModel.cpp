@@ -1,255 +1,691 @@
 #include "MDLModel.h"
+#include "GLExtensions.h"
+#include "GLState.h"
+#include "MDLLerp.h"
+#include "../core/Log.h"
 #include <iostream>
 #include <fstream>
+#include <unordered_map>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
 #include <GLFW/glfw3.h>
 
 namespace Revolt {
 
-MDLModel::MDLModel() : m_currentSkin(0) {
+constexpr unsigned int MDLModel::PACKED_FRAME1_ATTRIB;
+constexpr unsigned int MDLModel::PACKED_FRAME2_ATTRIB;
+
+MDLPose::MDLPose() 
+    : m_vertexBuffer(0), m_bufferCapacity(0), m_model(nullptr), m_frame1(-1), m_frame2(-1), m_interp(0.0f) {
+}
+
+MDLPose::~MDLPose() {
+    if (m_vertexBuffer && glfwGetCurrentContext()) {
+        GLExtensions::DeleteBuffers(1, &m_vertexBuffer);
+    }
+}
+
+MDLModel::MDLModel() 
+    : m_renderVertexCount(0), m_frameBuffer(0), m_texCoordBuffer(0), m_indexBuffer(0), m_packedBuffer(0), 
+      m_currentSkin(0), m_skinIndexed(false) {
+    static std::atomic<uint32_t> nextResourceID(1);
+    m_resourceID = nextResourceID.fetch_add(1, std::memory_order_relaxed);
     InitializeNormals();
 }
 
 MDLModel::~MDLModel() {
     // Clean up OpenGL textures
     for (unsigned int texID : m_textureIDs) {
-        glDeleteTextures(1, &texID);
+        GLState::DeleteTextures(1, &texID);
     }
+    ReleaseBuffers();
 }
 
-bool MDLModel::LoadFromFile(const std::string& filename) {
-    FILE* fp = fopen(filename.c_str(), "rb");
-    if (!fp) {
-        std::cerr << "Failed to open MDL file: " << filename << std::endl;
+void MDLModel::ReleaseBuffers() {
+    // Модели живут в кэше ResourceManager и могут пережить контекст
+    if (!glfwGetCurrentContext() || !m_frameBuffer) {
+        return;
+    }
+    
+    GLExtensions::DeleteBuffers(1, &m_frameBuffer);
+    GLExtensions::DeleteBuffers(1, &m_texCoordBuffer);
+    GLExtensions::DeleteBuffers(1, &m_indexBuffer);
+    if (m_packedBuffer) {
+        GLExtensions::DeleteBuffers(1, &m_packedBuffer);
+    }
+    m_frameBuffer = m_texCoordBuffer = m_indexBuffer = m_packedBuffer = 0;
+}
+
+bool MDLModel::LoadFromFile(const std::string& filename, TextureAtlas* atlas) {
+    if (!ParseFile(filename)) {
         return false;
     }
     
-    // Read all sections
-    bool success = ReadHeader(fp) && 
-                  ReadSkins(fp) && 
-                  ReadTexCoords(fp) && 
-                  ReadTriangles(fp) && 
-                  ReadFrames(fp);
+    if (atlas) {
+        AddSkinsToAtlas(*atlas);
+    }
+    CreateGPUResources();
     
-    fclose(fp);
+    REVOLT_LOG(Info, Resources, "Loaded MDL model: %s (%d vertices, %d triangles, %d frames, %d skins, %d render vertices)",
+               filename.c_str(), m_header.numVerts, m_header.numTris, m_header.numFrames, m_header.numSkins,
+               m_renderVertexCount);
     
-    if (success) {
-        std::cout << "Loaded MDL model: " << filename << std::endl;
-        std::cout << "  Vertices: " << m_header.numVerts << std::endl;
-        std::cout << "  Triangles: " << m_header.numTris << std::endl;
-        std::cout << "  Frames: " << m_header.numFrames << std::endl;
-        std::cout << "  Skins: " << m_header.numSkins << std::endl;
+    return true;
+}
+
+bool MDLModel::ParseFile(const std::string& filename) {
+    m_cookedFile.Close();
+    m_skinPixels.clear();
+    m_skinRGBA.clear();
+    if (!m_file.Open(filename)) {
+        return false;
     }
     
-    return success;
+    m_header = m_file.GetHeader();
+    for (int skin = 0; skin < m_file.GetSkinCount(); ++skin) {
+        m_skinPixels.push_back(m_file.GetSkinPixels(skin));
+    }
+    BuildRenderData();
+    return true;
 }
 
-bool MDLModel::ReadHeader(FILE* fp) {
-    if (fread(&m_header, sizeof(MDLHeader), 1, fp) != 1) {
+bool MDLModel::LoadCooked(const std::string& filename) {
+    m_file.Close();
+    m_skinPixels.clear();
+    m_skinRGBA.clear();
+    if (!m_cookedFile.Open(filename)) {
         return false;
     }
     
-    // Check magic number and version
-    if (m_header.ident != 1330660425) { // "IDPO"
-        std::cerr << "Invalid MDL file (bad magic number)" << std::endl;
-        return false;
+    const uint8_t* data = m_cookedFile.GetData();
+    Cooked::ModelHeader header;
+    bool valid = m_cookedFile.Contains(0, sizeof(header));
+    if (valid) {
+        std::memcpy(&header, data, sizeof(header));
+        valid = header.file.magic == Cooked::MODEL_MAGIC && header.file.version == Cooked::MODEL_VERSION &&
+                header.renderVertexCount >= 0 && header.indexCount >= 0 && header.frameCount >= 0 &&
+                header.skinCount >= 0 && header.mdl.skinWidth > 0 && header.mdl.skinHeight > 0;
+    }
+    
+    // Разделы должны целиком лежать в файле и быть выровнены, иначе их нельзя читать на месте
+    const uint64_t vertexCount = valid ? static_cast<uint64_t>(header.renderVertexCount) : 0;
+    const uint64_t frameCount = valid ? static_cast<uint64_t>(header.frameCount) : 0;
+    // Скины занимают пять байт на пиксель (индексы и RGBA). Число скинов
+    // сверяется с размером файла делением, иначе произведение может переполниться
+    const uint64_t skinSize = valid ? static_cast<uint64_t>(header.mdl.skinWidth) * header.mdl.skinHeight : 0;
+    valid = valid && (header.skinCount == 0 || static_cast<uint64_t>(header.skinCount) <= m_cookedFile.GetSize() / skinSize / 5);
+    const uint64_t skinBytes = valid ? static_cast<uint64_t>(header.skinCount) * skinSize : 0;
+    const struct { uint64_t offset; uint64_t size; } sections[] = {
+        { valid ? header.texCoordOffset : 0, vertexCount * 2 * sizeof(float) },
+        { valid ? header.indexOffset : 0, static_cast<uint64_t>(valid ? header.indexCount : 0) * sizeof(uint32_t) },
+        { valid ? header.frameOffset : 0, frameCount * vertexCount * sizeof(MDLVertex) },
+        { valid ? header.boundsOffset : 0, frameCount * 6 * sizeof(float) },
+        { valid ? header.skinOffset : 0, skinBytes },
+        { valid ? header.skinRGBAOffset : 0, skinBytes * 4 },
+    };
+    for (const auto& section : sections) {
+        valid = valid && section.offset % Cooked::SECTION_ALIGNMENT == 0 && m_cookedFile.Contains(section.offset, section.size);
+    }
+    
+    const uint32_t* indices = valid ? reinterpret_cast<const uint32_t*>(data + header.indexOffset) : nullptr;
+    for (int i = 0; valid && i < header.indexCount; ++i) {
+        valid = indices[i] < vertexCount;
     }
     
-    if (m_header.version != 6) {
-        std::cerr << "Unsupported MDL version: " << m_header.version << std::endl;
+    if (!valid) {
+        std::cerr << "Invalid cooked MDL file: " << filename << std::endl;
+        m_cookedFile.Close();
         return false;
     }
     
+    m_header = header.mdl;
+    m_renderVertexCount = header.renderVertexCount;
+    m_renderVertexSource.clear();
+    
+    const float* texCoords = reinterpret_cast<const float*>(data + header.texCoordOffset);
+    m_renderTexCoords.assign(texCoords, texCoords + vertexCount * 2);
+    m_renderIndices.assign(indices, indices + header.indexCount);
+    
+    const MDLVertex* frames = reinterpret_cast<const MDLVertex*>(data + header.frameOffset);
+    m_packedFrameVertices.assign(frames, frames + frameCount * vertexCount);
+    
+    const float* bounds = reinterpret_cast<const float*>(data + header.boundsOffset);
+    m_frameBounds.resize(frameCount);
+    m_bounds = BoundingBox();
+    for (size_t f = 0; f < frameCount; ++f) {
+        m_frameBounds[f] = BoundingBox(bounds[f * 6 + 0], bounds[f * 6 + 1], bounds[f * 6 + 2],
+                                       bounds[f * 6 + 3], bounds[f * 6 + 4], bounds[f * 6 + 5]);
+        m_bounds.Expand(m_frameBounds[f]);
+    }
+    
+    for (int skin = 0; skin < header.skinCount; ++skin) {
+        m_skinPixels.push_back(data + header.skinOffset + skin * skinSize);
+        m_skinRGBA.push_back(data + header.skinRGBAOffset + skin * skinSize * 4);
+    }
+    
+    m_frameVertices.resize(frameCount * vertexCount);
+    for (size_t f = 0; f < frameCount; ++f) {
+        DecodeFrame(static_cast<int>(f), &m_frameVertices[f * vertexCount]);
+    }
     return true;
 }
 
-bool MDLModel::ReadSkins(FILE* fp) {
-    m_skins.resize(m_header.numSkins);
-    m_textureIDs.resize(m_header.numSkins);
+bool MDLModel::Cook(const Cooked::SourceStamp& source, std::vector<uint8_t>& out) const {
+    if (m_frameBounds.empty() && m_renderIndices.empty()) {
+        return false;
+    }
     
-    for (int i = 0; i < m_header.numSkins; ++i) {
-        MDLSkin& skin = m_skins[i];
-        
-        // Read skin group
-        if (fread(&skin.group, sizeof(int32_t), 1, fp) != 1) {
-            return false;
-        }
-        
-        // For now, we only handle single skins (not groups)
-        if (skin.group != 0) {
-            std::cerr << "Group skins not supported yet" << std::endl;
-            return false;
-        }
-        
-        // Read skin data
-        int skinSize = m_header.skinWidth * m_header.skinHeight;
-        skin.data.resize(skinSize);
-        
-        if (fread(skin.data.data(), sizeof(uint8_t), skinSize, fp) != skinSize) {
-            return false;
-        }
-        
-        // Create OpenGL texture
-        m_textureIDs[i] = CreateTextureFromSkin(skin);
+    Cooked::ModelHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.file.magic = Cooked::MODEL_MAGIC;
+    header.file.version = Cooked::MODEL_VERSION;
+    header.file.source = source;
+    header.mdl = m_header;
+    header.renderVertexCount = m_renderVertexCount;
+    header.indexCount = static_cast<int32_t>(m_renderIndices.size());
+    header.frameCount = static_cast<int32_t>(m_frameBounds.size());
+    header.skinCount = static_cast<int32_t>(m_skinPixels.size());
+    
+    out.clear();
+    Cooked::AppendSection(out, &header, sizeof(header));
+    
+    static_assert(sizeof(unsigned int) == sizeof(uint32_t), "Cooked indices are 32-bit");
+    header.texCoordOffset = Cooked::AppendSection(out, m_renderTexCoords.data(), m_renderTexCoords.size() * sizeof(float));
+    header.indexOffset = Cooked::AppendSection(out, m_renderIndices.data(), m_renderIndices.size() * sizeof(uint32_t));
+    header.frameOffset = Cooked::AppendSection(out, m_packedFrameVertices.data(), m_packedFrameVertices.size() * sizeof(MDLVertex));
+    
+    std::vector<float> bounds;
+    bounds.reserve(m_frameBounds.size() * 6);
+    for (const BoundingBox& frameBounds : m_frameBounds) {
+        bounds.insert(bounds.end(), frameBounds.min, frameBounds.min + 3);
+        bounds.insert(bounds.end(), frameBounds.max, frameBounds.max + 3);
+    }
+    header.boundsOffset = Cooked::AppendSection(out, bounds.data(), bounds.size() * sizeof(float));
+    
+    const size_t skinSize = static_cast<size_t>(m_header.skinWidth) * m_header.skinHeight;
+    std::vector<unsigned char> skins(m_skinPixels.size() * skinSize);
+    for (size_t skin = 0; skin < m_skinPixels.size(); ++skin) {
+        std::memcpy(&skins[skin * skinSize], m_skinPixels[skin], skinSize);
     }
+    header.skinOffset = Cooked::AppendSection(out, skins.data(), skins.size());
     
+    skins.resize(m_skinPixels.size() * skinSize * 4);
+    for (size_t skin = 0; skin < m_skinPixels.size(); ++skin) {
+        ExpandPaletteToRGBA(m_skinPixels[skin], skinSize, &skins[skin * skinSize * 4]);
+    }
+    header.skinRGBAOffset = Cooked::AppendSection(out, skins.data(), skins.size());
+    
+    std::memcpy(out.data(), &header, sizeof(header));
     return true;
 }
 
-bool MDLModel::ReadTexCoords(FILE* fp) {
-    m_texCoords.resize(m_header.numVerts);
-    return fread(m_texCoords.data(), sizeof(MDLTexCoord), m_header.numVerts, fp) == m_header.numVerts;
-}
-
-bool MDLModel::ReadTriangles(FILE* fp) {
-    m_triangles.resize(m_header.numTris);
-    return fread(m_triangles.data(), sizeof(MDLTriangle), m_header.numTris, fp) == m_header.numTris;
-}
-
-bool MDLModel::ReadFrames(FILE* fp) {
-    m_frames.resize(m_header.numFrames);
+bool MDLModel::AddSkinsToAtlas(TextureAtlas& atlas) {
+    if (!m_skinRegions.empty() || !m_textureIDs.empty() || m_skinPixels.empty()) {
+        return !m_skinRegions.empty();
+    }
     
-    for (int i = 0; i < m_header.numFrames; ++i) {
-        MDLFrame& frame = m_frames[i];
-        
-        // Read frame type
-        if (fread(&frame.type, sizeof(int32_t), 1, fp) != 1) {
-            return false;
-        }
-        
-        // For now, we only handle simple frames
-        if (frame.type != 0) {
-            std::cerr << "Group frames not supported yet" << std::endl;
-            return false;
-        }
-        
-        // Read bounding box
-        if (fread(&frame.frame.bboxMin, sizeof(MDLVertex), 1, fp) != 1 ||
-            fread(&frame.frame.bboxMax, sizeof(MDLVertex), 1, fp) != 1) {
-            return false;
-        }
-        
-        // Read frame name
-        if (fread(frame.frame.name, sizeof(char), 16, fp) != 16) {
-            return false;
+    // Формат скинов следует за атласом, в том числе если придётся остаться на своих текстурах
+    m_skinIndexed = atlas.GetFormat() == TextureAtlas::Format::Indexed;
+    
+    std::vector<unsigned char> rgba;
+    for (size_t skin = 0; skin < m_skinPixels.size(); ++skin) {
+        const unsigned char* pixels = m_skinPixels[skin];
+        if (!m_skinIndexed && !m_skinRGBA.empty()) {
+            pixels = m_skinRGBA[skin];
+        } else if (!m_skinIndexed) {
+            ConvertSkinToRGBA(pixels, rgba);
+            pixels = rgba.data();
         }
         
-        // Read vertices
-        frame.frame.vertices.resize(m_header.numVerts);
-        if (fread(frame.frame.vertices.data(), sizeof(MDLVertex), m_header.numVerts, fp) != m_header.numVerts) {
+        AtlasRegion region;
+        if (!atlas.Add(m_header.skinWidth, m_header.skinHeight, pixels, region)) {
+            // Скин больше страницы - остаёмся на собственных текстурах
+            // (уже добавленные скины занимают место в атласе до конца работы)
+            std::cerr << "MDL skin " << m_header.skinWidth << "x" << m_header.skinHeight 
+                      << " does not fit the texture atlas" << std::endl;
+            m_skinRegions.clear();
             return false;
         }
+        m_skinRegions.push_back(region);
+    }
+    
+    // Координаты уже учитывают сдвиг на полширины для задней стороны шва,
+    // поэтому достаточно линейного отображения в прямоугольник скина
+    const AtlasRegion& region = m_skinRegions[GetTextureIndex()];
+    for (size_t i = 0; i + 1 < m_renderTexCoords.size(); i += 2) {
+        region.Map(m_renderTexCoords[i], m_renderTexCoords[i + 1]);
+    }
+    
+    if (m_texCoordBuffer) {
+        GLExtensions::BindBuffer(GL_ARRAY_BUFFER, m_texCoordBuffer);
+        GLExtensions::BufferSubData(GL_ARRAY_BUFFER, 0, m_renderTexCoords.size() * sizeof(float), m_renderTexCoords.data());
+        GLExtensions::BindBuffer(GL_ARRAY_BUFFER, 0);
     }
     
     return true;
 }
 
+void MDLModel::CreateGPUResources() {
+    if (m_textureIDs.empty() && m_skinRegions.empty()) {
+        m_textureIDs.reserve(m_skinPixels.size());
+        for (int skin = 0; skin < GetSkinCount(); ++skin) {
+            m_textureIDs.push_back(CreateTextureFromSkin(skin));
+        }
+    }
+    
+    if (!m_frameBuffer) {
+        UploadBuffers();
+    }
+}
+
 void MDLModel::ConvertVertex(const MDLVertex& vertex, float result[3]) const {
     for (int i = 0; i < 3; ++i) {
         result[i] = (m_header.scale[i] * vertex.v[i]) + m_header.translate[i];
     }
 }
 
-void MDLModel::Render(int frame) {
-    if (frame < 0 || frame >= static_cast<int>(m_frames.size())) {
-        frame = 0;
-    }
-    
-    // Проверяем, что у нас есть данные для рендеринга
-    if (m_frames.empty() || m_triangles.empty() || m_texCoords.empty()) {
-        return;
-    }
-    
-    const MDLFrame& mdlFrame = m_frames[frame];
+void MDLModel::BuildRenderData() {
+    m_renderVertexSource.clear();
+    m_renderTexCoords.clear();
+    m_renderIndices.clear();
+    m_frameVertices.clear();
+    m_packedFrameVertices.clear();
     
-    // ВКЛЮЧАЕМ blending для прозрачности
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    
-    // Bind texture
-    if (!m_textureIDs.empty() && m_currentSkin >= 0 && m_currentSkin < static_cast<int>(m_textureIDs.size())) {
-        glBindTexture(GL_TEXTURE_2D, m_textureIDs[m_currentSkin]);
-        glEnable(GL_TEXTURE_2D);
-    } else {
-        glDisable(GL_BLEND);
-        glDisable(GL_TEXTURE_2D);
-    }
+    const MDLTexCoord* texCoords = m_file.GetTexCoords();
+    const MDLTriangle* triangles = m_file.GetTriangles();
+    const int triangleCount = m_header.numTris;
     
-    // Render triangles
-    glBegin(GL_TRIANGLES);
+    // Ключ: исходная вершина * 2 + признак "задняя грань на шве"
+    std::unordered_map<int, unsigned int> remap;
+    m_renderIndices.reserve(static_cast<size_t>(triangleCount) * 3);
+    int droppedTriangles = 0;
     
-    for (const MDLTriangle& tri : m_triangles) {
+    for (int i = 0; i < triangleCount; ++i) {
+        const MDLTriangle& tri = triangles[i];
+        
+        // Индексы проверяются один раз при загрузке, а не при каждом рендеринге
+        if (tri.vertices[0] < 0 || tri.vertices[0] >= m_header.numVerts ||
+            tri.vertices[1] < 0 || tri.vertices[1] >= m_header.numVerts ||
+            tri.vertices[2] < 0 || tri.vertices[2] >= m_header.numVerts) {
+            ++droppedTriangles;
+            continue;
+        }
+        
         for (int j = 0; j < 3; ++j) {
             int vertexIndex = tri.vertices[j];
-            if (vertexIndex < 0 || vertexIndex >= static_cast<int>(mdlFrame.frame.vertices.size()) ||
-                vertexIndex >= static_cast<int>(m_texCoords.size())) {
+            const MDLTexCoord& texCoord = texCoords[vertexIndex];
+            bool backSeam = !tri.facesFront && texCoord.onSeam;
+            int key = vertexIndex * 2 + (backSeam ? 1 : 0);
+            
+            auto it = remap.find(key);
+            if (it != remap.end()) {
+                m_renderIndices.push_back(it->second);
                 continue;
             }
             
-            const MDLVertex& vertex = mdlFrame.frame.vertices[vertexIndex];
-            const MDLTexCoord& texCoord = m_texCoords[vertexIndex];
+            unsigned int renderIndex = static_cast<unsigned int>(m_renderVertexSource.size());
+            remap[key] = renderIndex;
+            m_renderVertexSource.push_back(vertexIndex);
+            m_renderIndices.push_back(renderIndex);
             
             // Calculate texture coordinates
             float s = static_cast<float>(texCoord.s);
             float t = static_cast<float>(texCoord.t);
             
             // Adjust for backface if needed
-            if (!tri.facesFront && texCoord.onSeam) {
+            if (backSeam) {
                 s += m_header.skinWidth * 0.5f;
             }
             
             // Normalize texture coordinates
-            s = (s + 0.5f) / m_header.skinWidth;
-            t = (t + 0.5f) / m_header.skinHeight;
-            
-            glTexCoord2f(s, t);
-            
-            // Set normal
-            int normalIndex = vertex.normalIndex;
-            if (normalIndex >= 0 && normalIndex < NUM_NORMALS) {
-                glNormal3fv(m_normals[normalIndex]);
-            }
-            
-            // Calculate and set vertex position
-            float pos[3];
-            ConvertVertex(vertex, pos);
-            glVertex3fv(pos);
+            m_renderTexCoords.push_back((s + 0.5f) / m_header.skinWidth);
+            m_renderTexCoords.push_back((t + 0.5f) / m_header.skinHeight);
         }
     }
     
-    glEnd();
+    if (droppedTriangles > 0) {
+        std::cerr << "MDL: dropped " << droppedTriangles 
+                  << " triangles with out of range vertex indices" << std::endl;
+    }
+    
+    m_renderVertexCount = static_cast<int>(m_renderVertexSource.size());
+    
+    // Распаковываем позиции и нормали всех кадров прямо из файла
+    const size_t frameCount = static_cast<size_t>(m_file.GetFrameCount());
+    m_frameVertices.resize(frameCount * m_renderVertexCount);
+    m_packedFrameVertices.resize(frameCount * m_renderVertexCount);
+    m_frameBounds.resize(frameCount);
+    m_bounds = BoundingBox();
+    for (size_t f = 0; f < frameCount; ++f) {
+        MDLFile::FrameView frame = m_file.GetFrame(static_cast<int>(f));
+        const MDLVertex* vertices = frame.vertices;
+        
+        BoundingBox& bounds = m_frameBounds[f];
+        ConvertVertex(frame.bboxMin, bounds.min);
+        ConvertVertex(frame.bboxMax, bounds.max);
+        m_bounds.Expand(bounds);
+        
+        MDLVertex* packed = &m_packedFrameVertices[f * m_renderVertexCount];
+        for (int v = 0; v < m_renderVertexCount; ++v) {
+            packed[v] = vertices[m_renderVertexSource[v]];
+        }
+        DecodeFrame(static_cast<int>(f), &m_frameVertices[f * m_renderVertexCount]);
+    }
+}
+
+void MDLModel::DecodeFrame(int frame, MDLRenderVertex* out) const {
+    static const float defaultNormal[3] = {0.0f, 0.0f, 1.0f};
+    const MDLVertex* packed = &m_packedFrameVertices[static_cast<size_t>(ClampFrame(frame)) * m_renderVertexCount];
+    
+    for (int v = 0; v < m_renderVertexCount; ++v) {
+        const MDLVertex& vertex = packed[v];
+        ConvertVertex(vertex, out[v].position);
+        
+        const float* normal = vertex.normalIndex < NUM_NORMALS ? m_normals[vertex.normalIndex] : defaultNormal;
+        out[v].normal[0] = normal[0];
+        out[v].normal[1] = normal[1];
+        out[v].normal[2] = normal[2];
+    }
+}
+
+void MDLModel::UploadBuffers() {
+    if (!GLExtensions::HasVertexBufferObject() || m_renderIndices.empty()) {
+        return;
+    }
+    
+    GLExtensions::GenBuffers(1, &m_frameBuffer);
+    GLExtensions::BindBuffer(GL_ARRAY_BUFFER, m_frameBuffer);
+    GLExtensions::BufferData(GL_ARRAY_BUFFER, m_frameVertices.size() * sizeof(MDLRenderVertex), 
+                             m_frameVertices.data(), GL_STATIC_DRAW);
+    
+    GLExtensions::GenBuffers(1, &m_texCoordBuffer);
+    GLExtensions::BindBuffer(GL_ARRAY_BUFFER, m_texCoordBuffer);
+    GLExtensions::BufferData(GL_ARRAY_BUFFER, m_renderTexCoords.size() * sizeof(float), 
+                             m_renderTexCoords.data(), GL_STATIC_DRAW);
+    GLExtensions::BindBuffer(GL_ARRAY_BUFFER, 0);
+    
+    GLExtensions::GenBuffers(1, &m_indexBuffer);
+    GLExtensions::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+    GLExtensions::BufferData(GL_ELEMENT_ARRAY_BUFFER, m_renderIndices.size() * sizeof(unsigned int), 
+                             m_renderIndices.data(), GL_STATIC_DRAW);
+    GLExtensions::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    
+    // Упакованные кадры нужны только шейдерному пути
+    if (GLExtensions::HasShaders()) {
+        GLExtensions::GenBuffers(1, &m_packedBuffer);
+        GLExtensions::BindBuffer(GL_ARRAY_BUFFER, m_packedBuffer);
+        GLExtensions::BufferData(GL_ARRAY_BUFFER, m_packedFrameVertices.size() * sizeof(MDLVertex), 
+                                 m_packedFrameVertices.data(), GL_STATIC_DRAW);
+        GLExtensions::BindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+}
+
+void MDLModel::Render(int frame) {
+    // Проверяем, что у нас есть данные для рендеринга
+    if (m_frameBounds.empty() || m_renderIndices.empty()) {
+        return;
+    }
+    
+    // ВКЛЮЧАЕМ blending для прозрачности
+    GLState::Enable(GL_BLEND);
+    GLState::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    
+    // Bind texture
+    unsigned int textureID = GetTextureID();
+    if (textureID) {
+        GLState::BindTexture(textureID);
+        GLState::Enable(GL_TEXTURE_2D);
+    } else {
+        GLState::Disable(GL_BLEND);
+        GLState::Disable(GL_TEXTURE_2D);
+    }
+    
+    Draw(frame);
     
     // Отключаем текстурирование
-    glDisable(GL_TEXTURE_2D);
+    GLState::Disable(GL_TEXTURE_2D);
+}
+
+const BoundingBox& MDLModel::GetBounds(int frame) const {
+    if (frame < 0 || frame >= static_cast<int>(m_frameBounds.size())) {
+        return m_bounds;
+    }
+    return m_frameBounds[frame];
+}
+
+int MDLModel::GetTextureIndex() const {
+    int count = static_cast<int>(m_skinRegions.empty() ? m_textureIDs.size() : m_skinRegions.size());
+    return (m_currentSkin >= 0 && m_currentSkin < count) ? m_currentSkin : 0;
+}
+
+unsigned int MDLModel::GetTextureID() const {
+    if (!m_skinRegions.empty()) {
+        return m_skinRegions[GetTextureIndex()].textureID;
+    }
+    if (m_currentSkin >= 0 && m_currentSkin < static_cast<int>(m_textureIDs.size())) {
+        return m_textureIDs[m_currentSkin];
+    }
+    return 0;
+}
+
+void MDLModel::Draw(int frame) const {
+    if (m_frameBounds.empty() || m_renderIndices.empty()) {
+        return;
+    }
+    
+    const void* indices = BindArrays(frame);
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(m_renderIndices.size()), GL_UNSIGNED_INT, indices);
+    UnbindArrays();
 }
 
-unsigned int MDLModel::CreateTextureFromSkin(const MDLSkin& skin) {
-    unsigned char palette[256][3];
-    LoadPalette(palette); // Используем палитру
+void MDLModel::DrawInstanced(int frame, int instanceCount) const {
+    if (m_frameBounds.empty() || m_renderIndices.empty() || instanceCount <= 0) {
+        return;
+    }
     
-    // Convert 8-bit indexed to RGBA
-    std::vector<unsigned char> rgbData(m_header.skinWidth * m_header.skinHeight * 4);
+    const void* indices = BindArrays(frame);
+    GLExtensions::DrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(m_renderIndices.size()), 
+                                        GL_UNSIGNED_INT, indices, instanceCount);
+    UnbindArrays();
+}
+
+void MDLModel::RenderInterpolated(int frame1, int frame2, float interp) {
+    if (m_frameBounds.empty() || m_renderIndices.empty()) {
+        return;
+    }
     
-    for (int i = 0; i < m_header.skinWidth * m_header.skinHeight; ++i) {
-        int paletteIndex = skin.data[i];
-        
-        // Прозрачные пиксели (индекс 255)
-        if (paletteIndex == 255) {
-            rgbData[i * 4 + 0] = 0;
-            rgbData[i * 4 + 1] = 0;
-            rgbData[i * 4 + 2] = 0;
-            rgbData[i * 4 + 3] = 0; // Полная прозрачность
+    Interpolate(m_scratchPose, frame1, frame2, interp);
+    
+    // Состояние как в Render
+    unsigned int textureID = GetTextureID();
+    if (textureID) {
+        GLState::Enable(GL_BLEND);
+        GLState::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        GLState::BindTexture(textureID);
+        GLState::Enable(GL_TEXTURE_2D);
+    } else {
+        GLState::Disable(GL_BLEND);
+        GLState::Disable(GL_TEXTURE_2D);
+    }
+    
+    DrawPose(m_scratchPose);
+    
+    GLState::Disable(GL_TEXTURE_2D);
+}
+
+void MDLModel::Interpolate(MDLPose& pose, int frame1, int frame2, float interp) const {
+    if (m_frameBounds.empty()) {
+        return;
+    }
+    
+    frame1 = ClampFrame(frame1);
+    frame2 = ClampFrame(frame2);
+    if (interp < 0.0f) interp = 0.0f;
+    if (interp > 1.0f) interp = 1.0f;
+    
+    // Объект, стоящий на месте или анимирующийся медленнее кадра, не пересчитываем
+    if (pose.m_model == this && pose.m_frame1 == frame1 && pose.m_frame2 == frame2 && pose.m_interp == interp) {
+        return;
+    }
+    
+    size_t count = static_cast<size_t>(m_renderVertexCount);
+    pose.m_vertices.resize(count);
+    LerpFrameVertices(GetFrameVertices(frame1), GetFrameVertices(frame2), interp, pose.m_vertices.data(), count);
+    
+    if (m_frameBuffer) {
+        if (!pose.m_vertexBuffer) {
+            GLExtensions::GenBuffers(1, &pose.m_vertexBuffer);
+        }
+        GLExtensions::BindBuffer(GL_ARRAY_BUFFER, pose.m_vertexBuffer);
+        if (pose.m_bufferCapacity != count) {
+            GLExtensions::BufferData(GL_ARRAY_BUFFER, count * sizeof(MDLRenderVertex), pose.m_vertices.data(), GL_STREAM_DRAW);
+            pose.m_bufferCapacity = count;
         } else {
-            rgbData[i * 4 + 0] = palette[paletteIndex][0];
-            rgbData[i * 4 + 1] = palette[paletteIndex][1];
-            rgbData[i * 4 + 2] = palette[paletteIndex][2];
-            rgbData[i * 4 + 3] = 255; // Полная непрозрачность
+            GLExtensions::BufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(MDLRenderVertex), pose.m_vertices.data());
         }
+        GLExtensions::BindBuffer(GL_ARRAY_BUFFER, 0);
     }
     
-    // Create OpenGL texture
+    pose.m_model = this;
+    pose.m_frame1 = frame1;
+    pose.m_frame2 = frame2;
+    pose.m_interp = interp;
+}
+
+void MDLModel::DrawPose(const MDLPose& pose) const {
+    if (pose.m_model != this || m_renderIndices.empty()) {
+        return;
+    }
+    
+    const void* indices = nullptr;
+    if (m_frameBuffer && pose.m_vertexBuffer) {
+        indices = BindArrays(pose.m_vertexBuffer, nullptr);
+    } else if (!m_frameBuffer) {
+        indices = BindArrays(0, reinterpret_cast<const char*>(pose.m_vertices.data()));
+    } else {
+        return;
+    }
+    
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(m_renderIndices.size()), GL_UNSIGNED_INT, indices);
+    UnbindArrays();
+}
+
+void MDLModel::DrawPacked(int frame1, int frame2) const {
+    if (!m_packedBuffer || m_renderIndices.empty()) {
+        return;
+    }
+    
+    static_assert(sizeof(MDLVertex) == 4, "MDLVertex must be 4 packed bytes");
+    const size_t frameSize = static_cast<size_t>(m_renderVertexCount) * sizeof(MDLVertex);
+    const char* base = nullptr;
+    
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    GLExtensions::BindBuffer(GL_ARRAY_BUFFER, m_texCoordBuffer);
+    glTexCoordPointer(2, GL_FLOAT, 0, nullptr);
+    
+    // x, y, z, индекс нормали - целые 0..255 без нормализации
+    GLExtensions::BindBuffer(GL_ARRAY_BUFFER, m_packedBuffer);
+    GLExtensions::VertexAttribPointer(PACKED_FRAME1_ATTRIB, 4, GL_UNSIGNED_BYTE, GL_FALSE, sizeof(MDLVertex), 
+                                      base + ClampFrame(frame1) * frameSize);
+    GLExtensions::VertexAttribPointer(PACKED_FRAME2_ATTRIB, 4, GL_UNSIGNED_BYTE, GL_FALSE, sizeof(MDLVertex), 
+                                      base + ClampFrame(frame2) * frameSize);
+    GLExtensions::EnableVertexAttribArray(PACKED_FRAME1_ATTRIB);
+    GLExtensions::EnableVertexAttribArray(PACKED_FRAME2_ATTRIB);
+    
+    GLExtensions::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(m_renderIndices.size()), GL_UNSIGNED_INT, nullptr);
+    
+    GLExtensions::DisableVertexAttribArray(PACKED_FRAME2_ATTRIB);
+    GLExtensions::DisableVertexAttribArray(PACKED_FRAME1_ATTRIB);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    GLExtensions::BindBuffer(GL_ARRAY_BUFFER, 0);
+    GLExtensions::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+const MDLRenderVertex* MDLModel::GetFrameVertices(int frame) const {
+    if (m_frameVertices.empty()) {
+        return nullptr;
+    }
+    return &m_frameVertices[static_cast<size_t>(ClampFrame(frame)) * m_renderVertexCount];
+}
+
+int MDLModel::ClampFrame(int frame) const {
+    if (frame < 0 || frame >= static_cast<int>(m_frameBounds.size())) {
+        return 0;
+    }
+    return frame;
+}
+
+const void* MDLModel::BindArrays(int frame) const {
+    // Кадр - просто смещение в общем буфере всех кадров
+    size_t frameOffset = static_cast<size_t>(ClampFrame(frame)) * m_renderVertexCount * sizeof(MDLRenderVertex);
+    if (m_frameBuffer) {
+        const char* frameBase = nullptr;
+        return BindArrays(m_frameBuffer, frameBase + frameOffset);
+    }
+    return BindArrays(0, reinterpret_cast<const char*>(m_frameVertices.data()) + frameOffset);
+}
+
+const void* MDLModel::BindArrays(unsigned int vertexBuffer, const char* vertexBase) const {
+    const char* texCoordBase = nullptr;
+    const void* indices = nullptr;
+    if (!m_frameBuffer) {
+        texCoordBase = reinterpret_cast<const char*>(m_renderTexCoords.data());
+        indices = m_renderIndices.data();
+    }
+    
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_NORMAL_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    
+    if (m_frameBuffer) {
+        GLExtensions::BindBuffer(GL_ARRAY_BUFFER, m_texCoordBuffer);
+    }
+    glTexCoordPointer(2, GL_FLOAT, 0, texCoordBase);
+    
+    if (m_frameBuffer) {
+        GLExtensions::BindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+        GLExtensions::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+    }
+    glVertexPointer(3, GL_FLOAT, sizeof(MDLRenderVertex), vertexBase + offsetof(MDLRenderVertex, position));
+    glNormalPointer(GL_FLOAT, sizeof(MDLRenderVertex), vertexBase + offsetof(MDLRenderVertex, normal));
+    
+    return indices;
+}
+
+void MDLModel::UnbindArrays() const {
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_NORMAL_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    
+    if (m_frameBuffer) {
+        GLExtensions::BindBuffer(GL_ARRAY_BUFFER, 0);
+        GLExtensions::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
+}
+
+unsigned int MDLModel::CreateTextureFromSkin(int skin) {
+    const uint8_t* pixels = m_skinPixels[skin];
     unsigned int textureID;
     glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
+    GLState::BindTexture(textureID);
+    
+    if (m_skinIndexed) {
+        // Индексы палитры нельзя интерполировать - только ближайший тексель
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE8, m_header.skinWidth, m_header.skinHeight, 
+                     0, GL_LUMINANCE, GL_UNSIGNED_BYTE, pixels);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        return textureID;
+    }
+    
+    std::vector<unsigned char> rgbData;
+    ConvertSkinToRGBA(pixels, rgbData);
     
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -262,6 +698,34 @@ unsigned int MDLModel::CreateTextureFromSkin(const MDLSkin& skin) {
     return textureID;
 }
 
+void MDLModel::ConvertSkinToRGBA(const uint8_t* pixels, std::vector<unsigned char>& rgbData) {
+    size_t pixelCount = static_cast<size_t>(m_header.skinWidth) * m_header.skinHeight;
+    rgbData.resize(pixelCount * 4);
+    ExpandPaletteToRGBA(pixels, pixelCount, rgbData.data());
+}
+
+void MDLModel::ExpandPaletteToRGBA(const uint8_t* indices, size_t pixelCount, unsigned char* rgba) {
+    const unsigned char (*palette)[3] = reinterpret_cast<const unsigned char (*)[3]>(GetPalette());
+    
+    // Convert 8-bit indexed to RGBA
+    for (size_t i = 0; i < pixelCount; ++i) {
+        int paletteIndex = indices[i];
+        
+        // Прозрачные пиксели (индекс 255)
+        if (paletteIndex == 255) {
+            rgba[i * 4 + 0] = 0;
+            rgba[i * 4 + 1] = 0;
+            rgba[i * 4 + 2] = 0;
+            rgba[i * 4 + 3] = 0; // Полная прозрачность
+        } else {
+            rgba[i * 4 + 0] = palette[paletteIndex][0];
+            rgba[i * 4 + 1] = palette[paletteIndex][1];
+            rgba[i * 4 + 2] = palette[paletteIndex][2];
+            rgba[i * 4 + 3] = 255; // Полная непрозрачность
+        }
+    }
+}
+
 void MDLModel::InitializeNormals() {
     // ПОЛНАЯ таблица нормалей из 162 значений
     float tempNormals[][3] = {
@@ -358,8 +822,9 @@ void MDLModel::InitializeNormals() {
     }
 }
 
-void MDLModel::LoadPalette(unsigned char palette[256][3]) {
-    unsigned char Palette[256][3] = {
+const unsigned char* MDLModel::GetPalette() {
+    // Палитра Quake; индекс 255 в скинах означает прозрачный пиксель
+    static const unsigned char Palette[256][3] = {
         { 0, 0, 0}, { 15, 15, 15}, { 31, 31, 31}, { 47, 47, 47},
         { 63, 63, 63}, { 75, 75, 75}, { 91, 91, 91}, {107, 107, 107},
         {123, 123, 123}, {139, 139, 139}, {155, 155, 155}, {171, 171, 171},
@@ -426,7 +891,7 @@ void MDLModel::LoadPalette(unsigned char palette[256][3]) {
         {255, 243, 147}, {255, 247, 199}, {255, 255, 255}, {159, 91, 83}
     };
     
-    memcpy(palette, Palette, sizeof(Palette));
+    return &Palette[0][0];
 }
 
 
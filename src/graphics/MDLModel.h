@@ -3,57 +3,44 @@
 #include <string>
 #include <cstdint>
 #include "../math/Matrix4.h"
+#include "../math/Bounds.h"
+#include "TextureAtlas.h"
+#include "MDLFile.h"
+#include "CookedAsset.h"
 
 namespace Revolt {
 
-struct MDLHeader {
-    int32_t ident;           // Magic number: "IDPO"
-    int32_t version;         // Must be 6
-    float scale[3];          // Scale factor
-    float translate[3];      // Translation vector
-    float boundingRadius;
-    float eyePosition[3];    // Eyes' position
-    int32_t numSkins;        // Number of textures
-    int32_t skinWidth;       // Texture width
-    int32_t skinHeight;      // Texture height
-    int32_t numVerts;        // Number of vertices
-    int32_t numTris;         // Number of triangles
-    int32_t numFrames;       // Number of frames
-    int32_t syncType;        // 0 = synchron, 1 = random
-    int32_t flags;           // State flag
-    float size;
+// Вершина кадра, распакованная при загрузке: позиция + нормаль
+struct MDLRenderVertex {
+    float position[3];
+    float normal[3];
 };
 
-struct MDLTexCoord {
-    int32_t onSeam;
-    int32_t s, t;
-};
-
-struct MDLTriangle {
-    int32_t facesFront;      // 0 = backface, 1 = frontface
-    int32_t vertices[3];     // Vertex indices
-};
-
-struct MDLVertex {
-    uint8_t v[3];           // Compressed coordinates
-    uint8_t normalIndex;    // Normal vector index
-};
-
-struct MDLSimpleFrame {
-    MDLVertex bboxMin;      // Bounding box min
-    MDLVertex bboxMax;      // Bounding box max
-    char name[16];
-    std::vector<MDLVertex> vertices;
-};
-
-struct MDLFrame {
-    int32_t type;           // 0 = simple, !0 = group
-    MDLSimpleFrame frame;
-};
+class MDLModel;
 
-struct MDLSkin {
-    int32_t group;          // 0 = single, 1 = group
-    std::vector<uint8_t> data; // Texture data (8-bit palette indices)
+// Смешанный кадр одного экземпляра модели. Модель в кэше общая, поэтому
+// вершины и VBO для интерполяции хранит каждый объект сам; буфер
+// переиспользуется между кадрами и обновляется только при смене параметров.
+class MDLPose {
+public:
+    MDLPose();
+    ~MDLPose();
+    
+    MDLPose(const MDLPose&) = delete;
+    MDLPose& operator=(const MDLPose&) = delete;
+    
+private:
+    friend class MDLModel;
+    
+    std::vector<MDLRenderVertex> m_vertices;
+    unsigned int m_vertexBuffer;   // 0 - VBO недоступен, рисуем из m_vertices
+    size_t m_bufferCapacity;       // В вершинах
+    
+    // Параметры последнего смешивания
+    const MDLModel* m_model;
+    int m_frame1;
+    int m_frame2;
+    float m_interp;
 };
 
 class MDLModel {
@@ -61,40 +48,137 @@ public:
     MDLModel();
     ~MDLModel();
     
-    bool LoadFromFile(const std::string& filename);
+    // atlas - общий атлас скинов; без него у модели свои текстуры
+    bool LoadFromFile(const std::string& filename, TextureAtlas* atlas = nullptr);
+    // Разбор файла и распаковка кадров без обращения к OpenGL. Файл остаётся
+    // отображённым в память, пока жива модель: скины берутся прямо из него
+    bool ParseFile(const std::string& filename);
+    // То же из подготовленного RevoltCook файла (.rmdl): шов, индексы и скины
+    // уже готовы, остаётся распаковать кадры. Без OpenGL
+    bool LoadCooked(const std::string& filename);
+    // Подготовленный файл для модели, загруженной через ParseFile
+    bool Cook(const Cooked::SourceStamp& source, std::vector<uint8_t>& out) const;
+    // Кладёт скины в атлас и переводит текстурные координаты в его пространство.
+    // Вызывать до CreateGPUResources; требует текущий контекст.
+    bool AddSkinsToAtlas(TextureAtlas& atlas);
+    // Текстуры и буферы; требует текущий контекст
+    void CreateGPUResources();
+    
     void Render(int frame = 0);
+    // Только геометрия кадра; текстуру и смешивание выставляет вызывающий
+    void Draw(int frame) const;
+    // То же для instanceCount копий; атрибуты копий выставляет вызывающий
+    void DrawInstanced(int frame, int instanceCount) const;
+    unsigned int GetTextureID() const;
+    bool IsInAtlas() const { return !m_skinRegions.empty(); }
+    // Скин хранит индексы палитры (GL_LUMINANCE8) - цвет получает фрагментный шейдер
+    // по GetPalette(). Render/RenderInterpolated рисуют такие скины без палитры.
+    bool IsSkinIndexed() const { return m_skinIndexed; }
+    
+    // 256 * RGB
+    static const unsigned char* GetPalette();
+    // Индексы палитры -> RGBA (индекс 255 прозрачен), pixelCount * 4 байт в rgba
+    static void ExpandPaletteToRGBA(const uint8_t* indices, size_t pixelCount, unsigned char* rgba);
+    
+    // Уникальный номер модели - для группировки в очереди отрисовки
+    uint32_t GetResourceID() const { return m_resourceID; }
+    
+    // Плавная анимация: смешивает кадры frame1 и frame2 (interp 0..1)
     void RenderInterpolated(int frame1, int frame2, float interp);
+    // Смешивает кадры в буфер экземпляра; повтор с теми же параметрами ничего не делает
+    void Interpolate(MDLPose& pose, int frame1, int frame2, float interp) const;
+    // Только геометрия смешанного кадра, как Draw
+    void DrawPose(const MDLPose& pose) const;
+    
+    // Упакованные кадры на GPU: 4 байта на вершину (MDLVertex) вместо 24.
+    // Распаковку и смешивание делает вершинный шейдер: кадры приходят в атрибуты
+    // PACKED_FRAME1_ATTRIB/PACKED_FRAME2_ATTRIB, масштаб и смещение - из заголовка,
+    // нормаль - по индексу из GetNormalTable().
+    static constexpr unsigned int PACKED_FRAME1_ATTRIB = 0;
+    static constexpr unsigned int PACKED_FRAME2_ATTRIB = 1;
+    bool HasPackedFrames() const { return m_packedBuffer != 0; }
+    void DrawPacked(int frame1, int frame2) const;
+    
+    static constexpr int NUM_NORMALS = 162;
+    const float* GetNormalTable() const { return &m_normals[0][0]; }
     
-    int GetFrameCount() const { return static_cast<int>(m_frames.size()); }
+    int GetFrameCount() const { return static_cast<int>(m_frameBounds.size()); }
+    int GetRenderVertexCount() const { return m_renderVertexCount; }
+    int GetIndexCount() const { return static_cast<int>(m_renderIndices.size()); }
     
     const MDLHeader& GetHeader() const { return m_header; }
+    // Распакованные вершины кадра (GetRenderVertexCount() штук)
+    const MDLRenderVertex* GetFrameVertices(int frame) const;
+    // Распаковка упакованного кадра в out (GetRenderVertexCount() штук); ей же
+    // заполняются кадры при загрузке
+    void DecodeFrame(int frame, MDLRenderVertex* out) const;
     
-private:
-    bool ReadHeader(FILE* fp);
-    bool ReadSkins(FILE* fp);
-    bool ReadTexCoords(FILE* fp);
-    bool ReadTriangles(FILE* fp);
-    bool ReadFrames(FILE* fp);
+    int GetSkinCount() const { return static_cast<int>(m_skinPixels.size()); }
+    // Индексы палитры скина, skinWidth * skinHeight байт
+    const uint8_t* GetSkinPixels(int skin) const { return m_skinPixels[skin]; }
     
+    // Границы кадра из bboxMin/bboxMax файла и радиус из заголовка (вокруг начала координат)
+    const BoundingBox& GetBounds(int frame) const;
+    float GetBoundingRadius() const { return m_header.boundingRadius; }
+    
+private:
     void ConvertVertex(const MDLVertex& vertex, float result[3]) const;
     
+    // Разделяет вершины на шве, распаковывает все кадры и строит индексы
+    void BuildRenderData();
+    void UploadBuffers();
+    void ReleaseBuffers();
+    
+    int ClampFrame(int frame) const;
+    int GetTextureIndex() const;
+    
+    // Возвращает указатель на индексы для glDrawElements.
+    // vertexBase - смещение в vertexBuffer или, без VBO, указатель на вершины.
+    const void* BindArrays(int frame) const;
+    const void* BindArrays(unsigned int vertexBuffer, const char* vertexBase) const;
+    void UnbindArrays() const;
+    
+    uint32_t m_resourceID;
+    
+    // Источник данных: исходный файл или подготовленный - отображение
+    // живёт вместе с моделью, скины берутся прямо из него
+    MDLFile m_file;
+    MappedFile m_cookedFile;
     MDLHeader m_header;
-    std::vector<MDLSkin> m_skins;
-    std::vector<MDLTexCoord> m_texCoords;
-    std::vector<MDLTriangle> m_triangles;
-    std::vector<MDLFrame> m_frames;
+    std::vector<const uint8_t*> m_skinPixels;
+    std::vector<const uint8_t*> m_skinRGBA; // Только у подготовленных файлов
+    
+    // Данные для рендеринга. Вершина на шве, используемая задней гранью,
+    // получает отдельную копию со смещённой текстурной координатой.
+    int m_renderVertexCount;
+    std::vector<int> m_renderVertexSource;        // Индекс исходной вершины MDL
+    std::vector<float> m_renderTexCoords;         // s, t для каждой вершины рендеринга
+    std::vector<unsigned int> m_renderIndices;
+    std::vector<MDLRenderVertex> m_frameVertices; // numFrames * m_renderVertexCount
+    std::vector<MDLVertex> m_packedFrameVertices; // То же без распаковки
+    std::vector<BoundingBox> m_frameBounds;
+    BoundingBox m_bounds;                         // Объединение всех кадров
+    
+    // Буферы OpenGL (0 - VBO недоступен, рисуем из клиентских массивов)
+    unsigned int m_frameBuffer;
+    unsigned int m_texCoordBuffer;
+    unsigned int m_indexBuffer;
+    unsigned int m_packedBuffer;   // 0 - шейдеры недоступны
     
     // OpenGL texture IDs
-    std::vector<unsigned int> m_textureIDs;
+    std::vector<unsigned int> m_textureIDs;     // Собственные текстуры, если скины не в атласе
+    std::vector<AtlasRegion> m_skinRegions;    // Места скинов в атласе
     int m_currentSkin;
+    bool m_skinIndexed;
+    
+    MDLPose m_scratchPose; // Для RenderInterpolated
     
     // Normal vectors table (from anorms.h)
-    static constexpr int NUM_NORMALS = 162;
     float m_normals[NUM_NORMALS][3];
     
     void InitializeNormals();
-    unsigned int CreateTextureFromSkin(const MDLSkin& skin);
-    void LoadPalette(unsigned char palette[256][3]);
+    unsigned int CreateTextureFromSkin(int skin);
+    void ConvertSkinToRGBA(const uint8_t* pixels, std::vector<unsigned char>& rgba);
 };
 
 } // namespace Revolt
\ No newline at end of file
@@ -1,7 +1,11 @@
 #include "Mesh.h"
+#include "GLExtensions.h"
+#include "GLState.h"
 #include <GLFW/glfw3.h>
 #include <vector>
+#include <atomic>
 #include <cmath>
+#include <cstddef>
 #include <iostream>
 
 namespace Revolt {
@@ -12,8 +16,8 @@ Material::Material(float r, float g, float b, float a) {
 
 void Material::Apply() const {
     // ВКЛЮЧАЕМ цветовой материал для работы с glColor
-    glEnable(GL_COLOR_MATERIAL);
-    glColorMaterial(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE);
+    GLState::Enable(GL_COLOR_MATERIAL);
+    GLState::ColorMaterial(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE);
     
     // Устанавливаем цвет через glColor
     glColor4f(m_color[0], m_color[1], m_color[2], m_color[3]);
@@ -29,21 +33,46 @@ void Material::Apply() const {
     glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, specular);
     glMaterialf(GL_FRONT_AND_BACK, GL_SHININESS, shininess);
     
+    // При включённом GL_COLOR_MATERIAL ambient и diffuse всё равно берутся из glColor,
+    // поэтому ApplyCommonState + ApplyColor дают тот же результат
+    
     // Настройка прозрачности
     if (m_color[3] < 1.0f) {
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        glDepthMask(GL_FALSE);
+        GLState::Enable(GL_BLEND);
+        GLState::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        GLState::DepthMask(false);
     } else {
-        glDisable(GL_BLEND);
-        glDepthMask(GL_TRUE);
+        GLState::Disable(GL_BLEND);
+        GLState::DepthMask(true);
     }
 }
 
 void Material::Unapply() const {
     // Восстанавливаем стандартные настройки
-    glDisable(GL_BLEND);
-    glDepthMask(GL_TRUE);
+    GLState::Disable(GL_BLEND);
+    GLState::DepthMask(true);
+}
+
+void Material::ApplyCommonState() {
+    GLState::Enable(GL_COLOR_MATERIAL);
+    GLState::ColorMaterial(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE);
+    
+    float specular[] = {0.3f, 0.3f, 0.3f, 1.0f};
+    glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, specular);
+    glMaterialf(GL_FRONT_AND_BACK, GL_SHININESS, 16.0f);
+}
+
+void Material::ApplyColor() const {
+    glColor4fv(m_color);
+}
+
+uint32_t Material::GetSortKey() const {
+    uint32_t key = 0;
+    for (int i = 0; i < 4; ++i) {
+        float c = m_color[i] < 0.0f ? 0.0f : (m_color[i] > 1.0f ? 1.0f : m_color[i]);
+        key = (key << 8) | static_cast<uint32_t>(c * 255.0f + 0.5f);
+    }
+    return key;
 }
 
 void Material::SetColor(float r, float g, float b, float a) {
@@ -53,186 +82,246 @@ void Material::SetColor(float r, float g, float b, float a) {
     m_color[3] = a;
 }
 
-Mesh::Mesh() : m_material(1.0f, 1.0f, 1.0f, 1.0f) {
+Mesh::Mesh() : m_material(1.0f, 1.0f, 1.0f, 1.0f), m_vertexBuffer(0), m_indexBuffer(0) {
+    // Меши строятся и на рабочих потоках ResourceManager
+    static std::atomic<uint32_t> nextResourceID(1);
+    m_resourceID = nextResourceID.fetch_add(1, std::memory_order_relaxed);
 }
 
 Mesh::~Mesh() {
+    // Меши живут в кэше ResourceManager и могут пережить контекст
+    if (glfwGetCurrentContext() && m_vertexBuffer) {
+        GLExtensions::DeleteBuffers(1, &m_vertexBuffer);
+        GLExtensions::DeleteBuffers(1, &m_indexBuffer);
+    }
+}
+
+void Mesh::AddTriangle(unsigned int a, unsigned int b, unsigned int c) {
+    m_indices.push_back(a);
+    m_indices.push_back(b);
+    m_indices.push_back(c);
+}
+
+void Mesh::AddQuad(unsigned int a, unsigned int b, unsigned int c, unsigned int d) {
+    // Тот же порядок обхода, что и у GL_QUADS
+    AddTriangle(a, b, c);
+    AddTriangle(a, c, d);
+}
+
+void Mesh::UploadGeometry() {
+    if (m_vertexBuffer || !GLExtensions::HasVertexBufferObject() || m_indices.empty()) {
+        return;
+    }
+    
+    GLExtensions::GenBuffers(1, &m_vertexBuffer);
+    GLExtensions::BindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+    GLExtensions::BufferData(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(Vertex), m_vertices.data(), GL_STATIC_DRAW);
+    GLExtensions::BindBuffer(GL_ARRAY_BUFFER, 0);
+    
+    GLExtensions::GenBuffers(1, &m_indexBuffer);
+    GLExtensions::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+    GLExtensions::BufferData(GL_ELEMENT_ARRAY_BUFFER, m_indices.size() * sizeof(unsigned int), m_indices.data(), GL_STATIC_DRAW);
+    GLExtensions::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+void Mesh::Render() {
+    m_material.Apply();
+    Draw();
+    m_material.Unapply();
+}
+
+void Mesh::Draw() const {
+    if (m_indices.empty()) {
+        return;
+    }
+    
+    const void* indices = BindArrays();
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(m_indices.size()), GL_UNSIGNED_INT, indices);
+    UnbindArrays();
+}
+
+void Mesh::DrawInstanced(int instanceCount) const {
+    if (m_indices.empty() || instanceCount <= 0) {
+        return;
+    }
+    
+    const void* indices = BindArrays();
+    GLExtensions::DrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(m_indices.size()), 
+                                        GL_UNSIGNED_INT, indices, instanceCount);
+    UnbindArrays();
+}
+
+const void* Mesh::BindArrays() const {
+    // С VBO указатели - смещения внутри буфера, без него - адреса в памяти
+    const char* vertexBase = nullptr;
+    const void* indices = nullptr;
+    if (m_vertexBuffer) {
+        GLExtensions::BindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+        GLExtensions::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+    } else {
+        vertexBase = reinterpret_cast<const char*>(m_vertices.data());
+        indices = m_indices.data();
+    }
+    
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_NORMAL_ARRAY);
+    glVertexPointer(3, GL_FLOAT, sizeof(Vertex), vertexBase + offsetof(Vertex, x));
+    glNormalPointer(GL_FLOAT, sizeof(Vertex), vertexBase + offsetof(Vertex, nx));
+    
+    return indices;
+}
+
+void Mesh::UnbindArrays() const {
+    glDisableClientState(GL_NORMAL_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    
+    if (m_vertexBuffer) {
+        GLExtensions::BindBuffer(GL_ARRAY_BUFFER, 0);
+        GLExtensions::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
 }
 
 // PyramidMesh implementation
 PyramidMesh::PyramidMesh(float base, float height) 
     : m_base(base), m_height(height) {
+    float halfBase = base * 0.5f;
+    m_bounds = BoundingBox(-halfBase, -height * 0.5f, -halfBase, halfBase, height * 0.5f, halfBase);
+    CreatePyramidGeometry(base, height);
 }
 
-void PyramidMesh::Render() {
-    m_material.Apply();
+void PyramidMesh::CreatePyramidGeometry(float base, float height) {
+    float halfBase = base * 0.5f;
     
-    float halfBase = m_base * 0.5f;
+    // ОСНОВАНИЕ - на плоскости y=-height/2 (центр пирамиды в середине высоты)
+    float baseY = -height * 0.5f;
+    // Вершина - на y=height/2
+    float topY = height * 0.5f;
     
-    glBegin(GL_TRIANGLES);
+    m_vertices.reserve(16);
+    m_indices.reserve(18);
     
-    // Устанавливаем цвет через glColor4f
-    glColor4f(m_material.GetColor()[0], m_material.GetColor()[1], 
-              m_material.GetColor()[2], m_material.GetColor()[3]);
+    m_vertices.push_back(Vertex(-halfBase, baseY, -halfBase, 0.0f, -1.0f, 0.0f));
+    m_vertices.push_back(Vertex( halfBase, baseY, -halfBase, 0.0f, -1.0f, 0.0f));
+    m_vertices.push_back(Vertex( halfBase, baseY,  halfBase, 0.0f, -1.0f, 0.0f));
+    m_vertices.push_back(Vertex(-halfBase, baseY,  halfBase, 0.0f, -1.0f, 0.0f));
+    AddTriangle(0, 1, 2);
+    AddTriangle(2, 3, 0);
     
-    // ОСНОВАНИЕ - на плоскости y=-height/2 (центр пирамиды в середине высоты)
-    float baseY = -m_height * 0.5f;
-    glNormal3f(0.0f, -1.0f, 0.0f);
-    glVertex3f(-halfBase, baseY, -halfBase);
-    glVertex3f( halfBase, baseY, -halfBase);
-    glVertex3f( halfBase, baseY,  halfBase);
-    
-    glVertex3f( halfBase, baseY,  halfBase);
-    glVertex3f(-halfBase, baseY,  halfBase);
-    glVertex3f(-halfBase, baseY, -halfBase);
-    
-    // Боковые грани - основание на y=-height/2, вершина на y=height/2
-    float topY = m_height * 0.5f;
-    
-    // Передняя грань
-    glNormal3f(0.0f, 0.707f, -0.707f);
-    glVertex3f(-halfBase, baseY, -halfBase);
-    glVertex3f( 0.0f,     topY,  0.0f);  // вершина
-    glVertex3f( halfBase, baseY, -halfBase);
-    
-    // Правая грань
-    glNormal3f(0.707f, 0.707f, 0.0f);
-    glVertex3f( halfBase, baseY, -halfBase);
-    glVertex3f( 0.0f,     topY,  0.0f);  // вершина
-    glVertex3f( halfBase, baseY,  halfBase);
-    
-    // Задняя грань
-    glNormal3f(0.0f, 0.707f, 0.707f);
-    glVertex3f( halfBase, baseY,  halfBase);
-    glVertex3f( 0.0f,     topY,  0.0f);  // вершина
-    glVertex3f(-halfBase, baseY,  halfBase);
-    
-    // Левая грань
-    glNormal3f(-0.707f, 0.707f, 0.0f);
-    glVertex3f(-halfBase, baseY,  halfBase);
-    glVertex3f( 0.0f,     topY,  0.0f);  // вершина
-    glVertex3f(-halfBase, baseY, -halfBase);
-    
-    glEnd();
-
-    m_material.Unapply();
+    // Боковые грани: у каждой своя нормаль, поэтому вершины не разделяются
+    struct Side { float x0, z0, x1, z1, nx, ny, nz; };
+    const Side sides[4] = {
+        {-halfBase, -halfBase,  halfBase, -halfBase,  0.0f,   0.707f, -0.707f}, // Передняя
+        { halfBase, -halfBase,  halfBase,  halfBase,  0.707f, 0.707f,  0.0f},   // Правая
+        { halfBase,  halfBase, -halfBase,  halfBase,  0.0f,   0.707f,  0.707f}, // Задняя
+        {-halfBase,  halfBase, -halfBase, -halfBase, -0.707f, 0.707f,  0.0f}    // Левая
+    };
+    
+    for (const Side& side : sides) {
+        unsigned int first = static_cast<unsigned int>(m_vertices.size());
+        m_vertices.push_back(Vertex(side.x0, baseY, side.z0, side.nx, side.ny, side.nz));
+        m_vertices.push_back(Vertex(0.0f,    topY,  0.0f,    side.nx, side.ny, side.nz));
+        m_vertices.push_back(Vertex(side.x1, baseY, side.z1, side.nx, side.ny, side.nz));
+        AddTriangle(first, first + 1, first + 2);
+    }
 }
 
 // CubeMesh implementation
 CubeMesh::CubeMesh(float size) 
     : m_size(size) {
+    float halfSize = size * 0.5f;
+    m_bounds = BoundingBox(-halfSize, -halfSize, -halfSize, halfSize, halfSize, halfSize);
+    CreateCubeGeometry(size);
 }
 
-void CubeMesh::Render() {
-    m_material.Apply();
+void CubeMesh::CreateCubeGeometry(float size) {
+    float h = size * 0.5f;
     
-    float halfSize = m_size * 0.5f;
-    
-    glBegin(GL_QUADS);
-    
-    // Устанавливаем цвет через glColor4f
-    glColor4f(m_material.GetColor()[0], m_material.GetColor()[1], 
-              m_material.GetColor()[2], m_material.GetColor()[3]);
-    
-    // Передняя грань
-    glNormal3f(0.0f, 0.0f, 1.0f);
-    glVertex3f(-halfSize, -halfSize,  halfSize);
-    glVertex3f( halfSize, -halfSize,  halfSize);
-    glVertex3f( halfSize,  halfSize,  halfSize);
-    glVertex3f(-halfSize,  halfSize,  halfSize);
-    
-    // Задняя грань
-    glNormal3f(0.0f, 0.0f, -1.0f);
-    glVertex3f(-halfSize, -halfSize, -halfSize);
-    glVertex3f(-halfSize,  halfSize, -halfSize);
-    glVertex3f( halfSize,  halfSize, -halfSize);
-    glVertex3f( halfSize, -halfSize, -halfSize);
-    
-    // Верхняя грань
-    glNormal3f(0.0f, 1.0f, 0.0f);
-    glVertex3f(-halfSize,  halfSize, -halfSize);
-    glVertex3f(-halfSize,  halfSize,  halfSize);
-    glVertex3f( halfSize,  halfSize,  halfSize);
-    glVertex3f( halfSize,  halfSize, -halfSize);
-    
-    // Нижняя грань
-    glNormal3f(0.0f, -1.0f, 0.0f);
-    glVertex3f(-halfSize, -halfSize, -halfSize);
-    glVertex3f( halfSize, -halfSize, -halfSize);
-    glVertex3f( halfSize, -halfSize,  halfSize);
-    glVertex3f(-halfSize, -halfSize,  halfSize);
-    
-    // Правая грань
-    glNormal3f(1.0f, 0.0f, 0.0f);
-    glVertex3f( halfSize, -halfSize, -halfSize);
-    glVertex3f( halfSize,  halfSize, -halfSize);
-    glVertex3f( halfSize,  halfSize,  halfSize);
-    glVertex3f( halfSize, -halfSize,  halfSize);
-    
-    // Левая грань
-    glNormal3f(-1.0f, 0.0f, 0.0f);
-    glVertex3f(-halfSize, -halfSize, -halfSize);
-    glVertex3f(-halfSize, -halfSize,  halfSize);
-    glVertex3f(-halfSize,  halfSize,  halfSize);
-    glVertex3f(-halfSize,  halfSize, -halfSize);
-    
-    glEnd();
-
-    m_material.Unapply();
+    struct Face { float nx, ny, nz; float v[4][3]; };
+    const Face faces[6] = {
+        { 0.0f,  0.0f,  1.0f, {{-h, -h,  h}, { h, -h,  h}, { h,  h,  h}, {-h,  h,  h}}}, // Передняя
+        { 0.0f,  0.0f, -1.0f, {{-h, -h, -h}, {-h,  h, -h}, { h,  h, -h}, { h, -h, -h}}}, // Задняя
+        { 0.0f,  1.0f,  0.0f, {{-h,  h, -h}, {-h,  h,  h}, { h,  h,  h}, { h,  h, -h}}}, // Верхняя
+        { 0.0f, -1.0f,  0.0f, {{-h, -h, -h}, { h, -h, -h}, { h, -h,  h}, {-h, -h,  h}}}, // Нижняя
+        { 1.0f,  0.0f,  0.0f, {{ h, -h, -h}, { h,  h, -h}, { h,  h,  h}, { h, -h,  h}}}, // Правая
+        {-1.0f,  0.0f,  0.0f, {{-h, -h, -h}, {-h, -h,  h}, {-h,  h,  h}, {-h,  h, -h}}}  // Левая
+    };
+    
+    m_vertices.reserve(24);
+    m_indices.reserve(36);
+    
+    for (const Face& face : faces) {
+        unsigned int first = static_cast<unsigned int>(m_vertices.size());
+        for (int i = 0; i < 4; ++i) {
+            m_vertices.push_back(Vertex(face.v[i][0], face.v[i][1], face.v[i][2], face.nx, face.ny, face.nz));
+        }
+        AddQuad(first, first + 1, first + 2, first + 3);
+    }
 }
 
 // TorusMesh implementation
 TorusMesh::TorusMesh(float majorRadius, float minorRadius, int majorSegments, int minorSegments) 
     : m_majorRadius(majorRadius), m_minorRadius(minorRadius), 
       m_majorSegments(majorSegments), m_minorSegments(minorSegments) {
+    // Тор лежит в плоскости XY, с тем же масштабом 0.5, что и геометрия
+    float outer = (majorRadius + minorRadius) * 0.5f;
+    float tube = minorRadius * 0.5f;
+    m_bounds = BoundingBox(-outer, -outer, -tube, outer, outer, tube);
+    CreateTorusGeometry(majorRadius, minorRadius, majorSegments, minorSegments);
 }
 
-void TorusMesh::Render() {
-    m_material.Apply();
-    
-    const float majorStep = 2.0f * 3.14159265359f / m_majorSegments;
-    const float minorStep = 2.0f * 3.14159265359f / m_minorSegments;
+void TorusMesh::CreateTorusGeometry(float majorRadius, float minorRadius, int majorSegments, int minorSegments) {
+    if (majorSegments <= 0 || minorSegments <= 0) {
+        return;
+    }
     
-    // Устанавливаем цвет материала
-    glColor4f(m_material.GetColor()[0], m_material.GetColor()[1], 
-              m_material.GetColor()[2], m_material.GetColor()[3]);
+    const float majorStep = 2.0f * 3.14159265359f / majorSegments;
+    const float minorStep = 2.0f * 3.14159265359f / minorSegments;
     
     // Уменьшаем базовый размер тора в 2 раза
     float scaleFactor = 0.5f;
-    float scaledMajorRadius = m_majorRadius * scaleFactor;
-    float scaledMinorRadius = m_minorRadius * scaleFactor;
+    float scaledMajorRadius = majorRadius * scaleFactor;
+    float scaledMinorRadius = minorRadius * scaleFactor;
     
-    for (int i = 0; i < m_majorSegments; ++i) {
-        glBegin(GL_QUAD_STRIP);
-        
-        float majorAngle1 = i * majorStep;
-        float majorAngle2 = (i + 1) * majorStep;
+    // Сетка (majorSegments + 1) x (minorSegments + 1): шов дублируется,
+    // синусы и косинусы считаются один раз при создании
+    const int ringSize = minorSegments + 1;
+    m_vertices.reserve((majorSegments + 1) * ringSize);
+    m_indices.reserve(majorSegments * minorSegments * 6);
+    
+    for (int i = 0; i <= majorSegments; ++i) {
+        float majorAngle = i * majorStep;
+        float cosMajor = cos(majorAngle);
+        float sinMajor = sin(majorAngle);
         
-        for (int j = 0; j <= m_minorSegments; ++j) {
+        for (int j = 0; j <= minorSegments; ++j) {
             float minorAngle = j * minorStep;
+            float cosMinor = cos(minorAngle);
+            float sinMinor = sin(minorAngle);
             
-            for (int k = 0; k < 2; ++k) {
-                float currentMajorAngle = (k == 0) ? majorAngle1 : majorAngle2;
-                
-                // Вычисляем позицию точки на торе с уменьшенным масштабом
-                float x = (scaledMajorRadius + scaledMinorRadius * cos(minorAngle)) * cos(currentMajorAngle);
-                float y = (scaledMajorRadius + scaledMinorRadius * cos(minorAngle)) * sin(currentMajorAngle);
-                float z = scaledMinorRadius * sin(minorAngle);
-                
-                // Вычисляем нормаль
-                float nx = cos(currentMajorAngle) * cos(minorAngle);
-                float ny = sin(currentMajorAngle) * cos(minorAngle);
-                float nz = sin(minorAngle);
-                
-                glNormal3f(nx, ny, nz);
-                glVertex3f(x, y, z);
-            }
+            float ring = scaledMajorRadius + scaledMinorRadius * cosMinor;
+            m_vertices.push_back(Vertex(ring * cosMajor, ring * sinMajor, scaledMinorRadius * sinMinor,
+                                        cosMajor * cosMinor, sinMajor * cosMinor, sinMinor));
+        }
+    }
+    
+    for (int i = 0; i < majorSegments; ++i) {
+        for (int j = 0; j < minorSegments; ++j) {
+            unsigned int a = i * ringSize + j;       // (i,   j)
+            unsigned int b = (i + 1) * ringSize + j; // (i+1, j)
+            unsigned int c = b + 1;                  // (i+1, j+1)
+            unsigned int d = a + 1;                  // (i,   j+1)
+            // Порядок обхода как у бывшего GL_QUAD_STRIP
+            AddQuad(a, b, c, d);
         }
-        
-        glEnd();
     }
+}
 
-    m_material.Unapply();
+// CookedMesh implementation
+CookedMesh::CookedMesh(const Vertex* vertices, std::size_t vertexCount, const unsigned int* indices, std::size_t indexCount,
+                       const BoundingBox& bounds) {
+    m_bounds = bounds;
+    m_vertices.assign(vertices, vertices + vertexCount);
+    m_indices.assign(indices, indices + indexCount);
 }
 
 } // namespace Revolt
\ No newline at end of file
@@ -1,14 +1,20 @@
 #pragma once
 #include "../math/Matrix4.h"
+#include "../math/Bounds.h"
+#include <vector>
+#include <cstddef>
+#include <cstdint>
 
 namespace Revolt {
 
+// Вершина в чередующемся (interleaved) буфере: позиция + нормаль.
+// Цвет задаётся материалом через glColor, поэтому в вершине его нет.
 struct Vertex {
     float x, y, z;
-    float r, g, b, a;
+    float nx, ny, nz;
     
-    Vertex(float x, float y, float z, float r = 1.0f, float g = 1.0f, float b = 1.0f, float a = 1.0f)
-        : x(x), y(y), z(z), r(r), g(g), b(b), a(a) {}
+    Vertex(float x, float y, float z, float nx = 0.0f, float ny = 0.0f, float nz = 1.0f)
+        : x(x), y(y), z(z), nx(nx), ny(ny), nz(nz) {}
 };
 
 class Material {
@@ -17,6 +23,15 @@ class Material {
         void Apply() const;
         void Unapply() const;
         
+        // Для рендерера, который сам отслеживает состояние между вызовами:
+        // общее для всех материалов состояние ставится один раз, дальше только цвет
+        static void ApplyCommonState();
+        void ApplyColor() const;
+        
+        bool IsTransparent() const { return m_color[3] < 1.0f; }
+        // Цвет, квантованный до 8 бит на канал - для ключей сортировки
+        uint32_t GetSortKey() const;
+        
         void SetColor(float r, float g, float b, float a = 1.0f);
         const float* GetColor() const { return m_color; }
         
@@ -35,19 +50,57 @@ public:
     Mesh();
     virtual ~Mesh();
     
-    virtual void Render() = 0;
+    Mesh(const Mesh&) = delete;
+    Mesh& operator=(const Mesh&) = delete;
+    
+    // Применяет материал и рисует геометрию
+    virtual void Render();
+    // Только геометрия: один glDrawElements из запечённых буферов
+    void Draw() const;
+    // То же для instanceCount копий; атрибуты копий выставляет вызывающий
+    void DrawInstanced(int instanceCount) const;
+    
+    // Уникальный номер меша - для группировки в очереди отрисовки
+    uint32_t GetResourceID() const { return m_resourceID; }
+    
     void SetMaterial(const Material& material) { m_material = material; }
     const Material& GetMaterial() const { return m_material; }
     
+    std::size_t GetVertexCount() const { return m_vertices.size(); }
+    std::size_t GetIndexCount() const { return m_indices.size(); }
+    const std::vector<Vertex>& GetVertices() const { return m_vertices; }
+    const std::vector<unsigned int>& GetIndices() const { return m_indices; }
+    // Локальные границы, задаются наследниками аналитически по параметрам
+    const BoundingBox& GetBounds() const { return m_bounds; }
+    
+    // Загружает m_vertices/m_indices в VBO (если доступны); повторный вызов ничего не делает.
+    // Конструкторы наследников только строят геометрию и могут работать на любом потоке,
+    // а загрузку вызывает ResourceManager на главном.
+    void UploadGeometry();
+    
 protected:
+    void AddTriangle(unsigned int a, unsigned int b, unsigned int c);
+    void AddQuad(unsigned int a, unsigned int b, unsigned int c, unsigned int d);
+    
     Material m_material;
+    BoundingBox m_bounds;
+    std::vector<Vertex> m_vertices;
+    std::vector<unsigned int> m_indices;
+    
+private:
+    // Возвращает указатель на индексы для glDrawElements
+    const void* BindArrays() const;
+    void UnbindArrays() const;
+    
+    uint32_t m_resourceID;
+    unsigned int m_vertexBuffer; // 0 - VBO недоступен, рисуем из клиентских массивов
+    unsigned int m_indexBuffer;
 };
 
 // Конкретные реализации мешей
 class PyramidMesh : public Mesh {
 public:
     PyramidMesh(float base = 1.0f, float height = 1.0f);
-    void Render() override;
     
 private:
     void CreatePyramidGeometry(float base, float height);
@@ -58,7 +111,6 @@ private:
 class CubeMesh : public Mesh {
 public:
     CubeMesh(float size = 1.0f);
-    void Render() override;
     
 private:
     void CreateCubeGeometry(float size);
@@ -68,7 +120,6 @@ private:
 class TorusMesh : public Mesh {
 public:
     TorusMesh(float majorRadius = 1.0f, float minorRadius = 0.3f, int majorSegments = 32, int minorSegments = 16);
-    void Render() override;
     
 private:
     void CreateTorusGeometry(float majorRadius, float minorRadius, int majorSegments, int minorSegments);
@@ -78,4 +129,11 @@ private:
     int m_minorSegments;
 };
 
+// Геометрия из подготовленного пакета (.rmesh) - строить ничего не нужно
+class CookedMesh : public Mesh {
+public:
+    CookedMesh(const Vertex* vertices, std::size_t vertexCount, const unsigned int* indices, std::size_t indexCount,
+               const BoundingBox& bounds);
+};
+
 } // namespace Revolt
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include "RenderQueue.h"
+#include "MDLModel.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Revolt {
+
+namespace {
+
+// Для неотрицательных float порядок битового представления совпадает с порядком чисел
+uint32_t DepthBits(const Matrix4& modelView) {
+    float depth = -modelView.m[14]; // Камера смотрит вдоль -Z
+    if (!(depth > 0.0f)) {
+        depth = 0.0f;
+    }
+    uint32_t bits;
+    std::memcpy(&bits, &depth, sizeof(bits));
+    return bits;
+}
+
+// Модели с одной страницы атласа идут подряд: текстура в старших битах поля геометрии
+uint32_t MDLGeometryKey(const MDLModel& model) {
+    return ((model.GetTextureID() & 0x3Fu) << 8) | (model.GetResourceID() & 0xFFu);
+}
+
+} // namespace
+
+void RenderQueue::Clear() {
+    // Память не освобождается - в установившемся режиме аллокаций нет
+    m_packets.clear();
+    m_sortEntries.clear();
+}
+
+void RenderQueue::Reserve(size_t count) {
+    m_packets.reserve(count);
+    m_sortEntries.reserve(count);
+}
+
+void RenderQueue::AddMesh(Mesh& mesh, const Matrix4& modelView) {
+    DrawPacket packet;
+    packet.modelView = modelView;
+    packet.material = mesh.GetMaterial();
+    packet.mesh = &mesh;
+    packet.mdlModel = nullptr;
+    packet.frame = 0;
+    packet.nextFrame = 0;
+    packet.interp = 0.0f;
+    packet.pose = nullptr;
+    packet.transparent = packet.material.IsTransparent();
+
+    // Для непрозрачных альфа всегда 1, поэтому достаточно RGB
+    Add(packet, mesh.GetResourceID(), packet.material.GetSortKey() >> 8);
+}
+
+void RenderQueue::AddMDLModel(MDLModel& model, const Matrix4& modelView, int frame, const MDLPose* pose) {
+    DrawPacket packet;
+    packet.modelView = modelView;
+    packet.mesh = nullptr;
+    packet.mdlModel = &model;
+    packet.frame = frame;
+    packet.nextFrame = frame;
+    packet.interp = 0.0f;
+    packet.pose = pose;
+    packet.transparent = false;
+
+    // Текстура определяется моделью, поэтому состояние - номер кадра
+    Add(packet, MDLGeometryKey(model), static_cast<uint32_t>(frame));
+}
+
+void RenderQueue::AddBlendedMDLModel(MDLModel& model, const Matrix4& modelView, int frame1, int frame2, float interp) {
+    DrawPacket packet;
+    packet.modelView = modelView;
+    packet.mesh = nullptr;
+    packet.mdlModel = &model;
+    packet.frame = frame1;
+    packet.nextFrame = frame2;
+    packet.interp = interp;
+    packet.pose = nullptr;
+    packet.transparent = false;
+
+    Add(packet, MDLGeometryKey(model), static_cast<uint32_t>(frame1));
+}
+
+void RenderQueue::Add(const DrawPacket& packet, uint32_t geometry, uint32_t state) {
+    uint64_t depth = DepthBits(packet.modelView);
+    uint64_t key;
+
+    if (packet.transparent) {
+        key = (1ull << 63) | ((0xFFFFFFFFull - depth) << 31) | (state & 0x7FFFFFFFu);
+    } else {
+        uint64_t type = packet.mdlModel ? 1ull : 0ull;
+        // Для порядка спереди назад хватает старших 24 бит глубины
+        key = (type << 62) | (static_cast<uint64_t>(geometry & 0x3FFFu) << 48) |
+              (static_cast<uint64_t>(state & 0xFFFFFFu) << 24) | (depth >> 8);
+    }
+
+    SortEntry entry;
+    entry.key = key;
+    entry.index = static_cast<uint32_t>(m_packets.size());
+    m_sortEntries.push_back(entry);
+    m_packets.push_back(packet);
+}
+
+void RenderQueue::Sort() {
+    std::sort(m_sortEntries.begin(), m_sortEntries.end());
+}
+
+} // namespace Revolt
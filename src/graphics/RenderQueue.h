@@ -0,0 +1,66 @@
+#pragma once
+#include "../math/Matrix4.h"
+#include "Mesh.h"
+#include <vector>
+#include <cstdint>
+
+namespace Revolt {
+
+class MDLModel;
+class MDLPose;
+
+// Пакет отрисовки, собранный за кадр. Матрица уже содержит вид камеры.
+struct DrawPacket {
+    Matrix4 modelView;
+    Material material;
+    Mesh* mesh;         // Либо mesh, либо mdlModel
+    MDLModel* mdlModel;
+    int frame;
+    int nextFrame;       // Смешивание на GPU: frame -> nextFrame с долей interp
+    float interp;        // 0 - рисуется только frame
+    const MDLPose* pose; // Смешанный на CPU кадр экземпляра или nullptr
+    bool transparent;
+};
+
+// Очередь отрисовки с 64-битными ключами сортировки.
+//
+// Непрозрачные: [63]=0 | [62] тип (меш/MDL) | [61..48] геометрия | [47..24] состояние | [23..0] глубина
+//   - группируются по геометрии (для инстансинга), затем по цвету меша или кадру MDL,
+//     внутри группы - спереди назад. У MDL в поле геометрии сначала текстура
+//     (страница атласа скинов), затем модель.
+// Прозрачные:   [63]=1 | [62..31] инвертированная глубина | [30..0] состояние
+//   - рисуются после всех непрозрачных, сзади вперёд.
+class RenderQueue {
+public:
+    void Clear();
+    void Reserve(size_t count);
+
+    void AddMesh(Mesh& mesh, const Matrix4& modelView);
+    void AddMDLModel(MDLModel& model, const Matrix4& modelView, int frame, const MDLPose* pose = nullptr);
+    void AddBlendedMDLModel(MDLModel& model, const Matrix4& modelView, int frame1, int frame2, float interp);
+
+    // Сортирует по ключам; после этого пакеты доступны через GetSorted.
+    // Одинаковая геометрия непрозрачных пакетов идёт подряд.
+    void Sort();
+
+    bool IsEmpty() const { return m_packets.empty(); }
+    size_t GetSize() const { return m_packets.size(); }
+    const DrawPacket& GetSorted(size_t i) const { return m_packets[m_sortEntries[i].index]; }
+
+private:
+    struct SortEntry {
+        uint64_t key;
+        uint32_t index;
+
+        bool operator<(const SortEntry& other) const {
+            return key != other.key ? key < other.key : index < other.index;
+        }
+    };
+
+    void Add(const DrawPacket& packet, uint32_t geometry, uint32_t state);
+
+    std::vector<DrawPacket> m_packets;
+    std::vector<SortEntry> m_sortEntries;
+};
+
+} // namespace Revolt
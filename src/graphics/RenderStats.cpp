@@ -0,0 +1,70 @@
+#include "RenderStats.h"
+#include <cstring>
+
+namespace Revolt {
+
+RenderStats::RenderStats()
+    : m_historyNext(0), m_historySize(0) {
+    std::memset(m_current, 0, sizeof(m_current));
+    std::memset(m_history, 0, sizeof(m_history));
+}
+
+void RenderStats::AddDraw(uint32_t vertices, uint32_t triangles, uint32_t instances) {
+    m_current[DRAW_CALLS] += 1;
+    m_current[VERTICES] += vertices * instances;
+    m_current[TRIANGLES] += triangles * instances;
+}
+
+void RenderStats::EndFrame() {
+    std::memcpy(m_history[m_historyNext], m_current, sizeof(m_current));
+    m_historyNext = (m_historyNext + 1) % HISTORY_FRAMES;
+    if (m_historySize < HISTORY_FRAMES) {
+        ++m_historySize;
+    }
+    std::memset(m_current, 0, sizeof(m_current));
+}
+
+uint32_t RenderStats::GetLast(Counter counter) const {
+    if (m_historySize == 0) {
+        return 0;
+    }
+    int last = (m_historyNext + HISTORY_FRAMES - 1) % HISTORY_FRAMES;
+    return m_history[last][counter];
+}
+
+RenderStats::Summary RenderStats::GetSummary(Counter counter) const {
+    Summary summary = {0, 0, 0.0f};
+    if (m_historySize == 0) {
+        return summary;
+    }
+
+    // Пока история не заполнена, занятые кадры лежат с начала массива
+    uint64_t total = 0;
+    summary.minimum = m_history[0][counter];
+    for (int i = 0; i < m_historySize; ++i) {
+        uint32_t value = m_history[i][counter];
+        if (value < summary.minimum) summary.minimum = value;
+        if (value > summary.maximum) summary.maximum = value;
+        total += value;
+    }
+    summary.average = static_cast<float>(static_cast<double>(total) / m_historySize);
+    return summary;
+}
+
+const char* RenderStats::GetCounterName(Counter counter) {
+    switch (counter) {
+        case DRAW_CALLS:       return "Draws";
+        case VERTICES:         return "Verts";
+        case TRIANGLES:        return "Tris";
+        case INSTANCES:        return "Instanced";
+        case TEXTURE_BINDS:    return "Tex binds";
+        case MATERIAL_CHANGES: return "Materials";
+        case MATRIX_LOADS:     return "Matrices";
+        case PROGRAM_CHANGES:  return "Programs";
+        case VISIBLE_OBJECTS:  return "Visible";
+        case CULLED_OBJECTS:   return "Culled";
+        default:               return "Unknown";
+    }
+}
+
+} // namespace Revolt
@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdint>
+
+namespace Revolt {
+
+// Счётчики работы рендерера за кадр и их минимум/среднее/максимум
+// за последние HISTORY_FRAMES завершённых кадров
+class RenderStats {
+public:
+    enum Counter {
+        DRAW_CALLS,       // glDrawElements и их инстансинговые версии
+        VERTICES,         // Вершины, отправленные этими вызовами (с учётом копий)
+        TRIANGLES,
+        INSTANCES,        // Объекты, нарисованные инстансингом
+        TEXTURE_BINDS,    // Привязки, дошедшие до драйвера
+        MATERIAL_CHANGES, // Смены цвета материала
+        MATRIX_LOADS,
+        PROGRAM_CHANGES,  // Переключения шейдерной программы
+        VISIBLE_OBJECTS,
+        CULLED_OBJECTS,
+        COUNTER_COUNT
+    };
+
+    struct Summary {
+        uint32_t minimum;
+        uint32_t maximum;
+        float average;
+    };
+
+    static const int HISTORY_FRAMES = 120;
+
+    RenderStats();
+
+    void Add(Counter counter, uint32_t amount = 1) { m_current[counter] += amount; }
+    void Set(Counter counter, uint32_t value) { m_current[counter] = value; }
+    void AddDraw(uint32_t vertices, uint32_t triangles, uint32_t instances = 1);
+
+    // Переносит текущий кадр в историю и обнуляет счётчики
+    void EndFrame();
+
+    // Значение за последний завершённый кадр
+    uint32_t GetLast(Counter counter) const;
+    // По истории; до первого кадра - нули
+    Summary GetSummary(Counter counter) const;
+    int GetFrameCount() const { return m_historySize; }
+
+    static const char* GetCounterName(Counter counter);
+
+private:
+    uint32_t m_current[COUNTER_COUNT];
+    uint32_t m_history[HISTORY_FRAMES][COUNTER_COUNT];
+    int m_historyNext;
+    int m_historySize;
+};
+
+} // namespace Revolt
@@ -1,91 +1,363 @@
 #include <GLFW/glfw3.h>
 #include "Renderer.h"
+#include "GLExtensions.h"
+#include "GLState.h"
+#include "core/Log.h"
 #include <cmath>
-#include <iostream>
+#include <string>
 
 namespace Revolt {
 
+namespace {
+
+// Номера атрибутов копии. 9-13 не пересекаются со встроенными атрибутами
+// (на NVIDIA gl_MultiTexCoord0 занимает 8)
+const GLuint INSTANCE_MATRIX_ATTRIB = 9; // 9, 10, 11, 12 - столбцы матрицы
+const GLuint INSTANCE_COLOR_ATTRIB = 13;
+const int INSTANCE_FLOATS = 20;
+const size_t MIN_INSTANCE_BATCH = 2;
+
+// GL_LIGHT0 с GL_COLOR_MATERIAL, как в фиксированном конвейере. normal - единичный, в координатах камеры.
+const char* LIGHTING_FUNCTIONS = R"(
+vec4 ApplyLighting(vec4 baseColor, vec3 normal, vec3 eyePosition) {
+    vec3 toLight = normalize(gl_LightSource[0].position.xyz - eyePosition);
+    float diffuse = max(dot(normal, toLight), 0.0);
+    vec3 color = baseColor.rgb * (gl_LightModel.ambient.rgb + gl_LightSource[0].ambient.rgb +
+                                  gl_LightSource[0].diffuse.rgb * diffuse);
+    if (diffuse > 0.0) {
+        vec3 halfVector = normalize(toLight + vec3(0.0, 0.0, 1.0));
+        color += gl_FrontMaterial.specular.rgb * gl_LightSource[0].specular.rgb *
+                 pow(max(dot(normal, halfVector), 0.0), gl_FrontMaterial.shininess);
+    }
+    return vec4(color, baseColor.a);
+}
+)";
+
+// Масштаб копий одинаков по осям (см. CanInstance), поэтому нормаль
+// поворачивается самой матрицей, а не обратной транспонированной
+const char* INSTANCING_VERTEX_SHADER = R"(
+attribute vec4 instanceMatrix0;
+attribute vec4 instanceMatrix1;
+attribute vec4 instanceMatrix2;
+attribute vec4 instanceMatrix3;
+attribute vec4 instanceColor;
+
+void main() {
+    mat4 modelView = mat4(instanceMatrix0, instanceMatrix1, instanceMatrix2, instanceMatrix3);
+    vec4 eyePosition = modelView * gl_Vertex;
+    vec3 normal = normalize(mat3(modelView) * gl_Normal);
+
+    gl_FrontColor = ApplyLighting(instanceColor, normal, eyePosition.xyz);
+    gl_BackColor = gl_FrontColor;
+    gl_TexCoord[0] = gl_MultiTexCoord0;
+    gl_Position = gl_ProjectionMatrix * eyePosition;
+}
+)";
+
+// Упакованные кадры MDL: xyz - 0..255 в сетке заголовка, w - индекс нормали в таблице anorms
+const char* PACKED_MDL_VERTEX_SHADER = R"(
+attribute vec4 packedFrame1;
+attribute vec4 packedFrame2;
+uniform vec3 frameScale;
+uniform vec3 frameTranslate;
+uniform float interp;
+uniform vec3 normalTable[162];
+
+vec3 DecodeNormal(float index) {
+    int i = int(index + 0.5);
+    return i < 162 ? normalTable[i] : vec3(0.0, 0.0, 1.0);
+}
+
+void main() {
+    vec3 position = mix(packedFrame1.xyz, packedFrame2.xyz, interp) * frameScale + frameTranslate;
+    vec3 normal = mix(DecodeNormal(packedFrame1.w), DecodeNormal(packedFrame2.w), interp);
+    normal = gl_NormalMatrix * normal;
+    // Встречные нормали при interp = 0.5 дают ноль
+    float lengthSq = dot(normal, normal);
+    normal = lengthSq > 1e-12 ? normal * inversesqrt(lengthSq) : vec3(0.0, 0.0, 1.0);
+
+    vec4 eyePosition = gl_ModelViewMatrix * vec4(position, 1.0);
+    gl_FrontColor = ApplyLighting(gl_Color, normal, eyePosition.xyz);
+    gl_BackColor = gl_FrontColor;
+    gl_TexCoord[0] = gl_MultiTexCoord0;
+    gl_Position = gl_ProjectionMatrix * eyePosition;
+}
+)";
+
+// Освещение вершин как у фиксированного конвейера - для палитровых скинов без инстансинга
+const char* FIXED_VERTEX_SHADER = R"(
+void main() {
+    vec4 eyePosition = gl_ModelViewMatrix * gl_Vertex;
+    vec3 normal = normalize(gl_NormalMatrix * gl_Normal);
+
+    gl_FrontColor = ApplyLighting(gl_Color, normal, eyePosition.xyz);
+    gl_BackColor = gl_FrontColor;
+    gl_TexCoord[0] = gl_MultiTexCoord0;
+    gl_Position = gl_ProjectionMatrix * eyePosition;
+}
+)";
+
+// skinMode: SKIN_NONE, SKIN_RGBA или SKIN_INDEXED (индекс в GL_LUMINANCE8 -> палитра 256x1)
+const char* SKIN_FRAGMENT_SHADER = R"(
+#version 120
+uniform sampler2D skinTexture;
+uniform sampler2D paletteTexture;
+uniform float skinMode;
+
+void main() {
+    vec4 color = gl_Color;
+    if (skinMode > 1.5) {
+        float index = texture2D(skinTexture, gl_TexCoord[0].st).r * 255.0;
+        color *= texture2D(paletteTexture, vec2((index + 0.5) / 256.0, 0.5));
+    } else if (skinMode > 0.5) {
+        color *= texture2D(skinTexture, gl_TexCoord[0].st);
+    }
+    gl_FragColor = color;
+}
+)";
+
+const float SKIN_NONE = 0.0f;
+const float SKIN_RGBA = 1.0f;
+const float SKIN_INDEXED = 2.0f;
+
+// Общие для всех программ сэмплеры: скин - блок 0, палитра - блок 1
+void BindSkinSamplers(const ShaderProgram& program) {
+    GLExtensions::Uniform1i(program.GetUniformLocation("skinTexture"), 0);
+    GLExtensions::Uniform1i(program.GetUniformLocation("paletteTexture"), 1);
+}
+
+std::string BuildVertexShader(const char* body) {
+    return std::string("#version 120\n") + LIGHTING_FUNCTIONS + body;
+}
+
+// Верхние 3x3 - поворот с одинаковым по всем осям масштабом: столбцы
+// попарно ортогональны и одной длины. Только для таких матриц нормаль,
+// повёрнутая самой матрицей, совпадает с gl_NormalMatrix после нормализации
+bool HasUniformScale(const Matrix4& matrix) {
+    const float* x = &matrix.m[0];
+    const float* y = &matrix.m[4];
+    const float* z = &matrix.m[8];
+    float xx = x[0] * x[0] + x[1] * x[1] + x[2] * x[2];
+    float yy = y[0] * y[0] + y[1] * y[1] + y[2] * y[2];
+    float zz = z[0] * z[0] + z[1] * z[1] + z[2] * z[2];
+    float xy = x[0] * y[0] + x[1] * y[1] + x[2] * y[2];
+    float yz = y[0] * z[0] + y[1] * z[1] + y[2] * z[2];
+    float zx = z[0] * x[0] + z[1] * x[1] + z[2] * x[2];
+    float tolerance = 1e-4f * (xx + yy + zz);
+    return std::fabs(xx - yy) <= tolerance && std::fabs(yy - zz) <= tolerance &&
+           std::fabs(xy) <= tolerance && std::fabs(yz) <= tolerance && std::fabs(zx) <= tolerance;
+}
+
+} // namespace
+
 Renderer::Renderer() 
-    : m_framebuffer(800, 600) {
+    : m_framebuffer(800, 600), m_visibleCount(0), m_culledCount(0), 
+      m_skinModeLocation(-1), m_instanceBuffer(0), m_instancingAllowed(true), m_gpuAnimationAllowed(true), 
+      m_paletteTexture(0) {
+}
+
+Renderer::~Renderer() {
+    if (!glfwGetCurrentContext()) {
+        return;
+    }
+    if (m_instanceBuffer) {
+        GLExtensions::DeleteBuffers(1, &m_instanceBuffer);
+    }
+    if (m_paletteTexture) {
+        GLState::DeleteTextures(1, &m_paletteTexture);
+    }
+}
+
+void Renderer::InitializeInstancing() {
+    if (m_instancingProgram.IsValid() || !GLExtensions::HasInstancing()) {
+        return;
+    }
+    
+    bool compiled = m_instancingProgram.Compile(BuildVertexShader(INSTANCING_VERTEX_SHADER).c_str(), SKIN_FRAGMENT_SHADER, {
+        {INSTANCE_MATRIX_ATTRIB + 0, "instanceMatrix0"},
+        {INSTANCE_MATRIX_ATTRIB + 1, "instanceMatrix1"},
+        {INSTANCE_MATRIX_ATTRIB + 2, "instanceMatrix2"},
+        {INSTANCE_MATRIX_ATTRIB + 3, "instanceMatrix3"},
+        {INSTANCE_COLOR_ATTRIB, "instanceColor"}
+    });
+    if (!compiled) {
+        REVOLT_LOG(Warning, Render, "Instancing shader unavailable, using per-object draws");
+        return;
+    }
+    
+    m_instancingProgram.Bind();
+    BindSkinSamplers(m_instancingProgram);
+    m_skinModeLocation = m_instancingProgram.GetUniformLocation("skinMode");
+    ShaderProgram::Unbind();
+    
+    GLExtensions::GenBuffers(1, &m_instanceBuffer);
+}
+
+void Renderer::InitializePackedMDL() {
+    if (m_packedMDLProgram.IsValid() || !GLExtensions::HasShaders() || !GLExtensions::HasVertexBufferObject()) {
+        return;
+    }
+    
+    // Таблица нормалей занимает 162 vec3 - на картах с минимальным лимитом
+    // uniform-переменных линковка не пройдёт, тогда смешиваем на CPU
+    bool compiled = m_packedMDLProgram.Compile(BuildVertexShader(PACKED_MDL_VERTEX_SHADER).c_str(), SKIN_FRAGMENT_SHADER, {
+        {MDLModel::PACKED_FRAME1_ATTRIB, "packedFrame1"},
+        {MDLModel::PACKED_FRAME2_ATTRIB, "packedFrame2"}
+    });
+    if (!compiled) {
+        REVOLT_LOG(Warning, Render, "Packed MDL shader unavailable, interpolating on CPU");
+        return;
+    }
+    
+    m_packedMDLProgram.Bind();
+    BindSkinSamplers(m_packedMDLProgram);
+    m_packedMDLUniforms.skinMode = m_packedMDLProgram.GetUniformLocation("skinMode");
+    m_packedMDLUniforms.scale = m_packedMDLProgram.GetUniformLocation("frameScale");
+    m_packedMDLUniforms.translate = m_packedMDLProgram.GetUniformLocation("frameTranslate");
+    m_packedMDLUniforms.interp = m_packedMDLProgram.GetUniformLocation("interp");
+    m_packedMDLUniforms.normalTable = m_packedMDLProgram.GetUniformLocation("normalTable");
+    m_packedMDLUniforms.normalsLoaded = false;
+    ShaderProgram::Unbind();
+}
+
+void Renderer::InitializePalettizedSkins() {
+    if (m_paletteProgram.IsValid() || !GLExtensions::HasShaders()) {
+        return;
+    }
+    
+    if (!m_paletteProgram.Compile(BuildVertexShader(FIXED_VERTEX_SHADER).c_str(), SKIN_FRAGMENT_SHADER)) {
+        REVOLT_LOG(Warning, Render, "Palette shader unavailable, skins will be expanded to RGBA");
+        return;
+    }
+    
+    m_paletteProgram.Bind();
+    BindSkinSamplers(m_paletteProgram);
+    GLExtensions::Uniform1f(m_paletteProgram.GetUniformLocation("skinMode"), SKIN_INDEXED);
+    ShaderProgram::Unbind();
+    
+    glGenTextures(1, &m_paletteTexture);
+    GLState::BindTexture(m_paletteTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    SetPalette(MDLModel::GetPalette());
+}
+
+void Renderer::SetPalette(const unsigned char* palette) {
+    if (!m_paletteTexture) {
+        return;
+    }
+    
+    // Индекс 255 - прозрачный, как при разворачивании скина в RGBA
+    unsigned char rgba[256 * 4];
+    for (int i = 0; i < 256; ++i) {
+        rgba[i * 4 + 0] = palette[i * 3 + 0];
+        rgba[i * 4 + 1] = palette[i * 3 + 1];
+        rgba[i * 4 + 2] = palette[i * 3 + 2];
+        rgba[i * 4 + 3] = i == 255 ? 0 : 255;
+    }
+    
+    GLState::BindTexture(m_paletteTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 256, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, rgba);
 }
 
 void Renderer::Initialize(int width, int height) {
     // Инициализируем framebuffer с разрешением рендеринга
-    m_framebuffer = Framebuffer(width, height);
-    if (!m_framebuffer.Initialize()) {
-        std::cerr << "Failed to initialize framebuffer!" << std::endl;
+    if (!m_framebuffer.Resize(width, height)) {
+        REVOLT_LOG(Error, Render, "Failed to initialize framebuffer!");
     }
     
     // Настройки OpenGL для 3D рендеринга
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_LIGHTING);
-    glEnable(GL_LIGHT0);
+    GLState::Enable(GL_DEPTH_TEST);
+    GLState::Enable(GL_LIGHTING);
+    GLState::Enable(GL_LIGHT0);
     
-    // НАСТРОЙКИ СВЕТА
-    float lightPos[] = {2.0f, 5.0f, 5.0f, 1.0f};
+    // НАСТРОЙКИ СВЕТА (позиция задаётся в FlushQueue относительно камеры)
     float lightColor[] = {1.0f, 1.0f, 1.0f, 1.0f};
     float ambientLight[] = {0.6f, 0.6f, 0.6f, 1.0f};
     
-    glLightfv(GL_LIGHT0, GL_POSITION, lightPos);
-    glLightfv(GL_LIGHT0, GL_DIFFUSE, lightColor);
-    glLightfv(GL_LIGHT0, GL_AMBIENT, ambientLight);
-    glLightfv(GL_LIGHT0, GL_SPECULAR, lightColor);
+    GLState::Light(GL_LIGHT0, GL_DIFFUSE, lightColor);
+    GLState::Light(GL_LIGHT0, GL_AMBIENT, ambientLight);
+    GLState::Light(GL_LIGHT0, GL_SPECULAR, lightColor);
     
-    glEnable(GL_NORMALIZE);
+    GLState::Enable(GL_NORMALIZE);
     
     // Дополнительные настройки для лучших цветов
-    glEnable(GL_COLOR_MATERIAL);
-    glColorMaterial(GL_FRONT, GL_AMBIENT_AND_DIFFUSE);
+    GLState::Enable(GL_COLOR_MATERIAL);
+    GLState::ColorMaterial(GL_FRONT, GL_AMBIENT_AND_DIFFUSE);
     
     // Устанавливаем цвет очистки
     glClearColor(0.2f, 0.3f, 0.4f, 1.0f); // Сине-зеленый
+    
+    InitializeInstancing();
+    InitializePackedMDL();
+    InitializePalettizedSkins();
+    m_gpuTimer.Initialize();
 }
 
 void Renderer::BeginFrame() {
+    GLState::BeginFrame();
+    m_gpuTimer.BeginFrame();
+    m_gpuTimer.BeginPass(GPUTimer::PASS_SCENE);
+    
     // Начинаем рендеринг в низком разрешении
     m_framebuffer.BeginRender();
     
+    // Вывод на экран и текст выключают их для 2D и не восстанавливают
+    GLState::Enable(GL_DEPTH_TEST);
+    GLState::Enable(GL_LIGHTING);
+    
+    m_frustum.Extract(m_camera.GetProjectionMatrix(), m_camera.GetViewMatrix());
+    m_visibleCount = 0;
+    m_culledCount = 0;
+    
     // Устанавливаем матрицу проекции для 3D сцены
-    glMatrixMode(GL_PROJECTION);
+    GLState::MatrixMode(GL_PROJECTION);
     glLoadMatrixf(m_camera.GetProjectionMatrix().m);
+    m_stats.Add(RenderStats::MATRIX_LOADS);
     
     // Переключаемся на MODELVIEW
-    glMatrixMode(GL_MODELVIEW);
+    GLState::MatrixMode(GL_MODELVIEW);
     glLoadIdentity();
 }
 
 void Renderer::EndFrame() {
+    // После оверлея время снова идёт сцене
+    m_gpuTimer.BeginPass(GPUTimer::PASS_SCENE);
+    
+    // Дорисовываем то, что осталось в очереди
+    FlushQueue();
+    
     // Заканчиваем рендеринг в низком разрешении и копируем в текстуру
     m_framebuffer.EndRender();
+    m_gpuTimer.EndPass();
+    
+    m_stats.Set(RenderStats::VISIBLE_OBJECTS, static_cast<uint32_t>(m_visibleCount));
+    m_stats.Set(RenderStats::CULLED_OBJECTS, static_cast<uint32_t>(m_culledCount));
+    m_stats.EndFrame();
 }
 
 void Renderer::RenderToScreen(int screenWidth, int screenHeight) {
     // Рендерим текстуру низкого разрешения на экран
+    m_gpuTimer.BeginPass(GPUTimer::PASS_SCREEN);
     m_framebuffer.RenderToScreen(screenWidth, screenHeight);
+    m_gpuTimer.EndPass();
 }
 
 void Renderer::RenderMesh(Mesh& mesh, const Matrix4& transform) {
-    // Отладочная информация
-    static int renderCount = 0;
-    if (renderCount++ % 60 == 0) { // Выводим каждые 60 кадров
-        std::cout << "Rendering mesh, transform: " 
-                  << transform.m[0] << ", " << transform.m[5] << ", " << transform.m[10] << std::endl;
-    }
-    
-    glMatrixMode(GL_MODELVIEW);
-    glLoadIdentity();
-    
-    // Загружаем матрицу вида камеры
-    glLoadMatrixf(m_camera.GetViewMatrix().m);
-    
-    // Обновляем позиции источников света относительно камеры
-    float lightPos[] = {5.0f, 5.0f, 5.0f, 1.0f};
-    glLightfv(GL_LIGHT0, GL_POSITION, lightPos);
+    // Отладочная информация (в сборке по умолчанию уровень Trace вырезан)
+    REVOLT_LOG_LIMITED(Trace, Render, 1000, "Rendering mesh, transform: %g, %g, %g",
+                       transform.m[0], transform.m[5], transform.m[10]);
     
-    // Применяем трансформацию объекта
-    glMultMatrixf(transform.m);
+    if (!m_frustum.Intersects(mesh.GetBounds().Transformed(transform))) {
+        ++m_culledCount;
+        return;
+    }
+    ++m_visibleCount;
     
-    mesh.Render();
+    // Вид камеры умножаем на CPU, чтобы при отрисовке хватило одного glLoadMatrixf
+    m_renderQueue.AddMesh(mesh, transform.Multiply(m_camera.GetViewMatrix()));
 }
 
 void Renderer::SetCamera(const Camera& camera) {
@@ -98,15 +370,312 @@ void Renderer::SetClearColor(float r, float g, float b, float a) {
 }
 
 void Renderer::RenderMDLModel(MDLModel& model, const Matrix4& transform, int frame) {
-    glPushMatrix();
+    if (!IsMDLModelVisible(model, transform, model.GetBounds(frame))) {
+        return;
+    }
+    
+    m_renderQueue.AddMDLModel(model, transform.Multiply(m_camera.GetViewMatrix()), frame);
+}
+
+void Renderer::RenderMDLModel(MDLModel& model, const Matrix4& transform, MDLPose& pose, 
+                              int frame1, int frame2, float interp) {
+    // Ровно на кадре смешивать нечего - такие копии ещё и объединяются инстансингом
+    if (frame1 == frame2 || interp <= 0.0f) {
+        RenderMDLModel(model, transform, frame1);
+        return;
+    }
+    if (interp >= 1.0f) {
+        RenderMDLModel(model, transform, frame2);
+        return;
+    }
+    
+    BoundingBox bounds = model.GetBounds(frame1);
+    bounds.Expand(model.GetBounds(frame2));
+    if (!IsMDLModelVisible(model, transform, bounds)) {
+        return;
+    }
+    
+    Matrix4 modelView = transform.Multiply(m_camera.GetViewMatrix());
+    
+    // На GPU смешивание бесплатно для CPU; иначе смешиваем только видимые объекты
+    if (m_gpuAnimationAllowed && m_packedMDLProgram.IsValid() && model.HasPackedFrames()) {
+        m_renderQueue.AddBlendedMDLModel(model, modelView, frame1, frame2, interp);
+        return;
+    }
+    
+    model.Interpolate(pose, frame1, frame2, interp);
+    m_renderQueue.AddMDLModel(model, modelView, frame1, &pose);
+}
+
+bool Renderer::IsMDLModelVisible(const MDLModel& model, const Matrix4& transform, const BoundingBox& bounds) {
+    // Сначала дешёвая проверка сферой из заголовка, затем AABB кадра
+    const float* m = transform.m;
+    float maxScaleSq = 0.0f;
+    for (int col = 0; col < 3; ++col) {
+        float lengthSq = m[col * 4] * m[col * 4] + m[col * 4 + 1] * m[col * 4 + 1] + m[col * 4 + 2] * m[col * 4 + 2];
+        if (lengthSq > maxScaleSq) maxScaleSq = lengthSq;
+    }
+    BoundingSphere sphere = {{m[12], m[13], m[14]}, model.GetBoundingRadius() * std::sqrt(maxScaleSq)};
+    
+    if (!m_frustum.Intersects(sphere) || !m_frustum.Intersects(bounds.Transformed(transform))) {
+        ++m_culledCount;
+        return false;
+    }
+    ++m_visibleCount;
+    return true;
+}
+
+void Renderer::FlushQueue() {
+    if (m_renderQueue.IsEmpty()) {
+        return;
+    }
+    
+    m_renderQueue.Sort();
+    
+    // Позиция света задаётся один раз за проход, относительно камеры
+    GLState::MatrixMode(GL_MODELVIEW);
+    glLoadMatrixf(m_camera.GetViewMatrix().m);
+    m_stats.Add(RenderStats::MATRIX_LOADS);
+    float lightPos[] = {5.0f, 5.0f, 5.0f, 1.0f};
+    GLState::LightPosition(GL_LIGHT0, lightPos, m_camera.GetViewMatrix().m);
+    
+    // Общее состояние материалов и исходное состояние для отслеживания
+    Material::ApplyCommonState();
+    GLState::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::Disable(GL_BLEND);
+    GLState::DepthMask(true);
+    GLState::Disable(GL_TEXTURE_2D);
+    
+    m_submitState.texture = false;
+    m_submitState.color = 0;
+    m_submitState.colorValid = false;
+    m_submitState.program = nullptr;
+    
+    // Палитра всё время на блоке 1; фиксированный конвейер его не использует
+    if (m_paletteTexture) {
+        GLState::ActiveTexture(GL_TEXTURE1);
+        GLState::BindTexture(m_paletteTexture);
+        GLState::ActiveTexture(GL_TEXTURE0);
+    }
+    
+    bool instancing = m_instancingAllowed && m_instancingProgram.IsValid();
+    size_t count = m_renderQueue.GetSize();
+    size_t i = 0;
+    
+    while (i < count) {
+        const DrawPacket& first = m_renderQueue.GetSorted(i);
+        
+        // Одинаковая непрозрачная геометрия после сортировки идёт подряд
+        size_t end = i + 1;
+        if (instancing) {
+            while (end < count && CanInstance(first, m_renderQueue.GetSorted(end))) {
+                ++end;
+            }
+        }
+        
+        if (end - i >= MIN_INSTANCE_BATCH) {
+            ApplyPacketState(first);
+            SubmitInstanced(i, end);
+            i = end;
+            continue;
+        }
+        
+        for (; i < end; ++i) {
+            const DrawPacket& packet = m_renderQueue.GetSorted(i);
+            ApplyPacketState(packet);
+            
+            if (packet.mdlModel && packet.interp > 0.0f && !packet.pose) {
+                SubmitPackedMDL(packet);
+                continue;
+            }
+            // Индексы палитры фиксированный конвейер не разберёт
+            bool indexedSkin = packet.mdlModel && packet.mdlModel->IsSkinIndexed() && m_submitState.texture;
+            UseProgram(indexedSkin ? &m_paletteProgram : nullptr);
+            
+            // MDL-модели рисуются белым цветом - цвет даёт текстура
+            uint32_t color = packet.mdlModel ? 0xFFFFFFFFu : packet.material.GetSortKey();
+            if (!m_submitState.colorValid || color != m_submitState.color) {
+                if (packet.mdlModel) {
+                    glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+                } else {
+                    packet.material.ApplyColor();
+                }
+                m_submitState.color = color;
+                m_submitState.colorValid = true;
+                m_stats.Add(RenderStats::MATERIAL_CHANGES);
+            }
+            
+            glLoadMatrixf(packet.modelView.m);
+            m_stats.Add(RenderStats::MATRIX_LOADS);
+            
+            if (packet.mesh) {
+                packet.mesh->Draw();
+                m_stats.AddDraw(static_cast<uint32_t>(packet.mesh->GetVertexCount()),
+                                static_cast<uint32_t>(packet.mesh->GetIndexCount() / 3));
+            } else {
+                if (packet.pose) {
+                    packet.mdlModel->DrawPose(*packet.pose);
+                } else {
+                    packet.mdlModel->Draw(packet.frame);
+                }
+                m_stats.AddDraw(static_cast<uint32_t>(packet.mdlModel->GetRenderVertexCount()),
+                                static_cast<uint32_t>(packet.mdlModel->GetIndexCount() / 3));
+            }
+        }
+    }
+    
+    // Возвращаем состояние, которое ожидают остальные проходы
+    UseProgram(nullptr);
+    GLState::Disable(GL_BLEND);
+    GLState::DepthMask(true);
+    GLState::Disable(GL_TEXTURE_2D);
     
-    // Применяем трансформацию объекта - ИСПРАВЛЕННАЯ СТРОКА
-    glMultMatrixf(transform.m);  // Используем прямое обращение к массиву
+    m_renderQueue.Clear();
+}
+
+void Renderer::ApplyPacketState(const DrawPacket& packet) {
+    // MDL-скины смешиваются по альфе (индекс 255 палитры прозрачен), но пишут глубину;
+    // прозрачные материалы не пишут глубину
+    unsigned int textureID = packet.mdlModel ? packet.mdlModel->GetTextureID() : 0;
+    bool wantBlend = packet.transparent || textureID != 0;
+    bool wantDepthWrite = !packet.transparent;
+    
+    // Повторные установки отбрасывает GLState
+    GLState::SetEnabled(GL_BLEND, wantBlend);
+    GLState::DepthMask(wantDepthWrite);
+    GLState::SetEnabled(GL_TEXTURE_2D, textureID != 0);
+    if (textureID && GLState::BindTexture(textureID)) {
+        m_stats.Add(RenderStats::TEXTURE_BINDS);
+    }
+    m_submitState.texture = textureID != 0;
+}
+
+bool Renderer::CanInstance(const DrawPacket& first, const DrawPacket& other) const {
+    // Прозрачные рисуются строго по порядку глубины - их не объединяем
+    if (first.transparent || other.transparent) {
+        return false;
+    }
+    // У смешанных кадров у каждого экземпляра свои вершины
+    if (first.pose || other.pose || first.interp > 0.0f || other.interp > 0.0f) {
+        return false;
+    }
+    // Шейдер копий поворачивает нормаль матрицей объекта - при неравном
+    // масштабе освещение разошлось бы с обычной отрисовкой
+    if (!HasUniformScale(first.modelView) || !HasUniformScale(other.modelView)) {
+        return false;
+    }
+    if (first.mesh) {
+        return other.mesh == first.mesh;
+    }
+    return other.mdlModel == first.mdlModel && other.frame == first.frame;
+}
+
+void Renderer::SubmitInstanced(size_t begin, size_t end) {
+    const DrawPacket& first = m_renderQueue.GetSorted(begin);
+    int instanceCount = static_cast<int>(end - begin);
+    
+    // Матрица и цвет каждой копии в одном потоке атрибутов
+    m_instanceData.resize(instanceCount * INSTANCE_FLOATS);
+    float* out = m_instanceData.data();
+    for (size_t i = begin; i < end; ++i) {
+        const DrawPacket& packet = m_renderQueue.GetSorted(i);
+        for (int k = 0; k < 16; ++k) {
+            out[k] = packet.modelView.m[k];
+        }
+        const float* color = packet.material.GetColor();
+        for (int k = 0; k < 4; ++k) {
+            out[16 + k] = packet.mdlModel ? 1.0f : color[k];
+        }
+        out += INSTANCE_FLOATS;
+    }
+    
+    GLExtensions::BindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+    GLExtensions::BufferData(GL_ARRAY_BUFFER, m_instanceData.size() * sizeof(float), m_instanceData.data(), GL_STREAM_DRAW);
+    
+    const GLsizei stride = INSTANCE_FLOATS * sizeof(float);
+    for (GLuint column = 0; column < 4; ++column) {
+        GLuint attrib = INSTANCE_MATRIX_ATTRIB + column;
+        GLExtensions::VertexAttribPointer(attrib, 4, GL_FLOAT, GL_FALSE, stride, 
+                                          reinterpret_cast<const void*>(column * 4 * sizeof(float)));
+        GLExtensions::EnableVertexAttribArray(attrib);
+        GLExtensions::VertexAttribDivisor(attrib, 1);
+    }
+    GLExtensions::VertexAttribPointer(INSTANCE_COLOR_ATTRIB, 4, GL_FLOAT, GL_FALSE, stride, 
+                                      reinterpret_cast<const void*>(16 * sizeof(float)));
+    GLExtensions::EnableVertexAttribArray(INSTANCE_COLOR_ATTRIB);
+    GLExtensions::VertexAttribDivisor(INSTANCE_COLOR_ATTRIB, 1);
+    GLExtensions::BindBuffer(GL_ARRAY_BUFFER, 0);
+    
+    UseProgram(&m_instancingProgram);
+    GLExtensions::Uniform1f(m_skinModeLocation, GetSkinMode(first));
     
-    // Рендерим MDL модель
-    model.Render(frame);
+    if (first.mesh) {
+        first.mesh->DrawInstanced(instanceCount);
+        m_stats.AddDraw(static_cast<uint32_t>(first.mesh->GetVertexCount()),
+                        static_cast<uint32_t>(first.mesh->GetIndexCount() / 3), instanceCount);
+    } else {
+        first.mdlModel->DrawInstanced(first.frame, instanceCount);
+        m_stats.AddDraw(static_cast<uint32_t>(first.mdlModel->GetRenderVertexCount()),
+                        static_cast<uint32_t>(first.mdlModel->GetIndexCount() / 3), instanceCount);
+    }
+    m_stats.Add(RenderStats::INSTANCES, static_cast<uint32_t>(instanceCount));
+    
+    
+    for (GLuint attrib = INSTANCE_MATRIX_ATTRIB; attrib <= INSTANCE_COLOR_ATTRIB; ++attrib) {
+        GLExtensions::VertexAttribDivisor(attrib, 0);
+        GLExtensions::DisableVertexAttribArray(attrib);
+    }
+}
+
+float Renderer::GetSkinMode(const DrawPacket& packet) const {
+    if (!m_submitState.texture) {
+        return SKIN_NONE;
+    }
+    return packet.mdlModel && packet.mdlModel->IsSkinIndexed() ? SKIN_INDEXED : SKIN_RGBA;
+}
+
+void Renderer::UseProgram(const ShaderProgram* program) {
+    if (program == m_submitState.program) {
+        return;
+    }
+    if (program) {
+        program->Bind();
+    } else {
+        ShaderProgram::Unbind();
+    }
+    m_submitState.program = program;
+    m_stats.Add(RenderStats::PROGRAM_CHANGES);
+}
+
+void Renderer::SubmitPackedMDL(const DrawPacket& packet) {
+    const MDLModel& model = *packet.mdlModel;
+    PackedMDLUniforms& uniforms = m_packedMDLUniforms;
+    UseProgram(&m_packedMDLProgram);
+    
+    // Таблица одна на все модели и хранится в программе
+    if (!uniforms.normalsLoaded) {
+        GLExtensions::Uniform3fv(uniforms.normalTable, MDLModel::NUM_NORMALS, model.GetNormalTable());
+        uniforms.normalsLoaded = true;
+    }
+    
+    const MDLHeader& header = model.GetHeader();
+    GLExtensions::Uniform3fv(uniforms.scale, 1, header.scale);
+    GLExtensions::Uniform3fv(uniforms.translate, 1, header.translate);
+    GLExtensions::Uniform1f(uniforms.interp, packet.interp);
+    GLExtensions::Uniform1f(uniforms.skinMode, GetSkinMode(packet));
+    
+    if (!m_submitState.colorValid || m_submitState.color != 0xFFFFFFFFu) {
+        glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+        m_submitState.color = 0xFFFFFFFFu;
+        m_submitState.colorValid = true;
+        m_stats.Add(RenderStats::MATERIAL_CHANGES);
+    }
     
-    glPopMatrix();
+    glLoadMatrixf(packet.modelView.m);
+    m_stats.Add(RenderStats::MATRIX_LOADS);
+    model.DrawPacked(packet.frame, packet.nextFrame);
+    m_stats.AddDraw(static_cast<uint32_t>(model.GetRenderVertexCount()),
+                    static_cast<uint32_t>(model.GetIndexCount() / 3));
 }
 
-} // namespace Revolt
\ No newline at end of file
+} // namespace Revolt
@@ -3,25 +3,116 @@
 #include "Mesh.h"
 #include "Framebuffer.h"
 #include "MDLModel.h"
+#include "RenderQueue.h"
+#include "ShaderProgram.h"
+#include "GPUTimer.h"
+#include "RenderStats.h"
+#include "../math/Frustum.h"
+#include <vector>
 
 namespace Revolt {
 
 class Renderer {
 public:
     Renderer();
+    ~Renderer();
     
     void Initialize(int width, int height);
     void BeginFrame();
     void EndFrame();
+    // RenderMesh/RenderMDLModel только ставят объект в очередь;
+    // отрисовка происходит в FlushQueue (или в EndFrame)
     void RenderMesh(Mesh& mesh, const Matrix4& transform);
     void SetCamera(const Camera& camera);
     void RenderToScreen(int screenWidth, int screenHeight);
     void SetClearColor(float r, float g, float b, float a);
     void RenderMDLModel(MDLModel& model, const Matrix4& transform, int frame = 0);
+    // Плавная анимация: видимые объекты смешивают кадры в свой pose
+    void RenderMDLModel(MDLModel& model, const Matrix4& transform, MDLPose& pose, 
+                        int frame1, int frame2, float interp);
+    // Сортирует и рисует накопленную очередь. Вызывать перед 2D-оверлеем.
+    void FlushQueue();
+    
+    // Результат отсечения по пирамиде видимости за текущий кадр
+    int GetVisibleCount() const { return m_visibleCount; }
+    int GetCulledCount() const { return m_culledCount; }
+    
+    // Инстансинг копий одного меша/MDL-кадра (если поддерживается драйвером)
+    bool IsInstancingEnabled() const { return m_instancingProgram.IsValid(); }
+    void SetInstancingEnabled(bool enabled) { m_instancingAllowed = enabled; }
+    
+    // Распаковка и смешивание кадров MDL в вершинном шейдере (иначе - на CPU)
+    bool IsGPUAnimationEnabled() const { return m_packedMDLProgram.IsValid(); }
+    void SetGPUAnimationEnabled(bool enabled) { m_gpuAnimationAllowed = enabled; }
+    
+    // Скины как индексы палитры: цвет выбирается во фрагментном шейдере.
+    // Если false, скины нужно загружать в RGBA (фиксированный конвейер).
+    bool SupportsPalettizedSkins() const { return m_paletteProgram.IsValid(); }
+    // Замена палитры (256 * RGB) сразу действует на все палитровые скины
+    void SetPalette(const unsigned char* palette);
+    
+    // Время проходов на GPU. Сцену Renderer отмечает сам (BeginFrame..EndFrame,
+    // RenderToScreen); оверлей между FlushQueue и EndFrame отмечают
+    // BeginGPUPass(GPUTimer::PASS_TEXT) - EndFrame возвращается к сцене.
+    void BeginGPUPass(GPUTimer::Pass pass) { m_gpuTimer.BeginPass(pass); }
+    const GPUTimer& GetGPUTimer() const { return m_gpuTimer; }
+    
+    // Счётчики сцены по завершённым кадрам (обновляются в EndFrame)
+    const RenderStats& GetStats() const { return m_stats; }
 
 private:
+    // Состояние, которое отслеживается при отрисовке очереди сверх GLState
+    struct SubmitState {
+        bool texture;    // Текущий пакет рисуется с текстурой
+        uint32_t color;
+        bool colorValid;
+        const ShaderProgram* program; // nullptr - фиксированный конвейер
+    };
+    
+    struct PackedMDLUniforms {
+        GLint skinMode;
+        GLint scale;
+        GLint translate;
+        GLint interp;
+        GLint normalTable;
+        bool normalsLoaded;
+    };
+    
+    void InitializeInstancing();
+    void InitializePackedMDL();
+    void InitializePalettizedSkins();
+    float GetSkinMode(const DrawPacket& packet) const;
+    void UseProgram(const ShaderProgram* program);
+    bool IsMDLModelVisible(const MDLModel& model, const Matrix4& transform, const BoundingBox& bounds);
+    void ApplyPacketState(const DrawPacket& packet);
+    bool CanInstance(const DrawPacket& first, const DrawPacket& other) const;
+    void SubmitInstanced(size_t begin, size_t end);
+    void SubmitPackedMDL(const DrawPacket& packet);
+    
+
     Camera m_camera;
     Framebuffer m_framebuffer; // Новый член
+    RenderQueue m_renderQueue;
+    Frustum m_frustum;
+    int m_visibleCount;
+    int m_culledCount;
+    
+    SubmitState m_submitState;
+    ShaderProgram m_instancingProgram;
+    GLint m_skinModeLocation;
+    unsigned int m_instanceBuffer;
+    std::vector<float> m_instanceData; // Матрица 4x4 + цвет на копию
+    bool m_instancingAllowed;
+    
+    ShaderProgram m_packedMDLProgram;
+    PackedMDLUniforms m_packedMDLUniforms;
+    bool m_gpuAnimationAllowed;
+    
+    ShaderProgram m_paletteProgram;  // Палитровые скины вне инстансинга и смешивания на GPU
+    unsigned int m_paletteTexture;   // 256x1 RGBA
+    
+    GPUTimer m_gpuTimer;
+    RenderStats m_stats;
 };
 
 } // namespace Revolt
\ No newline at end of file
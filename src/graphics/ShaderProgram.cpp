@@ -0,0 +1,97 @@
+#include "ShaderProgram.h"
+#include "GLExtensions.h"
+#include <iostream>
+
+namespace Revolt {
+
+ShaderProgram::ShaderProgram() : m_program(0) {
+}
+
+ShaderProgram::~ShaderProgram() {
+    Release();
+}
+
+void ShaderProgram::Release() {
+    if (m_program && glfwGetCurrentContext()) {
+        GLExtensions::DeleteProgram(m_program);
+    }
+    m_program = 0;
+}
+
+GLuint ShaderProgram::CompileShader(GLenum type, const char* source) {
+    GLuint shader = GLExtensions::CreateShader(type);
+    GLExtensions::ShaderSource(shader, 1, &source, nullptr);
+    GLExtensions::CompileShader(shader);
+    
+    GLint status = 0;
+    GLExtensions::GetShaderiv(shader, GL_COMPILE_STATUS, &status);
+    if (!status) {
+        GLint logLength = 0;
+        GLExtensions::GetShaderiv(shader, GL_INFO_LOG_LENGTH, &logLength);
+        std::string log(logLength > 0 ? logLength : 1, '\0');
+        GLExtensions::GetShaderInfoLog(shader, static_cast<GLsizei>(log.size()), nullptr, &log[0]);
+        std::cerr << (type == GL_VERTEX_SHADER ? "Vertex" : "Fragment") << " shader compile error: " << log << std::endl;
+        GLExtensions::DeleteShader(shader);
+        return 0;
+    }
+    
+    return shader;
+}
+
+bool ShaderProgram::Compile(const char* vertexSource, const char* fragmentSource,
+                            const std::vector<std::pair<GLuint, const char*>>& attributes) {
+    Release();
+    
+    if (!GLExtensions::HasShaders()) {
+        return false;
+    }
+    
+    GLuint vertexShader = CompileShader(GL_VERTEX_SHADER, vertexSource);
+    GLuint fragmentShader = CompileShader(GL_FRAGMENT_SHADER, fragmentSource);
+    if (!vertexShader || !fragmentShader) {
+        if (vertexShader) GLExtensions::DeleteShader(vertexShader);
+        if (fragmentShader) GLExtensions::DeleteShader(fragmentShader);
+        return false;
+    }
+    
+    GLuint program = GLExtensions::CreateProgram();
+    GLExtensions::AttachShader(program, vertexShader);
+    GLExtensions::AttachShader(program, fragmentShader);
+    for (const auto& attribute : attributes) {
+        GLExtensions::BindAttribLocation(program, attribute.first, attribute.second);
+    }
+    GLExtensions::LinkProgram(program);
+    
+    // Шейдеры остаются живыми, пока прикреплены к программе
+    GLExtensions::DeleteShader(vertexShader);
+    GLExtensions::DeleteShader(fragmentShader);
+    
+    GLint status = 0;
+    GLExtensions::GetProgramiv(program, GL_LINK_STATUS, &status);
+    if (!status) {
+        GLint logLength = 0;
+        GLExtensions::GetProgramiv(program, GL_INFO_LOG_LENGTH, &logLength);
+        std::string log(logLength > 0 ? logLength : 1, '\0');
+        GLExtensions::GetProgramInfoLog(program, static_cast<GLsizei>(log.size()), nullptr, &log[0]);
+        std::cerr << "Shader link error: " << log << std::endl;
+        GLExtensions::DeleteProgram(program);
+        return false;
+    }
+    
+    m_program = program;
+    return true;
+}
+
+void ShaderProgram::Bind() const {
+    GLExtensions::UseProgram(m_program);
+}
+
+void ShaderProgram::Unbind() {
+    GLExtensions::UseProgram(0);
+}
+
+GLint ShaderProgram::GetUniformLocation(const char* name) const {
+    return GLExtensions::GetUniformLocation(m_program, name);
+}
+
+} // namespace Revolt
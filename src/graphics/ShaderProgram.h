@@ -0,0 +1,38 @@
+#pragma once
+#include <GLFW/glfw3.h>
+#include <string>
+#include <vector>
+#include <utility>
+
+namespace Revolt {
+
+// Программа GLSL 1.20. Работает поверх фиксированного конвейера совместимого
+// профиля, поэтому шейдеры могут использовать gl_ModelViewMatrix, gl_LightSource и т.д.
+class ShaderProgram {
+public:
+    ShaderProgram();
+    ~ShaderProgram();
+
+    ShaderProgram(const ShaderProgram&) = delete;
+    ShaderProgram& operator=(const ShaderProgram&) = delete;
+
+    // attributes - явные номера пользовательских атрибутов (до линковки)
+    bool Compile(const char* vertexSource, const char* fragmentSource,
+                 const std::vector<std::pair<GLuint, const char*>>& attributes = {});
+    void Release();
+
+    bool IsValid() const { return m_program != 0; }
+    GLuint GetID() const { return m_program; }
+
+    void Bind() const;
+    static void Unbind();
+
+    GLint GetUniformLocation(const char* name) const;
+
+private:
+    static GLuint CompileShader(GLenum type, const char* source);
+
+    GLuint m_program;
+};
+
+} // namespace Revolt
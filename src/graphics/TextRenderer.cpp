@@ -1,17 +1,138 @@
 #include "TextRenderer.h"
+#include "GLExtensions.h"
+#include "GLState.h"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 namespace Revolt {
 
-TextRenderer::TextRenderer() 
-    : m_windowWidth(800), m_windowHeight(600), m_initialized(false), 
-      m_renderWidth(800), m_renderHeight(600) {
+namespace {
+
+const float LINE_HALF_WIDTH = 0.7f;   // Штрихи прежней толщины glLineWidth(1.4)
+const float POINT_RADIUS = 1.5f;      // Точки glPointSize(3 * scale), в единицах шрифта
+const float PIXEL_SCALE_STEP = 0.25f; // Шаг размеров, для которых строятся атласы
+const float MAX_PIXEL_SCALE = 8.0f;   // Крупнее - растягиваем атлас этого размера
+
+const uint8_t BACKGROUND_COLOR[4] = {0, 0, 0, 128};
+const uint8_t TEXT_COLOR[4] = {255, 255, 255, 255};
+
+int NextPowerOfTwo(int value) {
+    int result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+float SegmentDistance(float px, float py, float x0, float y0, float x1, float y1) {
+    float dx = x1 - x0;
+    float dy = y1 - y0;
+    float lengthSq = dx * dx + dy * dy;
+    float t = 0.0f;
+    if (lengthSq > 0.0f) {
+        t = std::max(0.0f, std::min(1.0f, ((px - x0) * dx + (py - y0) * dy) / lengthSq));
+    }
+    float cx = x0 + t * dx - px;
+    float cy = y0 + t * dy - py;
+    return std::sqrt(cx * cx + cy * cy);
+}
+
+} // namespace
+
+TextBuffer& TextBuffer::Clear() {
+    m_length = 0;
+    m_data[0] = '\0';
+    return *this;
+}
+
+TextBuffer& TextBuffer::Append(const char* text) {
+    while (*text && m_length < CAPACITY) {
+        m_data[m_length++] = *text++;
+    }
+    m_data[m_length] = '\0';
+    return *this;
+}
+
+TextBuffer& TextBuffer::Append(char c) {
+    if (m_length < CAPACITY) {
+        m_data[m_length++] = c;
+        m_data[m_length] = '\0';
+    }
+    return *this;
+}
+
+TextBuffer& TextBuffer::Append(int value) {
+    // Цифры собираются с конца; unsigned не переполняется на INT_MIN
+    char digits[12];
+    int count = 0;
+    unsigned int magnitude = value < 0 ? 0u - static_cast<unsigned int>(value) : static_cast<unsigned int>(value);
+    do {
+        digits[count++] = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+
+    if (value < 0) {
+        Append('-');
+    }
+    while (count > 0) {
+        Append(digits[--count]);
+    }
+    return *this;
+}
+
+TextBuffer& TextBuffer::Append(float value, int decimals) {
+    if (!(value == value)) {
+        return Append("NAN");
+    }
+    if (value < 0.0f) {
+        Append('-');
+        value = -value;
+    }
+
+    // Округляем до нужного знака заранее, чтобы 0.999 с двумя знаками дало 1.00
+    int scale = 1;
+    for (int i = 0; i < decimals; ++i) {
+        scale *= 10;
+    }
+    double scaled = static_cast<double>(value) * scale + 0.5;
+    if (scaled > 2147483647.0) {
+        return Append("INF");
+    }
+    int fixed = static_cast<int>(scaled);
+
+    Append(fixed / scale);
+    if (decimals > 0) {
+        Append('.');
+        int fraction = fixed % scale;
+        for (int divisor = scale / 10; divisor > 0; divisor /= 10) {
+            Append(static_cast<char>('0' + (fraction / divisor) % 10));
+        }
+    }
+    return *this;
+}
+
+TextRenderer::TextRenderer()
+    : m_windowWidth(800), m_windowHeight(600), m_initialized(false),
+      m_renderWidth(800), m_renderHeight(600),
+      m_recordTarget(nullptr), m_strokeMode(GL_LINES) {
 }
 
 TextRenderer::~TextRenderer() {
+    // Контекст мог быть уничтожен раньше
+    if (glfwGetCurrentContext()) {
+        for (GlyphAtlas& atlas : m_atlases) {
+            if (atlas.textureID) {
+                GLState::DeleteTextures(1, &atlas.textureID);
+            }
+        }
+    }
 }
 
 bool TextRenderer::Initialize() {
+    // Штрихи разбираются один раз; атлас каждого размера растеризуется
+    // при первой строке этого размера и дальше только переиспользуется
+    BuildGlyphStrokes();
     m_initialized = true;
     return true;
 }
@@ -27,74 +148,374 @@ void TextRenderer::SetRenderResolution(int width, int height) {
 }
 
 void TextRenderer::RenderText(const std::string& text, float x, float y, float scale) {
+    QueueText(text, x, y, scale);
+    Flush();
+}
+
+void TextRenderer::QueueText(const std::string& text, float x, float y, float scale) {
+    if (!m_initialized || text.empty()) return;
+
+    GlyphAtlas& atlas = GetAtlas(scale);
+    LayoutText(text.c_str(), text.length(), x, y, scale, atlas, atlas.vertices);
+}
+
+TextRenderer::TextHandle TextRenderer::CreateTextBlock() {
+    size_t index = 0;
+    while (index < m_textBlocks.size() && m_textBlocks[index].active) {
+        ++index;
+    }
+    if (index == m_textBlocks.size()) {
+        m_textBlocks.emplace_back();
+    }
+
+    TextBlock& block = m_textBlocks[index];
+    block.text.clear();
+    block.x = 0.0f;
+    block.y = 0.0f;
+    block.scale = 1.0f;
+    block.pixelScale = 0.0f;
+    block.dirty = true;
+    block.active = true;
+    block.vertices.clear();
+    return static_cast<TextHandle>(index);
+}
+
+void TextRenderer::DestroyTextBlock(TextHandle handle) {
+    if (handle < 0 || handle >= static_cast<TextHandle>(m_textBlocks.size())) return;
+    // Слот и его память переиспользуются следующим CreateTextBlock
+    m_textBlocks[handle].active = false;
+}
+
+void TextRenderer::SetTextBlock(TextHandle handle, const char* text, float x, float y, float scale) {
+    if (handle < 0 || handle >= static_cast<TextHandle>(m_textBlocks.size())) return;
+
+    TextBlock& block = m_textBlocks[handle];
+    if (block.text != text) {
+        // Ёмкость строки сохраняется - одинаковая длина не аллоцирует
+        block.text.assign(text);
+        block.dirty = true;
+    }
+    if (block.x != x || block.y != y || block.scale != scale) {
+        block.x = x;
+        block.y = y;
+        block.scale = scale;
+        block.dirty = true;
+    }
+}
+
+void TextRenderer::QueueTextBlock(TextHandle handle) {
+    if (!m_initialized || handle < 0 || handle >= static_cast<TextHandle>(m_textBlocks.size())) return;
+
+    TextBlock& block = m_textBlocks[handle];
+    if (!block.active || block.text.empty()) return;
+
+    // Атлас меняется вместе с разрешением рендеринга
+    GlyphAtlas& atlas = GetAtlas(block.scale);
+    if (block.dirty || block.pixelScale != atlas.pixelScale) {
+        block.vertices.clear();
+        LayoutText(block.text.c_str(), block.text.length(), block.x, block.y, block.scale,
+                   atlas, block.vertices);
+        block.pixelScale = atlas.pixelScale;
+        block.dirty = false;
+    }
+
+    atlas.vertices.insert(atlas.vertices.end(), block.vertices.begin(), block.vertices.end());
+}
+
+void TextRenderer::QueueRect(float x, float y, float width, float height, const uint8_t color[4]) {
     if (!m_initialized) return;
-    
-    // Сохраняем текущие настройки OpenGL
-    glPushAttrib(GL_ALL_ATTRIB_BITS);
-    glPushMatrix();
-    
-    // Устанавливаем 2D проекцию (координаты: 0,0 в левом ВЕРХНЕМ углу)
-    glMatrixMode(GL_PROJECTION);
-    glPushMatrix();
-    glLoadIdentity();
-    glOrtho(0, m_windowWidth, m_windowHeight, 0, -1, 1); // 0,0 в верхнем левом углу
 
-    glMatrixMode(GL_MODELVIEW);
-    glPushMatrix();
-    glLoadIdentity();
+    // Подойдёт любой атлас: сплошная ячейка есть в каждом
+    GlyphAtlas& atlas = m_atlases.empty() ? GetAtlas(1.0f) : m_atlases.front();
+    float solidU = 0.5f * atlas.cellWidth / atlas.width;
+    float solidV = 0.5f * atlas.cellHeight / atlas.height;
+    AddQuad(atlas.vertices, x, y, x + width, y + height, solidU, solidV, solidU, solidV, color);
+}
 
-    // Настройки для 2D рендеринга
-    glDisable(GL_LIGHTING);
-    glDisable(GL_DEPTH_TEST);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glDisable(GL_TEXTURE_2D);
+void TextRenderer::LayoutText(const char* text, size_t length, float x, float y, float scale,
+                              const GlyphAtlas& atlas, std::vector<TextVertex>& vertices) const {
+    float texelU = 1.0f / atlas.width;
+    float texelV = 1.0f / atlas.height;
 
-    // Рисуем фон (прямоугольник под текстом)
-    float bgWidth = text.length() * 12 * scale;
+    // Фон (прямоугольник под текстом) берёт центр сплошной ячейки 0
+    float solidU = 0.5f * atlas.cellWidth * texelU;
+    float solidV = 0.5f * atlas.cellHeight * texelV;
+    float bgWidth = length * 12 * scale;
     float bgHeight = 20 * scale;
+    AddQuad(vertices, x - 8, y, x + bgWidth, y + bgHeight,
+            solidU, solidV, solidU, solidV, BACKGROUND_COLOR);
+
+    // Пиксель атласа в координатах окна
+    float texelSize = scale / atlas.pixelScale;
+    float cellWidth = atlas.cellWidth * texelSize;
+    float cellHeight = atlas.cellHeight * texelSize;
+    float padding = CELL_PADDING * texelSize;
 
-    glColor4f(0.0f, 0.0f, 0.0f, 0.5f);
-    glBegin(GL_QUADS);
-    glVertex2f(x - 8, y); // Верхний левый
-    glVertex2f(x + bgWidth, y); // Верхний правый
-    glVertex2f(x + bgWidth, y + bgHeight); // Нижний правый
-    glVertex2f(x - 8, y + bgHeight); // Нижний левый
-    glEnd();
-
-    // Цвет текста - БЕЛЫЙ, тонкие линии
-    glColor3f(1.0f, 1.0f, 1.0f);
-    glLineWidth(1.4f);
-    
     float currentX = x;
-    
-    for (size_t i = 0; i < text.length(); ++i) {
+
+    for (size_t i = 0; i < length; ++i) {
         char c = text[i];
-        
+
         if (c == ' ') {
             currentX += 8 * scale;
             continue;
         }
-        
-        // Рисуем символы (переворачиваем Y-координаты)
-        if (c >= '0' && c <= '9') {
-            DrawDigit(c, currentX, y, scale);
-        } else if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z')) {
-            DrawLetter(c, currentX, y, scale);
-        } else {
-            DrawSymbol(c, currentX, y, scale);
-        }
-        
+
+        int index = GetGlyphIndex(c);
+        int cellX = (index % ATLAS_COLUMNS) * atlas.cellWidth;
+        int cellY = (index / ATLAS_COLUMNS) * atlas.cellHeight;
+
+        float x0 = currentX - padding;
+        float y0 = y - padding;
+        AddQuad(vertices, x0, y0, x0 + cellWidth, y0 + cellHeight,
+                cellX * texelU, cellY * texelV,
+                (cellX + atlas.cellWidth) * texelU, (cellY + atlas.cellHeight) * texelV,
+                TEXT_COLOR);
+
         currentX += 12 * scale;
     }
-    
+}
+
+void TextRenderer::Flush() {
+    bool hasVertices = false;
+    for (const GlyphAtlas& atlas : m_atlases) {
+        hasVertices = hasVertices || !atlas.vertices.empty();
+    }
+    if (!hasVertices) return;
+
+    // Флаги, смешивание и текстура идут через GLState: следующий проход сам
+    // устанавливает нужное, а совпадающее отбрасывается. Сохраняем только
+    // клиентские массивы, их GLState не отслеживает
+    glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+
+    // Устанавливаем 2D проекцию (координаты: 0,0 в левом ВЕРХНЕМ углу)
+    GLState::MatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glLoadIdentity();
+    glOrtho(0, m_windowWidth, m_windowHeight, 0, -1, 1);
+
+    GLState::MatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+
+    GLState::Disable(GL_LIGHTING);
+    GLState::Disable(GL_DEPTH_TEST);
+    GLState::Disable(GL_CULL_FACE);
+    GLState::Enable(GL_BLEND);
+    GLState::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::Enable(GL_TEXTURE_2D);
+    // Цвет из вершин, альфа умножается на покрытие из атласа
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+
+    // Клиентские массивы читаются из памяти, а не из буфера
+    if (GLExtensions::HasVertexBufferObject()) {
+        GLExtensions::BindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_NORMAL_ARRAY);
+
+    for (GlyphAtlas& atlas : m_atlases) {
+        if (atlas.vertices.empty()) continue;
+
+        if (!atlas.textureID) {
+            UploadAtlas(atlas);
+        }
+        GLState::BindTexture(atlas.textureID);
+
+        const TextVertex* data = atlas.vertices.data();
+        glVertexPointer(2, GL_FLOAT, sizeof(TextVertex), &data->x);
+        glTexCoordPointer(2, GL_FLOAT, sizeof(TextVertex), &data->u);
+        glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(TextVertex), data->color);
+        glDrawArrays(GL_QUADS, 0, static_cast<GLsizei>(atlas.vertices.size()));
+
+        // Ёмкость сохраняется - в установившемся режиме аллокаций нет
+        atlas.vertices.clear();
+    }
+
     // Восстанавливаем настройки
+    GLState::MatrixMode(GL_PROJECTION);
     glPopMatrix();
-    glMatrixMode(GL_PROJECTION);
-    glPopMatrix();
-    glMatrixMode(GL_MODELVIEW);
+    GLState::MatrixMode(GL_MODELVIEW);
     glPopMatrix();
-    glPopAttrib();
+    glPopClientAttrib();
+}
+
+void TextRenderer::AddQuad(std::vector<TextVertex>& vertices, float x0, float y0, float x1, float y1,
+                           float u0, float v0, float u1, float v1, const uint8_t color[4]) {
+    const float corners[4][4] = {
+        {x0, y0, u0, v0}, // Верхний левый
+        {x1, y0, u1, v0}, // Верхний правый
+        {x1, y1, u1, v1}, // Нижний правый
+        {x0, y1, u0, v1}  // Нижний левый
+    };
+    for (const float* corner : corners) {
+        TextVertex vertex;
+        vertex.x = corner[0];
+        vertex.y = corner[1];
+        vertex.u = corner[2];
+        vertex.v = corner[3];
+        std::copy(color, color + 4, vertex.color);
+        vertices.push_back(vertex);
+    }
+}
+
+int TextRenderer::GetGlyphIndex(char c) {
+    unsigned char code = static_cast<unsigned char>(c);
+    if (code > ' ' && code < 127) {
+        return code - ' ';
+    }
+    return GLYPH_COUNT - 1;
+}
+
+TextRenderer::GlyphAtlas& TextRenderer::GetAtlas(float scale) {
+    // Глиф растеризуется в пикселях цели рендеринга, а не окна: так штрихи
+    // сохраняют прежнюю толщину в 1.4 пикселя при любом разрешении
+    float density = m_windowHeight > 0 ? static_cast<float>(m_renderHeight) / m_windowHeight : 1.0f;
+    float pixelScale = std::round(scale * density / PIXEL_SCALE_STEP) * PIXEL_SCALE_STEP;
+    pixelScale = std::max(PIXEL_SCALE_STEP, std::min(MAX_PIXEL_SCALE, pixelScale));
+
+    for (GlyphAtlas& atlas : m_atlases) {
+        if (atlas.pixelScale == pixelScale) {
+            return atlas;
+        }
+    }
+
+    GlyphAtlas atlas;
+    atlas.pixelScale = pixelScale;
+    atlas.cellWidth = static_cast<int>(std::ceil(8 * pixelScale)) + 2 * CELL_PADDING;
+    atlas.cellHeight = static_cast<int>(std::ceil(12 * pixelScale)) + 2 * CELL_PADDING;
+    atlas.width = NextPowerOfTwo(ATLAS_COLUMNS * atlas.cellWidth);
+    atlas.height = NextPowerOfTwo((GLYPH_COUNT / ATLAS_COLUMNS) * atlas.cellHeight);
+    atlas.textureID = 0;
+    RasterizeAtlas(atlas);
+
+    m_atlases.push_back(std::move(atlas));
+    return m_atlases.back();
+}
+
+void TextRenderer::RasterizeAtlas(GlyphAtlas& atlas) const {
+    atlas.pixels.assign(static_cast<size_t>(atlas.width) * atlas.height, 0);
+    float pixelScale = atlas.pixelScale;
+
+    for (int index = 0; index < GLYPH_COUNT; ++index) {
+        int cellX = (index % ATLAS_COLUMNS) * atlas.cellWidth;
+        int cellY = (index / ATLAS_COLUMNS) * atlas.cellHeight;
+        const GlyphStrokes& glyph = m_glyphs[index];
+
+        for (int py = 0; py < atlas.cellHeight; ++py) {
+            uint8_t* row = &atlas.pixels[static_cast<size_t>(cellY + py) * atlas.width + cellX];
+
+            for (int px = 0; px < atlas.cellWidth; ++px) {
+                if (index == 0) {
+                    row[px] = 255;
+                    continue;
+                }
+
+                // Центр пикселя в единицах шрифта
+                float fx = (px + 0.5f - CELL_PADDING) / pixelScale;
+                float fy = (py + 0.5f - CELL_PADDING) / pixelScale;
+                float coverage = 0.0f;
+
+                // Покрытие линией толщиной 1.4 пикселя со сглаживанием в один пиксель
+                for (size_t i = 0; i < glyph.lines.size(); i += 4) {
+                    float distance = SegmentDistance(fx, fy, glyph.lines[i], glyph.lines[i + 1],
+                                                     glyph.lines[i + 2], glyph.lines[i + 3]) * pixelScale;
+                    coverage = std::max(coverage, LINE_HALF_WIDTH + 0.5f - distance);
+                }
+                for (size_t i = 0; i < glyph.points.size(); i += 2) {
+                    float dx = fx - glyph.points[i];
+                    float dy = fy - glyph.points[i + 1];
+                    float distance = std::sqrt(dx * dx + dy * dy) * pixelScale;
+                    coverage = std::max(coverage, POINT_RADIUS * pixelScale + 0.5f - distance);
+                }
+
+                coverage = std::max(0.0f, std::min(1.0f, coverage));
+                row[px] = static_cast<uint8_t>(coverage * 255.0f + 0.5f);
+            }
+        }
+    }
+}
+
+void TextRenderer::UploadAtlas(GlyphAtlas& atlas) {
+    glGenTextures(1, &atlas.textureID);
+    GLState::BindTexture(atlas.textureID);
+
+    // Квады стоят на дробных координатах, поэтому фильтрация линейная;
+    // прозрачная рамка ячеек не даёт соседям просвечивать
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA8, atlas.width, atlas.height, 0,
+                 GL_ALPHA, GL_UNSIGNED_BYTE, atlas.pixels.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    std::cout << "Glyph atlas: " << atlas.width << "x" << atlas.height
+              << " (glyph scale " << atlas.pixelScale << ")" << std::endl;
+
+    std::vector<uint8_t>().swap(atlas.pixels);
+}
+
+void TextRenderer::BuildGlyphStrokes() {
+    // Прежние процедуры рисования глифов записывают штрихи, а не рисуют их
+    for (int index = 1; index < GLYPH_COUNT; ++index) {
+        m_recordTarget = &m_glyphs[index];
+        m_recordTarget->lines.clear();
+        m_recordTarget->points.clear();
+
+        // Последняя ячейка - рамка неизвестного символа
+        char c = index < GLYPH_COUNT - 1 ? static_cast<char>(' ' + index) : '\0';
+        if (c >= '0' && c <= '9') {
+            DrawDigit(c, 0.0f, 0.0f, 1.0f);
+        } else if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z')) {
+            DrawLetter(c, 0.0f, 0.0f, 1.0f);
+        } else {
+            DrawSymbol(c, 0.0f, 0.0f, 1.0f);
+        }
+    }
+    m_recordTarget = nullptr;
+}
+
+void TextRenderer::BeginStroke(GLenum mode) {
+    m_strokeMode = mode;
+    m_strokeVertices.clear();
+}
+
+void TextRenderer::StrokeVertex(float x, float y) {
+    m_strokeVertices.push_back(x);
+    m_strokeVertices.push_back(y);
+}
+
+void TextRenderer::EndStroke() {
+    if (!m_recordTarget) return;
+
+    std::vector<float>& lines = m_recordTarget->lines;
+    const std::vector<float>& v = m_strokeVertices;
+    size_t count = v.size() / 2;
+
+    switch (m_strokeMode) {
+        case GL_POINTS:
+            m_recordTarget->points.insert(m_recordTarget->points.end(), v.begin(), v.end());
+            break;
+        case GL_LINES:
+            lines.insert(lines.end(), v.begin(), v.begin() + (count / 2) * 4);
+            break;
+        case GL_LINE_STRIP:
+        case GL_LINE_LOOP:
+            for (size_t i = 1; i < count; ++i) {
+                lines.insert(lines.end(), v.begin() + (i - 1) * 2, v.begin() + (i + 1) * 2);
+            }
+            if (m_strokeMode == GL_LINE_LOOP && count > 2) {
+                lines.insert(lines.end(), v.end() - 2, v.end());
+                lines.insert(lines.end(), v.begin(), v.begin() + 2);
+            }
+            break;
+    }
 }
 
 void TextRenderer::DrawDigit(char digit, float x, float y, float scale) {
@@ -104,74 +525,74 @@ void TextRenderer::DrawDigit(char digit, float x, float y, float scale) {
     // ИСПРАВЛЕНИЕ: переворачиваем Y-координаты
     switch (digit) {
         case '0':
-            glBegin(GL_LINE_LOOP);
-            glVertex2f(x, y); glVertex2f(x + w, y); 
-            glVertex2f(x + w, y + h); glVertex2f(x, y + h);
-            glEnd();
+            BeginStroke(GL_LINE_LOOP);
+            StrokeVertex(x, y); StrokeVertex(x + w, y); 
+            StrokeVertex(x + w, y + h); StrokeVertex(x, y + h);
+            EndStroke();
             break;
         case '1':
-            glBegin(GL_LINES);
-            glVertex2f(x + w/2, y); glVertex2f(x + w/2, y + h);
-            glEnd();
+            BeginStroke(GL_LINES);
+            StrokeVertex(x + w/2, y); StrokeVertex(x + w/2, y + h);
+            EndStroke();
             break;
         case '2':
-            glBegin(GL_LINE_STRIP);
-            glVertex2f(x, y); glVertex2f(x + w, y); // ВЕРХ
-            glVertex2f(x + w, y + h/2); glVertex2f(x, y + h/2);
-            glVertex2f(x, y + h); glVertex2f(x + w, y + h); // НИЗ
-            glEnd();
+            BeginStroke(GL_LINE_STRIP);
+            StrokeVertex(x, y); StrokeVertex(x + w, y); // ВЕРХ
+            StrokeVertex(x + w, y + h/2); StrokeVertex(x, y + h/2);
+            StrokeVertex(x, y + h); StrokeVertex(x + w, y + h); // НИЗ
+            EndStroke();
             break;
         case '3':
-            glBegin(GL_LINE_STRIP);
-            glVertex2f(x, y); glVertex2f(x + w, y); // ВЕРХ
-            glVertex2f(x + w, y + h); glVertex2f(x, y + h); // НИЗ
-            glEnd();
-            glBegin(GL_LINES);
-            glVertex2f(x, y + h/2); glVertex2f(x + w*0.7f, y + h/2);
-            glEnd();
+            BeginStroke(GL_LINE_STRIP);
+            StrokeVertex(x, y); StrokeVertex(x + w, y); // ВЕРХ
+            StrokeVertex(x + w, y + h); StrokeVertex(x, y + h); // НИЗ
+            EndStroke();
+            BeginStroke(GL_LINES);
+            StrokeVertex(x, y + h/2); StrokeVertex(x + w*0.7f, y + h/2);
+            EndStroke();
             break;
         case '4':
-            glBegin(GL_LINES);
-            glVertex2f(x, y); glVertex2f(x, y + h/2); // Левая вертикаль
-            glVertex2f(x, y + h/2); glVertex2f(x + w, y + h/2); // Горизонталь
-            glVertex2f(x + w, y); glVertex2f(x + w, y + h); // Правая вертикаль
-            glEnd();
+            BeginStroke(GL_LINES);
+            StrokeVertex(x, y); StrokeVertex(x, y + h/2); // Левая вертикаль
+            StrokeVertex(x, y + h/2); StrokeVertex(x + w, y + h/2); // Горизонталь
+            StrokeVertex(x + w, y); StrokeVertex(x + w, y + h); // Правая вертикаль
+            EndStroke();
             break;
         case '5':
-            glBegin(GL_LINE_STRIP);
-            glVertex2f(x + w, y); glVertex2f(x, y); // ВЕРХ
-            glVertex2f(x, y + h/2); glVertex2f(x + w, y + h/2);
-            glVertex2f(x + w, y + h); glVertex2f(x, y + h); // НИЗ
-            glEnd();
+            BeginStroke(GL_LINE_STRIP);
+            StrokeVertex(x + w, y); StrokeVertex(x, y); // ВЕРХ
+            StrokeVertex(x, y + h/2); StrokeVertex(x + w, y + h/2);
+            StrokeVertex(x + w, y + h); StrokeVertex(x, y + h); // НИЗ
+            EndStroke();
             break;
         case '6':
-            glBegin(GL_LINE_STRIP);
-            glVertex2f(x + w, y); glVertex2f(x, y); // ВЕРХ
-            glVertex2f(x, y + h); glVertex2f(x + w, y + h); // НИЗ
-            glVertex2f(x + w, y + h/2); glVertex2f(x, y + h/2);
-            glEnd();
+            BeginStroke(GL_LINE_STRIP);
+            StrokeVertex(x + w, y); StrokeVertex(x, y); // ВЕРХ
+            StrokeVertex(x, y + h); StrokeVertex(x + w, y + h); // НИЗ
+            StrokeVertex(x + w, y + h/2); StrokeVertex(x, y + h/2);
+            EndStroke();
             break;
         case '7':
-            glBegin(GL_LINE_STRIP);
-            glVertex2f(x, y); glVertex2f(x + w, y); // ВЕРХ
-            glVertex2f(x + w, y + h); // НИЗ
-            glEnd();
+            BeginStroke(GL_LINE_STRIP);
+            StrokeVertex(x, y); StrokeVertex(x + w, y); // ВЕРХ
+            StrokeVertex(x + w, y + h); // НИЗ
+            EndStroke();
             break;
         case '8':
-            glBegin(GL_LINE_LOOP);
-            glVertex2f(x, y); glVertex2f(x + w, y); 
-            glVertex2f(x + w, y + h); glVertex2f(x, y + h);
-            glEnd();
-            glBegin(GL_LINES);
-            glVertex2f(x, y + h/2); glVertex2f(x + w, y + h/2);
-            glEnd();
+            BeginStroke(GL_LINE_LOOP);
+            StrokeVertex(x, y); StrokeVertex(x + w, y); 
+            StrokeVertex(x + w, y + h); StrokeVertex(x, y + h);
+            EndStroke();
+            BeginStroke(GL_LINES);
+            StrokeVertex(x, y + h/2); StrokeVertex(x + w, y + h/2);
+            EndStroke();
             break;
         case '9':
-            glBegin(GL_LINE_STRIP);
-            glVertex2f(x, y + h); glVertex2f(x, y); // Левая сторона
-            glVertex2f(x + w, y); glVertex2f(x + w, y + h); // Правая сторона
-            glVertex2f(x, y + h/2); glVertex2f(x + w, y + h/2); // Средняя линия
-            glEnd();
+            BeginStroke(GL_LINE_STRIP);
+            StrokeVertex(x, y + h); StrokeVertex(x, y); // Левая сторона
+            StrokeVertex(x + w, y); StrokeVertex(x + w, y + h); // Правая сторона
+            StrokeVertex(x, y + h/2); StrokeVertex(x + w, y + h/2); // Средняя линия
+            EndStroke();
             break;
     }
 }
@@ -183,195 +604,195 @@ void TextRenderer::DrawLetter(char letter, float x, float y, float scale) {
     // ИСПРАВЛЕНИЕ: переворачиваем Y-координаты
     switch (letter) {
         case 'a': case 'A':
-            glBegin(GL_LINE_LOOP);
-            glVertex2f(x, y); glVertex2f(x + w, y);
-            glVertex2f(x + w, y + h); glVertex2f(x, y + h);
-            glEnd();
-            glBegin(GL_LINES);
-            glVertex2f(x, y + h/2); glVertex2f(x + w, y + h/2);
-            glEnd();
+            BeginStroke(GL_LINE_LOOP);
+            StrokeVertex(x, y); StrokeVertex(x + w, y);
+            StrokeVertex(x + w, y + h); StrokeVertex(x, y + h);
+            EndStroke();
+            BeginStroke(GL_LINES);
+            StrokeVertex(x, y + h/2); StrokeVertex(x + w, y + h/2);
+            EndStroke();
             break;
         case 'b': case 'B':
-            glBegin(GL_LINE_STRIP);
-            glVertex2f(x, y + h); // Начинаем снизу слева
-            glVertex2f(x, y); // Поднимаемся вверх
-            glVertex2f(x + w*0.7f, y); // Верхняя горизонталь
-            glVertex2f(x + w, y + h*0.3f); // Верхний правый изгиб
-            glVertex2f(x + w*0.7f, y + h/2); // Средняя горизонталь справа
-            glVertex2f(x + w, y + h*0.7f); // Нижний правый изгиб
-            glVertex2f(x + w*0.7f, y + h); // Нижняя горизонталь
-            glVertex2f(x, y + h); // Замыкаем в начальной точке
-            glEnd();
+            BeginStroke(GL_LINE_STRIP);
+            StrokeVertex(x, y + h); // Начинаем снизу слева
+            StrokeVertex(x, y); // Поднимаемся вверх
+            StrokeVertex(x + w*0.7f, y); // Верхняя горизонталь
+            StrokeVertex(x + w, y + h*0.3f); // Верхний правый изгиб
+            StrokeVertex(x + w*0.7f, y + h/2); // Средняя горизонталь справа
+            StrokeVertex(x + w, y + h*0.7f); // Нижний правый изгиб
+            StrokeVertex(x + w*0.7f, y + h); // Нижняя горизонталь
+            StrokeVertex(x, y + h); // Замыкаем в начальной точке
+            EndStroke();
             break;
         case 'c': case 'C':
-            glBegin(GL_LINE_STRIP);
-            glVertex2f(x + w, y); glVertex2f(x, y); // ВЕРХ
-            glVertex2f(x, y + h); glVertex2f(x + w, y + h); // НИЗ
-            glEnd();
+            BeginStroke(GL_LINE_STRIP);
+            StrokeVertex(x + w, y); StrokeVertex(x, y); // ВЕРХ
+            StrokeVertex(x, y + h); StrokeVertex(x + w, y + h); // НИЗ
+            EndStroke();
             break;
         case 'd': case 'D':
-            glBegin(GL_LINE_STRIP);
-            glVertex2f(x, y); glVertex2f(x, y + h);
-            glVertex2f(x + w*0.7f, y + h); glVertex2f(x + w, y + h/2);
-            glVertex2f(x + w*0.7f, y); glVertex2f(x, y);
-            glEnd();
+            BeginStroke(GL_LINE_STRIP);
+            StrokeVertex(x, y); StrokeVertex(x, y + h);
+            StrokeVertex(x + w*0.7f, y + h); StrokeVertex(x + w, y + h/2);
+            StrokeVertex(x + w*0.7f, y); StrokeVertex(x, y);
+            EndStroke();
             break;
         case 'e': case 'E':
-            glBegin(GL_LINE_STRIP);
-            glVertex2f(x + w, y); glVertex2f(x, y); // ВЕРХ
-            glVertex2f(x, y + h); glVertex2f(x + w, y + h); // НИЗ
-            glEnd();
-            glBegin(GL_LINES);
-            glVertex2f(x, y + h/2); glVertex2f(x + w*0.7f, y + h/2);
-            glEnd();
+            BeginStroke(GL_LINE_STRIP);
+            StrokeVertex(x + w, y); StrokeVertex(x, y); // ВЕРХ
+            StrokeVertex(x, y + h); StrokeVertex(x + w, y + h); // НИЗ
+            EndStroke();
+            BeginStroke(GL_LINES);
+            StrokeVertex(x, y + h/2); StrokeVertex(x + w*0.7f, y + h/2);
+            EndStroke();
             break;
         case 'f': case 'F':
-            glBegin(GL_LINE_STRIP);
-            glVertex2f(x + w*0.7f, y); // Верхняя точка правой части
-            glVertex2f(x, y); // Верхний левый угол
-            glVertex2f(x, y + h); // Левая вертикаль вниз
-            glEnd();
-            glBegin(GL_LINES);
-            glVertex2f(x, y + h/2); glVertex2f(x + w*0.7f, y + h/2); // Средняя горизонталь
-            glEnd();
+            BeginStroke(GL_LINE_STRIP);
+            StrokeVertex(x + w*0.7f, y); // Верхняя точка правой части
+            StrokeVertex(x, y); // Верхний левый угол
+            StrokeVertex(x, y + h); // Левая вертикаль вниз
+            EndStroke();
+            BeginStroke(GL_LINES);
+            StrokeVertex(x, y + h/2); StrokeVertex(x + w*0.7f, y + h/2); // Средняя горизонталь
+            EndStroke();
             break;
         case 'g': case 'G':
-            glBegin(GL_LINE_STRIP);
-            glVertex2f(x + w, y); glVertex2f(x, y); // ВЕРХ
-            glVertex2f(x, y + h); glVertex2f(x + w, y + h); // НИЗ
-            glVertex2f(x + w, y + h/2); glVertex2f(x + w/2, y + h/2);
-            glEnd();
+            BeginStroke(GL_LINE_STRIP);
+            StrokeVertex(x + w, y); StrokeVertex(x, y); // ВЕРХ
+            StrokeVertex(x, y + h); StrokeVertex(x + w, y + h); // НИЗ
+            StrokeVertex(x + w, y + h/2); StrokeVertex(x + w/2, y + h/2);
+            EndStroke();
             break;
         case 'h': case 'H':
-            glBegin(GL_LINES);
-            glVertex2f(x, y); glVertex2f(x, y + h);
-            glVertex2f(x + w, y); glVertex2f(x + w, y + h);
-            glVertex2f(x, y + h/2); glVertex2f(x + w, y + h/2);
-            glEnd();
+            BeginStroke(GL_LINES);
+            StrokeVertex(x, y); StrokeVertex(x, y + h);
+            StrokeVertex(x + w, y); StrokeVertex(x + w, y + h);
+            StrokeVertex(x, y + h/2); StrokeVertex(x + w, y + h/2);
+            EndStroke();
             break;
         case 'i': case 'I':
-            glBegin(GL_LINES);
-            glVertex2f(x + w/2, y); glVertex2f(x + w/2, y + h);
-            glEnd();
+            BeginStroke(GL_LINES);
+            StrokeVertex(x + w/2, y); StrokeVertex(x + w/2, y + h);
+            EndStroke();
             break;
         case 'j': case 'J':
-            glBegin(GL_LINE_STRIP);
-            glVertex2f(x + w, y); glVertex2f(x + w/2, y); // ВЕРХ
-            glVertex2f(x + w/2, y + h); // НИЗ
-            glEnd();
+            BeginStroke(GL_LINE_STRIP);
+            StrokeVertex(x + w, y); StrokeVertex(x + w/2, y); // ВЕРХ
+            StrokeVertex(x + w/2, y + h); // НИЗ
+            EndStroke();
             break;
         case 'k': case 'K':
-            glBegin(GL_LINES);
-            glVertex2f(x, y); glVertex2f(x, y + h);
-            glVertex2f(x + w, y + h); glVertex2f(x, y + h/2);
-            glVertex2f(x, y + h/2); glVertex2f(x + w, y);
-            glEnd();
+            BeginStroke(GL_LINES);
+            StrokeVertex(x, y); StrokeVertex(x, y + h);
+            StrokeVertex(x + w, y + h); StrokeVertex(x, y + h/2);
+            StrokeVertex(x, y + h/2); StrokeVertex(x + w, y);
+            EndStroke();
             break;
         case 'l': case 'L':
-            glBegin(GL_LINE_STRIP);
-            glVertex2f(x, y); glVertex2f(x, y + h);
-            glVertex2f(x + w, y + h);
-            glEnd();
+            BeginStroke(GL_LINE_STRIP);
+            StrokeVertex(x, y); StrokeVertex(x, y + h);
+            StrokeVertex(x + w, y + h);
+            EndStroke();
             break;
         case 'm': case 'M':
-            glBegin(GL_LINE_STRIP);
-            glVertex2f(x, y + h); glVertex2f(x, y); // Левая сторона
-            glVertex2f(x + w/2, y + h/2); glVertex2f(x + w, y); // Правая сторона
-            glVertex2f(x + w, y + h);
-            glEnd();
+            BeginStroke(GL_LINE_STRIP);
+            StrokeVertex(x, y + h); StrokeVertex(x, y); // Левая сторона
+            StrokeVertex(x + w/2, y + h/2); StrokeVertex(x + w, y); // Правая сторона
+            StrokeVertex(x + w, y + h);
+            EndStroke();
             break;
         case 'n': case 'N':
-            glBegin(GL_LINE_STRIP);
-            glVertex2f(x, y + h); glVertex2f(x, y); // Левая сторона
-            glVertex2f(x + w, y + h); glVertex2f(x + w, y); // Правая сторона
-            glEnd();
+            BeginStroke(GL_LINE_STRIP);
+            StrokeVertex(x, y + h); StrokeVertex(x, y); // Левая сторона
+            StrokeVertex(x + w, y + h); StrokeVertex(x + w, y); // Правая сторона
+            EndStroke();
             break;
         case 'o': case 'O':
-            glBegin(GL_LINE_LOOP);
-            glVertex2f(x, y); glVertex2f(x + w, y); 
-            glVertex2f(x + w, y + h); glVertex2f(x, y + h);
-            glEnd();
+            BeginStroke(GL_LINE_LOOP);
+            StrokeVertex(x, y); StrokeVertex(x + w, y); 
+            StrokeVertex(x + w, y + h); StrokeVertex(x, y + h);
+            EndStroke();
             break;
         case 'p': case 'P':
-            glBegin(GL_LINE_STRIP);
-            glVertex2f(x, y + h); glVertex2f(x, y); // Левая сторона
-            glVertex2f(x + w, y); glVertex2f(x + w, y + h/2); // Верхняя часть
-            glVertex2f(x, y + h/2); // Средняя линия
-            glEnd();
+            BeginStroke(GL_LINE_STRIP);
+            StrokeVertex(x, y + h); StrokeVertex(x, y); // Левая сторона
+            StrokeVertex(x + w, y); StrokeVertex(x + w, y + h/2); // Верхняя часть
+            StrokeVertex(x, y + h/2); // Средняя линия
+            EndStroke();
             break;
         case 'q': case 'Q':
-            glBegin(GL_LINE_LOOP);
-            glVertex2f(x, y); glVertex2f(x + w, y); 
-            glVertex2f(x + w, y + h); glVertex2f(x, y + h);
-            glEnd();
-            glBegin(GL_LINES);
-            glVertex2f(x + w/2, y + h/2); glVertex2f(x + w, y + h);
-            glEnd();
+            BeginStroke(GL_LINE_LOOP);
+            StrokeVertex(x, y); StrokeVertex(x + w, y); 
+            StrokeVertex(x + w, y + h); StrokeVertex(x, y + h);
+            EndStroke();
+            BeginStroke(GL_LINES);
+            StrokeVertex(x + w/2, y + h/2); StrokeVertex(x + w, y + h);
+            EndStroke();
             break;
         case 'r': case 'R':
-            glBegin(GL_LINE_STRIP);
-            glVertex2f(x, y + h); glVertex2f(x, y); // Левая сторона
-            glVertex2f(x + w, y); glVertex2f(x + w, y + h/2); // Верхняя часть
-            glVertex2f(x, y + h/2); glVertex2f(x + w, y + h); // Диагональ
-            glEnd();
+            BeginStroke(GL_LINE_STRIP);
+            StrokeVertex(x, y + h); StrokeVertex(x, y); // Левая сторона
+            StrokeVertex(x + w, y); StrokeVertex(x + w, y + h/2); // Верхняя часть
+            StrokeVertex(x, y + h/2); StrokeVertex(x + w, y + h); // Диагональ
+            EndStroke();
             break;
         case 's': case 'S':
-            glBegin(GL_LINE_STRIP);
-            glVertex2f(x + w, y); glVertex2f(x, y); // ВЕРХ
-            glVertex2f(x, y + h/2); glVertex2f(x + w, y + h/2);
-            glVertex2f(x + w, y + h); glVertex2f(x, y + h); // НИЗ
-            glEnd();
+            BeginStroke(GL_LINE_STRIP);
+            StrokeVertex(x + w, y); StrokeVertex(x, y); // ВЕРХ
+            StrokeVertex(x, y + h/2); StrokeVertex(x + w, y + h/2);
+            StrokeVertex(x + w, y + h); StrokeVertex(x, y + h); // НИЗ
+            EndStroke();
             break;
         case 't': case 'T':
-            glBegin(GL_LINES);
-            glVertex2f(x + w/2, y); glVertex2f(x + w/2, y + h);
-            glVertex2f(x, y); glVertex2f(x + w, y); // ВЕРХ
-            glEnd();
+            BeginStroke(GL_LINES);
+            StrokeVertex(x + w/2, y); StrokeVertex(x + w/2, y + h);
+            StrokeVertex(x, y); StrokeVertex(x + w, y); // ВЕРХ
+            EndStroke();
             break;
         case 'u': case 'U':
-            glBegin(GL_LINE_STRIP);
-            glVertex2f(x, y); glVertex2f(x, y + h); // Левая сторона
-            glVertex2f(x + w, y + h); glVertex2f(x + w, y); // Правая сторона
-            glEnd();
+            BeginStroke(GL_LINE_STRIP);
+            StrokeVertex(x, y); StrokeVertex(x, y + h); // Левая сторона
+            StrokeVertex(x + w, y + h); StrokeVertex(x + w, y); // Правая сторона
+            EndStroke();
             break;
         case 'v': case 'V':
-            glBegin(GL_LINES);
-            glVertex2f(x, y); glVertex2f(x + w/2, y + h); // Левая диагональ
-            glVertex2f(x + w/2, y + h); glVertex2f(x + w, y); // Правая диагональ
-            glEnd();
+            BeginStroke(GL_LINES);
+            StrokeVertex(x, y); StrokeVertex(x + w/2, y + h); // Левая диагональ
+            StrokeVertex(x + w/2, y + h); StrokeVertex(x + w, y); // Правая диагональ
+            EndStroke();
             break;
         case 'w': case 'W':
-            glBegin(GL_LINE_STRIP);
-            glVertex2f(x, y); glVertex2f(x, y + h); // Левая сторона
-            glVertex2f(x + w/2, y + h/2); glVertex2f(x + w, y + h); // Средняя часть
-            glVertex2f(x + w, y); // Правая сторона
-            glEnd();
+            BeginStroke(GL_LINE_STRIP);
+            StrokeVertex(x, y); StrokeVertex(x, y + h); // Левая сторона
+            StrokeVertex(x + w/2, y + h/2); StrokeVertex(x + w, y + h); // Средняя часть
+            StrokeVertex(x + w, y); // Правая сторона
+            EndStroke();
             break;
         case 'x': case 'X':
-            glBegin(GL_LINES);
-            glVertex2f(x, y); glVertex2f(x + w, y + h);
-            glVertex2f(x + w, y); glVertex2f(x, y + h);
-            glEnd();
+            BeginStroke(GL_LINES);
+            StrokeVertex(x, y); StrokeVertex(x + w, y + h);
+            StrokeVertex(x + w, y); StrokeVertex(x, y + h);
+            EndStroke();
             break;
         case 'y': case 'Y':
-            glBegin(GL_LINES);
-            glVertex2f(x, y); glVertex2f(x + w/2, y + h/2); // Левая ветвь
-            glVertex2f(x + w/2, y + h/2); glVertex2f(x + w, y); // Правая ветвь
-            glVertex2f(x + w/2, y + h/2); glVertex2f(x + w/2, y + h); // Ствол
-            glEnd();
+            BeginStroke(GL_LINES);
+            StrokeVertex(x, y); StrokeVertex(x + w/2, y + h/2); // Левая ветвь
+            StrokeVertex(x + w/2, y + h/2); StrokeVertex(x + w, y); // Правая ветвь
+            StrokeVertex(x + w/2, y + h/2); StrokeVertex(x + w/2, y + h); // Ствол
+            EndStroke();
             break;
         case 'z': case 'Z':
-            glBegin(GL_LINE_STRIP);
-            glVertex2f(x, y); glVertex2f(x + w, y); // ВЕРХ
-            glVertex2f(x, y + h); glVertex2f(x + w, y + h); // НИЗ
-            glEnd();
+            BeginStroke(GL_LINE_STRIP);
+            StrokeVertex(x, y); StrokeVertex(x + w, y); // ВЕРХ
+            StrokeVertex(x, y + h); StrokeVertex(x + w, y + h); // НИЗ
+            EndStroke();
             break;
         default:
             // Простой прямоугольник для неизвестных букв
-            glBegin(GL_LINE_LOOP);
-            glVertex2f(x, y); glVertex2f(x + w, y); 
-            glVertex2f(x + w, y + h); glVertex2f(x, y + h);
-            glEnd();
+            BeginStroke(GL_LINE_LOOP);
+            StrokeVertex(x, y); StrokeVertex(x + w, y); 
+            StrokeVertex(x + w, y + h); StrokeVertex(x, y + h);
+            EndStroke();
     }
 }
 
@@ -381,60 +802,55 @@ void TextRenderer::DrawSymbol(char symbol, float x, float y, float scale) {
     
     switch (symbol) {
         case '`': // Символ `
-            glBegin(GL_LINES);
-            glVertex2f(x + w*0.7f, y); glVertex2f(x + w*0.3f, y + h*0.3f);
-            glEnd();
+            BeginStroke(GL_LINES);
+            StrokeVertex(x + w*0.7f, y); StrokeVertex(x + w*0.3f, y + h*0.3f);
+            EndStroke();
             break;
         case ' ': // Пробел - ничего не рисуем
             break;
         case ':': // ИСПРАВЛЕННОЕ двоеточие
-            glEnable(GL_POINT_SMOOTH);
-            glPointSize(3.0f * scale);
-            glBegin(GL_POINTS);
-            glVertex2f(x + w/2, y + h/4);
-            glVertex2f(x + w/2, y + 3*h/4);
-            glEnd();
-            glDisable(GL_POINT_SMOOTH);
+            BeginStroke(GL_POINTS);
+            StrokeVertex(x + w/2, y + h/4);
+            StrokeVertex(x + w/2, y + 3*h/4);
+            EndStroke();
             break;
         case '/': // ИСПРАВЛЕННЫЙ слэш
-            glBegin(GL_LINES);
-            glVertex2f(x + w, y); glVertex2f(x, y + h);
-            glEnd();
+            BeginStroke(GL_LINES);
+            StrokeVertex(x + w, y); StrokeVertex(x, y + h);
+            EndStroke();
             break;
         case '-': // Дефис
-            glBegin(GL_LINES);
-            glVertex2f(x, y + h/2); glVertex2f(x + w, y + h/2);
-            glEnd();
+            BeginStroke(GL_LINES);
+            StrokeVertex(x, y + h/2); StrokeVertex(x + w, y + h/2);
+            EndStroke();
             break;
         case '.': // Точка
-            glEnable(GL_POINT_SMOOTH);
-            glPointSize(3.0f * scale);
-            glBegin(GL_POINTS);
-            glVertex2f(x + w/2, y + h/8);
-            glEnd();
-            glDisable(GL_POINT_SMOOTH);
+            BeginStroke(GL_POINTS);
+            StrokeVertex(x + w/2, y + h/8);
+            EndStroke();
             break;
         case '(': // Левая скобка
-            glBegin(GL_LINE_STRIP);
-            glVertex2f(x + w, y); 
-            glVertex2f(x + w/2, y + h/2);
-            glVertex2f(x + w, y + h);
-            glEnd();
+            BeginStroke(GL_LINE_STRIP);
+            StrokeVertex(x + w, y); 
+            StrokeVertex(x + w/2, y + h/2);
+            StrokeVertex(x + w, y + h);
+            EndStroke();
             break;
         case ')': // Правая скобка
-            glBegin(GL_LINE_STRIP);
-            glVertex2f(x, y); 
-            glVertex2f(x + w/2, y + h/2);
-            glVertex2f(x, y + h);
-            glEnd();
+            BeginStroke(GL_LINE_STRIP);
+            StrokeVertex(x, y); 
+            StrokeVertex(x + w/2, y + h/2);
+            StrokeVertex(x, y + h);
+            EndStroke();
             break;
         default:
             // Простой прямоугольник для неизвестных символов
-            glBegin(GL_LINE_LOOP);
-            glVertex2f(x, y); glVertex2f(x + w, y); 
-            glVertex2f(x + w, y + h); glVertex2f(x, y + h);
-            glEnd();
+            BeginStroke(GL_LINE_LOOP);
+            StrokeVertex(x, y); StrokeVertex(x + w, y); 
+            StrokeVertex(x + w, y + h); StrokeVertex(x, y + h);
+            EndStroke();
     }
 }
 
-} // namespace Revolt
\ No newline at end of file
+
+} // namespace Revolt
@@ -1,29 +1,144 @@
 #pragma once
 #include <string>
+#include <vector>
+#include <cstdint>
 #include <GLFW/glfw3.h>
 
 namespace Revolt {
 
+// Строка фиксированной ёмкости: числа форматируются без аллокаций,
+// лишнее обрезается
+class TextBuffer {
+public:
+    static const size_t CAPACITY = 127;
+
+    TextBuffer() { Clear(); }
+
+    TextBuffer& Clear();
+    TextBuffer& Append(const char* text);
+    TextBuffer& Append(char c);
+    TextBuffer& Append(int value);
+    TextBuffer& Append(float value, int decimals);
+
+    const char* GetString() const { return m_data; }
+    size_t GetLength() const { return m_length; }
+
+private:
+    char m_data[CAPACITY + 1];
+    size_t m_length;
+};
+
+// Отладочный текст. Штриховые глифы один раз растеризуются в атлас (текстура
+// GL_ALPHA), а строки собираются в массив текстурированных квадов: всё, что
+// поставлено в очередь за кадр, рисуется одним glDrawArrays на размер шрифта.
 class TextRenderer {
 public:
     TextRenderer();
     ~TextRenderer();
-    
+
+    TextRenderer(const TextRenderer&) = delete;
+    TextRenderer& operator=(const TextRenderer&) = delete;
+
     bool Initialize();
+    // Рисует строку сразу (QueueText + Flush)
     void RenderText(const std::string& text, float x, float y, float scale = 1.0f);
+    // Добавляет строку в пакет кадра; рисуется при Flush
+    void QueueText(const std::string& text, float x, float y, float scale = 1.0f);
+    void Flush();
+
+    // Сохранённые блоки текста: геометрия перестраивается, только когда
+    // меняются строка, позиция, масштаб или атлас, иначе копируется готовая
+    typedef int TextHandle;
+    static const TextHandle INVALID_TEXT_HANDLE = -1;
+
+    TextHandle CreateTextBlock();
+    void DestroyTextBlock(TextHandle handle);
+    void SetTextBlock(TextHandle handle, const char* text, float x, float y, float scale = 1.0f);
+    // Добавляет блок в пакет кадра, как QueueText
+    void QueueTextBlock(TextHandle handle);
+
+    // Сплошной прямоугольник в координатах окна (графики оверлея); рисуется
+    // при Flush вместе с текстом из сплошной ячейки атласа
+    void QueueRect(float x, float y, float width, float height, const uint8_t color[4]);
+
     void SetWindowSize(int width, int height);
     void SetRenderResolution(int width, int height);
 
 private:
+    // Ячейка 0 атласа - сплошной белый (фон строк), 1..94 - печатные ASCII,
+    // последняя - рамка для неизвестных символов
+    static const int GLYPH_COUNT = 96;
+    static const int ATLAS_COLUMNS = 16;
+    static const int CELL_PADDING = 2; // Прозрачная рамка ячейки в пикселях атласа
+
+    // Штрихи глифа в единицах шрифта (ячейка 8x12 при scale = 1)
+    struct GlyphStrokes {
+        std::vector<float> lines;  // x0, y0, x1, y1
+        std::vector<float> points; // x, y
+    };
+
+    struct TextVertex {
+        float x, y;
+        float u, v;
+        uint8_t color[4];
+    };
+
+    // Атлас для одного размера глифа в пикселях цели рендеринга
+    struct GlyphAtlas {
+        float pixelScale;
+        int cellWidth;
+        int cellHeight;
+        int width;
+        int height;
+        GLuint textureID;            // 0 - пиксели ещё не загружены
+        std::vector<uint8_t> pixels; // Освобождается после загрузки
+        std::vector<TextVertex> vertices;
+    };
+
+    struct TextBlock {
+        std::string text;
+        float x;
+        float y;
+        float scale;
+        float pixelScale; // Размер атласа, под который построены вершины
+        bool dirty;
+        bool active;
+        std::vector<TextVertex> vertices;
+    };
+
+    void LayoutText(const char* text, size_t length, float x, float y, float scale,
+                    const GlyphAtlas& atlas, std::vector<TextVertex>& vertices) const;
+
     void DrawDigit(char digit, float x, float y, float scale);
     void DrawLetter(char letter, float x, float y, float scale);
     void DrawSymbol(char symbol, float x, float y, float scale);
-    
+
+    // Запись штрихов вместо glBegin/glVertex2f/glEnd
+    void BeginStroke(GLenum mode);
+    void StrokeVertex(float x, float y);
+    void EndStroke();
+
+    void BuildGlyphStrokes();
+    GlyphAtlas& GetAtlas(float scale);
+    void RasterizeAtlas(GlyphAtlas& atlas) const;
+    void UploadAtlas(GlyphAtlas& atlas);
+    static int GetGlyphIndex(char c);
+    static void AddQuad(std::vector<TextVertex>& vertices, float x0, float y0, float x1, float y1,
+                        float u0, float v0, float u1, float v1, const uint8_t color[4]);
+
     int m_windowWidth;
     int m_windowHeight;
     bool m_initialized;
     int m_renderWidth;
-    int m_renderHeight; 
+    int m_renderHeight;
+
+    GlyphStrokes m_glyphs[GLYPH_COUNT];
+    GlyphStrokes* m_recordTarget;
+    GLenum m_strokeMode;
+    std::vector<float> m_strokeVertices;
+
+    std::vector<GlyphAtlas> m_atlases;
+    std::vector<TextBlock> m_textBlocks;
 };
 
-} // namespace Revolt
\ No newline at end of file
+} // namespace Revolt
@@ -0,0 +1,173 @@
+#include "TextureAtlas.h"
+#include "GLExtensions.h"
+#include "GLState.h"
+#include "../core/Log.h"
+#include <algorithm>
+
+namespace Revolt {
+
+TextureAtlas::TextureAtlas(int pageSize, int padding, Format format) 
+    : m_pageSize(pageSize), m_padding(padding), m_format(format), m_usedTexels(0), m_imageCount(0) {
+}
+
+TextureAtlas::~TextureAtlas() {
+    // Атлас живёт в ResourceManager и может пережить контекст
+    if (!glfwGetCurrentContext()) {
+        return;
+    }
+    for (const Page& page : m_pages) {
+        GLState::DeleteTextures(1, &page.textureID);
+    }
+}
+
+bool TextureAtlas::SetFormat(Format format) {
+    if (!m_pages.empty()) {
+        return format == m_format;
+    }
+    m_format = format;
+    return true;
+}
+
+bool TextureAtlas::Add(int width, int height, const uint8_t* pixels, AtlasRegion& region) {
+    if (m_pages.empty()) {
+        // Размер страницы не больше, чем позволяет драйвер
+        GLint maxSize = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+        if (maxSize > 0 && maxSize < m_pageSize) {
+            m_pageSize = maxSize;
+        }
+    }
+    
+    int paddedWidth = width + m_padding * 2;
+    int paddedHeight = height + m_padding * 2;
+    if (width <= 0 || height <= 0 || paddedWidth > m_pageSize || paddedHeight > m_pageSize) {
+        return false;
+    }
+    
+    // Сначала ищем место на существующих страницах, потом заводим новую
+    int pageIndex = -1;
+    int x = 0, y = 0;
+    for (size_t i = 0; i < m_pages.size(); ++i) {
+        if (Place(m_pages[i], paddedWidth, paddedHeight, x, y)) {
+            pageIndex = static_cast<int>(i);
+            break;
+        }
+    }
+    if (pageIndex < 0) {
+        CreatePage();
+        pageIndex = static_cast<int>(m_pages.size()) - 1;
+        Place(m_pages.back(), paddedWidth, paddedHeight, x, y);
+    }
+    
+    const Page& page = m_pages[pageIndex];
+    Upload(page, x, y, width, height, pixels);
+    
+    region.textureID = page.textureID;
+    region.page = pageIndex;
+    region.x = x + m_padding;
+    region.y = y + m_padding;
+    region.width = width;
+    region.height = height;
+    region.uOffset = static_cast<float>(region.x) / m_pageSize;
+    region.vOffset = static_cast<float>(region.y) / m_pageSize;
+    region.uScale = static_cast<float>(width) / m_pageSize;
+    region.vScale = static_cast<float>(height) / m_pageSize;
+    
+    m_usedTexels += static_cast<long long>(width) * height;
+    ++m_imageCount;
+    return true;
+}
+
+bool TextureAtlas::Place(Page& page, int width, int height, int& x, int& y) {
+    // Самая низкая подходящая полка, чтобы меньше терять по высоте
+    Shelf* best = nullptr;
+    for (Shelf& shelf : page.shelves) {
+        if (shelf.height >= height && shelf.nextX + width <= m_pageSize &&
+            (!best || shelf.height < best->height)) {
+            best = &shelf;
+        }
+    }
+    
+    if (!best) {
+        if (page.nextShelfY + height > m_pageSize) {
+            return false;
+        }
+        Shelf shelf = {page.nextShelfY, height, 0};
+        page.shelves.push_back(shelf);
+        page.nextShelfY += height;
+        best = &page.shelves.back();
+    }
+    
+    x = best->nextX;
+    y = best->y;
+    best->nextX += width;
+    return true;
+}
+
+void TextureAtlas::CreatePage() {
+    Page page;
+    page.nextShelfY = 0;
+    
+    // Пустые участки страницы - прозрачные (в палитре прозрачен индекс 255)
+    uint8_t clearValue = m_format == Format::Indexed ? 255 : 0;
+    std::vector<uint8_t> clear(static_cast<size_t>(m_pageSize) * m_pageSize * GetBytesPerTexel(), clearValue);
+    GLint filter = m_format == Format::Indexed ? GL_NEAREST : GL_LINEAR;
+    
+    glGenTextures(1, &page.textureID);
+    GLState::BindTexture(page.textureID);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    if (m_format == Format::Indexed) {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE8, m_pageSize, m_pageSize, 0, GL_LUMINANCE, GL_UNSIGNED_BYTE, clear.data());
+    } else {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_pageSize, m_pageSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, clear.data());
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    
+    m_pages.push_back(page);
+}
+
+void TextureAtlas::Upload(const Page& page, int x, int y, int width, int height, const uint8_t* pixels) {
+    int paddedWidth = width + m_padding * 2;
+    int paddedHeight = height + m_padding * 2;
+    const int texelSize = GetBytesPerTexel();
+    m_uploadBuffer.resize(static_cast<size_t>(paddedWidth) * paddedHeight * texelSize);
+    
+    // Поле заполняется ближайшим краевым текселем
+    for (int row = 0; row < paddedHeight; ++row) {
+        int srcRow = std::min(std::max(row - m_padding, 0), height - 1);
+        for (int col = 0; col < paddedWidth; ++col) {
+            int srcCol = std::min(std::max(col - m_padding, 0), width - 1);
+            const uint8_t* src = pixels + (static_cast<size_t>(srcRow) * width + srcCol) * texelSize;
+            uint8_t* dst = &m_uploadBuffer[(static_cast<size_t>(row) * paddedWidth + col) * texelSize];
+            for (int k = 0; k < texelSize; ++k) {
+                dst[k] = src[k];
+            }
+        }
+    }
+    
+    GLenum format = m_format == Format::Indexed ? GL_LUMINANCE : GL_RGBA;
+    GLState::BindTexture(page.textureID);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, paddedWidth, paddedHeight, format, GL_UNSIGNED_BYTE, m_uploadBuffer.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
+
+float TextureAtlas::GetOccupancy() const {
+    if (m_pages.empty()) {
+        return 0.0f;
+    }
+    double total = static_cast<double>(m_pageSize) * m_pageSize * m_pages.size();
+    return static_cast<float>(m_usedTexels / total);
+}
+
+void TextureAtlas::PrintStats() const {
+    REVOLT_LOG(Info, Resources, "Texture atlas (%s): %d images, %d page(s) of %dx%d, occupancy %d%%",
+               m_format == Format::Indexed ? "indexed" : "RGBA", m_imageCount, static_cast<int>(m_pages.size()),
+               m_pageSize, m_pageSize, static_cast<int>(GetOccupancy() * 100.0f + 0.5f));
+}
+
+} // namespace Revolt
@@ -0,0 +1,84 @@
+#pragma once
+#include <GLFW/glfw3.h>
+#include <cstdint>
+#include <vector>
+
+namespace Revolt {
+
+// Место изображения в атласе
+struct AtlasRegion {
+    GLuint textureID;
+    int page;
+    int x, y;            // Левый верхний угол в текселях страницы
+    int width, height;
+    float uOffset, vOffset;
+    float uScale, vScale;
+
+    // Переводит координаты (0..1 внутри изображения) в координаты страницы
+    void Map(float& u, float& v) const {
+        u = uOffset + u * uScale;
+        v = vOffset + v * vScale;
+    }
+};
+
+// Страницы текстур, в которые полками укладываются небольшие изображения
+// (скины MDL). Модели с одной страницы рисуются без переключения текстуры.
+// Вокруг каждого изображения - поле с повторёнными краевыми текселями,
+// чтобы билинейная фильтрация не захватывала соседей.
+class TextureAtlas {
+public:
+    enum class Format {
+        RGBA,    // 4 байта на тексель, билинейная фильтрация
+        Indexed  // 1 байт - индекс палитры (GL_LUMINANCE8), без фильтрации
+    };
+    
+    explicit TextureAtlas(int pageSize = 1024, int padding = 2, Format format = Format::RGBA);
+    ~TextureAtlas();
+
+    TextureAtlas(const TextureAtlas&) = delete;
+    TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+    Format GetFormat() const { return m_format; }
+    // Менять формат можно только пока атлас пуст
+    bool SetFormat(Format format);
+    
+    // Копирует изображение (в формате атласа) в атлас. Требует текущий контекст OpenGL.
+    // false - изображение больше страницы, его нужно держать отдельной текстурой.
+    bool Add(int width, int height, const uint8_t* pixels, AtlasRegion& region);
+
+    int GetPageCount() const { return static_cast<int>(m_pages.size()); }
+    int GetImageCount() const { return m_imageCount; }
+    // Доля текселей страниц, занятых изображениями (без полей)
+    float GetOccupancy() const;
+    // Сводка одной строкой в журнал
+    void PrintStats() const;
+
+private:
+    struct Shelf {
+        int y;
+        int height;
+        int nextX;
+    };
+
+    struct Page {
+        GLuint textureID;
+        std::vector<Shelf> shelves;
+        int nextShelfY;
+    };
+
+    bool Place(Page& page, int width, int height, int& x, int& y);
+    void CreatePage();
+    void Upload(const Page& page, int x, int y, int width, int height, const uint8_t* pixels);
+
+    int GetBytesPerTexel() const { return m_format == Format::Indexed ? 1 : 4; }
+    
+    int m_pageSize;
+    int m_padding;
+    Format m_format;
+    std::vector<Page> m_pages;
+    long long m_usedTexels;
+    int m_imageCount;
+    std::vector<uint8_t> m_uploadBuffer; // Изображение с полями, переиспользуется
+};
+
+} // namespace Revolt
@@ -1,8 +1,8 @@
 #include "core/Application.h"
 #include <iostream>
 
-int main() {
-    Revolt::Application app;
+int main(int argc, char** argv) {
+    Revolt::Application app(Revolt::LaunchOptions::Parse(argc, argv));
     
     if (!app.Initialize()) {
         std::cerr << "Failed to initialize Revolt Engine" << std::endl;
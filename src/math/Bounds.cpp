@@ -0,0 +1,63 @@
+#include "Bounds.h"
+#include <cmath>
+
+namespace Revolt {
+
+BoundingBox::BoundingBox() {
+    // Пустой бокс: первый Expand полностью его заменит
+    for (int i = 0; i < 3; ++i) {
+        min[i] = 1e30f;
+        max[i] = -1e30f;
+    }
+}
+
+BoundingBox::BoundingBox(float minX, float minY, float minZ, float maxX, float maxY, float maxZ) {
+    min[0] = minX; min[1] = minY; min[2] = minZ;
+    max[0] = maxX; max[1] = maxY; max[2] = maxZ;
+}
+
+void BoundingBox::Expand(const BoundingBox& other) {
+    for (int i = 0; i < 3; ++i) {
+        if (other.min[i] < min[i]) min[i] = other.min[i];
+        if (other.max[i] > max[i]) max[i] = other.max[i];
+    }
+}
+
+BoundingBox BoundingBox::Transformed(const Matrix4& transform) const {
+    const float* m = transform.m;
+    
+    // Центр преобразуется как точка, полуразмеры - по модулю матрицы (метод Арво)
+    float center[3], extent[3];
+    for (int i = 0; i < 3; ++i) {
+        center[i] = (min[i] + max[i]) * 0.5f;
+        extent[i] = (max[i] - min[i]) * 0.5f;
+    }
+    
+    BoundingBox result;
+    for (int row = 0; row < 3; ++row) {
+        float c = m[12 + row];
+        float e = 0.0f;
+        for (int col = 0; col < 3; ++col) {
+            c += m[col * 4 + row] * center[col];
+            e += std::fabs(m[col * 4 + row]) * extent[col];
+        }
+        result.min[row] = c - e;
+        result.max[row] = c + e;
+    }
+    
+    return result;
+}
+
+BoundingSphere BoundingBox::GetSphere() const {
+    BoundingSphere sphere;
+    float radiusSq = 0.0f;
+    for (int i = 0; i < 3; ++i) {
+        sphere.center[i] = (min[i] + max[i]) * 0.5f;
+        float half = (max[i] - min[i]) * 0.5f;
+        radiusSq += half * half;
+    }
+    sphere.radius = std::sqrt(radiusSq);
+    return sphere;
+}
+
+} // namespace Revolt
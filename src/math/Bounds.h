@@ -0,0 +1,28 @@
+#pragma once
+#include "Matrix4.h"
+
+namespace Revolt {
+
+struct BoundingSphere {
+    float center[3];
+    float radius;
+};
+
+// Ограничивающий параллелепипед, выровненный по осям (AABB)
+struct BoundingBox {
+    float min[3];
+    float max[3];
+
+    BoundingBox();
+    BoundingBox(float minX, float minY, float minZ, float maxX, float maxY, float maxZ);
+
+    bool IsValid() const { return min[0] <= max[0] && min[1] <= max[1] && min[2] <= max[2]; }
+    void Expand(const BoundingBox& other);
+
+    // AABB, описанный вокруг преобразованного бокса (матрица в формате OpenGL)
+    BoundingBox Transformed(const Matrix4& transform) const;
+    // Описанная сфера
+    BoundingSphere GetSphere() const;
+};
+
+} // namespace Revolt
@@ -0,0 +1,63 @@
+#include "Frustum.h"
+#include <cmath>
+
+namespace Revolt {
+
+Frustum::Frustum() {
+    // Без Extract ничего не отсекаем
+    for (int i = 0; i < 6; ++i) {
+        m_planes[i][0] = m_planes[i][1] = m_planes[i][2] = 0.0f;
+        m_planes[i][3] = 1.0f;
+    }
+}
+
+void Frustum::Extract(const Matrix4& projection, const Matrix4& view) {
+    // view.Multiply(projection) даёт P * V в математической записи
+    Matrix4 clip = view.Multiply(projection);
+    const float* m = clip.m;
+    
+    // Строка i матрицы, хранящейся по столбцам: m[i], m[4 + i], m[8 + i], m[12 + i]
+    for (int axis = 0; axis < 3; ++axis) {
+        for (int side = 0; side < 2; ++side) {
+            float* plane = m_planes[axis * 2 + side];
+            float sign = side == 0 ? 1.0f : -1.0f;
+            for (int k = 0; k < 4; ++k) {
+                plane[k] = m[k * 4 + 3] + sign * m[k * 4 + axis];
+            }
+            
+            float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+            if (length > 0.0f) {
+                for (int k = 0; k < 4; ++k) {
+                    plane[k] /= length;
+                }
+            }
+        }
+    }
+}
+
+bool Frustum::Intersects(const BoundingSphere& sphere) const {
+    for (int i = 0; i < 6; ++i) {
+        const float* p = m_planes[i];
+        float distance = p[0] * sphere.center[0] + p[1] * sphere.center[1] + p[2] * sphere.center[2] + p[3];
+        if (distance < -sphere.radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Frustum::Intersects(const BoundingBox& box) const {
+    for (int i = 0; i < 6; ++i) {
+        const float* p = m_planes[i];
+        // Вершина бокса, дальше всех продвинутая вдоль нормали плоскости
+        float x = p[0] >= 0.0f ? box.max[0] : box.min[0];
+        float y = p[1] >= 0.0f ? box.max[1] : box.min[1];
+        float z = p[2] >= 0.0f ? box.max[2] : box.min[2];
+        if (p[0] * x + p[1] * y + p[2] * z + p[3] < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace Revolt
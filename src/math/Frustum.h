@@ -0,0 +1,23 @@
+#pragma once
+#include "Matrix4.h"
+#include "Bounds.h"
+
+namespace Revolt {
+
+// Пирамида видимости из матрицы проекция × вид (метод Грибба-Хартманна)
+class Frustum {
+public:
+    Frustum();
+
+    void Extract(const Matrix4& projection, const Matrix4& view);
+
+    bool Intersects(const BoundingSphere& sphere) const;
+    bool Intersects(const BoundingBox& box) const;
+
+private:
+    // Плоскости: a, b, c, d; нормали направлены внутрь
+    // Порядок: левая, правая, нижняя, верхняя, ближняя, дальняя
+    float m_planes[6][4];
+};
+
+} // namespace Revolt
@@ -0,0 +1,311 @@
+// Подготовка ресурсов: переводит исходники в формат, который рантайм читает
+// как есть (см. graphics/CookedAsset.h).
+//
+//   RevoltCook [--force] [--jobs N] [PATH...]
+//
+// PATH - файл .mdl, сцена .json или каталог с ними. По умолчанию - ../../assets,
+// как у движка (Application), а если его нет - assets (запуск из корня репозитория).
+// Каждая модель становится .rmdl рядом с исходником, каждая сцена - двоичной
+// сценой .rscn и пакетом .rmesh с её процедурными мешами; модели, на которые
+// ссылается сцена, тоже готовятся. Файлы обрабатываются параллельно. Исходник с тем же хэшем
+// содержимого не готовится заново (--force - готовить всё).
+// Пути к моделям в сценах, как и в движке, считаются от текущего каталога:
+// запускать из рабочего каталога движка. Модель сцены, которой отсюда не
+// видно, пропускается с предупреждением - движок её отсюда тоже не найдёт.
+#include "core/Log.h"
+#include "core/MappedFile.h"
+#include "core/ResourceManager.h"
+#include "core/SceneLoader.h"
+#include "graphics/CookedAsset.h"
+#include "graphics/MDLModel.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>
+#else
+#  include <dirent.h>
+#  include <sys/stat.h>
+#endif
+
+using namespace Revolt;
+
+namespace {
+
+struct CookConfig {
+    std::vector<std::string> paths;
+    unsigned int jobs = 0; // 0 - по числу ядер
+    bool force = false;
+};
+
+enum class CookResult {
+    Cooked,
+    Restamped, // Содержимое то же, обновлены только размер и время в заголовке
+    UpToDate,
+    Failed
+};
+
+enum class CookKind {
+    Model,
+    MeshPack,
+    Scene
+};
+
+struct CookJob {
+    std::string source;
+    CookKind kind;
+    std::string cookedPath;
+    std::vector<ResourceManager::MeshDesc> meshes; // Для пакета мешей
+    CookResult result;
+    size_t cookedSize;
+};
+
+bool HasExtension(const std::string& path, const char* extension) {
+    size_t length = std::strlen(extension);
+    return path.size() > length && path.compare(path.size() - length, length, extension) == 0;
+}
+
+bool IsDirectory(const std::string& path) {
+#if defined(_WIN32)
+    DWORD attributes = GetFileAttributesA(path.c_str());
+    return attributes != INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_DIRECTORY);
+#else
+    struct stat info;
+    return stat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+#endif
+}
+
+// Имена файлов каталога (без вложенных), по алфавиту
+std::vector<std::string> ListDirectory(const std::string& directory) {
+    std::vector<std::string> files;
+#if defined(_WIN32)
+    WIN32_FIND_DATAA data;
+    HANDLE find = FindFirstFileA((directory + "\\*").c_str(), &data);
+    if (find != INVALID_HANDLE_VALUE) {
+        do {
+            if (!(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
+                files.push_back(directory + "/" + data.cFileName);
+            }
+        } while (FindNextFileA(find, &data));
+        FindClose(find);
+    }
+#else
+    if (DIR* dir = opendir(directory.c_str())) {
+        while (dirent* entry = readdir(dir)) {
+            std::string path = directory + "/" + entry->d_name;
+            if (entry->d_name[0] != '.' && !IsDirectory(path)) {
+                files.push_back(path);
+            }
+        }
+        closedir(dir);
+    }
+#endif
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+CookJob& AddJob(std::vector<CookJob>& jobs, const std::string& source, CookKind kind) {
+    for (CookJob& job : jobs) {
+        if (job.source == source && job.kind == kind) {
+            return job;
+        }
+    }
+    CookJob job;
+    job.source = source;
+    job.kind = kind;
+    job.result = CookResult::Failed;
+    job.cookedSize = 0;
+    jobs.push_back(job);
+    return jobs.back();
+}
+
+// Сцена разбирается сразу: её модели становятся отдельными заданиями
+bool AddSource(std::vector<CookJob>& jobs, const std::string& path) {
+    if (HasExtension(path, ".mdl")) {
+        AddJob(jobs, path, CookKind::Model);
+        return true;
+    }
+    if (!HasExtension(path, ".json")) {
+        return false;
+    }
+
+    std::vector<ResourceManager::MeshDesc> meshes;
+    std::vector<std::string> models;
+    if (!SceneLoader::CollectAssets(path, meshes, models)) {
+        return false;
+    }
+    AddJob(jobs, path, CookKind::Scene);
+    AddJob(jobs, path, CookKind::MeshPack).meshes = meshes;
+    for (const std::string& model : models) {
+        Cooked::SourceStamp stamp;
+        if (!Cooked::GetSourceStamp(model, stamp)) {
+            std::fprintf(stderr, "Warning: %s (from %s) not found from the current directory, skipped\n",
+                         model.c_str(), path.c_str());
+            continue;
+        }
+        AddJob(jobs, model, CookKind::Model);
+    }
+    return true;
+}
+
+CookResult Cook(CookJob& job, bool force) {
+    uint32_t magic = Cooked::MODEL_MAGIC;
+    uint32_t version = Cooked::MODEL_VERSION;
+    const char* extension = Cooked::MODEL_EXTENSION;
+    if (job.kind == CookKind::MeshPack) {
+        magic = Cooked::MESH_PACK_MAGIC;
+        version = Cooked::MESH_PACK_VERSION;
+        extension = Cooked::MESH_PACK_EXTENSION;
+    } else if (job.kind == CookKind::Scene) {
+        magic = Cooked::SCENE_MAGIC;
+        version = Cooked::SCENE_VERSION;
+        extension = Cooked::SCENE_EXTENSION;
+    }
+    job.cookedPath = Cooked::GetCookedPath(job.source, extension);
+    const std::string& cookedPath = job.cookedPath;
+
+    MappedFile source;
+    Cooked::SourceStamp stamp;
+    if (!source.Open(job.source) || !Cooked::GetSourceStamp(job.source, stamp)) {
+        std::cerr << "Failed to read " << job.source << std::endl;
+        return CookResult::Failed;
+    }
+    stamp.contentHash = Cooked::HashBytes(source.GetData(), source.GetSize());
+
+    Cooked::FileHeader existing;
+    if (!force && Cooked::ReadFileHeader(cookedPath, existing) && existing.magic == magic && existing.version == version &&
+        existing.source.contentHash == stamp.contentHash) {
+        if (existing.source.size == stamp.size && existing.source.modifiedTime == stamp.modifiedTime) {
+            return CookResult::UpToDate;
+        }
+
+        // Файл тронули, не изменив (checkout, копирование): рантайм сверяет
+        // время, поэтому переписываем только заголовок
+        MappedFile cooked;
+        if (cooked.Open(cookedPath) && cooked.Contains(0, sizeof(Cooked::FileHeader))) {
+            std::vector<uint8_t> data(cooked.GetData(), cooked.GetData() + cooked.GetSize());
+            cooked.Close();
+            existing.source = stamp;
+            std::memcpy(data.data(), &existing, sizeof(existing));
+            if (Cooked::WriteFileAtomic(cookedPath, data)) {
+                job.cookedSize = data.size();
+                return CookResult::Restamped;
+            }
+        }
+    }
+
+    std::vector<uint8_t> data;
+    bool success;
+    if (job.kind == CookKind::MeshPack) {
+        success = ResourceManager::CookMeshPack(job.meshes, stamp, data);
+    } else if (job.kind == CookKind::Scene) {
+        success = SceneLoader::CompileScene(job.source, stamp, data);
+    } else {
+        MDLModel model;
+        success = model.ParseFile(job.source) && model.Cook(stamp, data);
+    }
+
+    if (!success || !Cooked::WriteFileAtomic(cookedPath, data)) {
+        std::cerr << "Failed to cook " << cookedPath << std::endl;
+        return CookResult::Failed;
+    }
+    job.cookedSize = data.size();
+    return CookResult::Cooked;
+}
+
+bool ParseArguments(int argc, char** argv, CookConfig& config) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--force") {
+            config.force = true;
+        } else if (arg == "--jobs" && hasValue) {
+            config.jobs = static_cast<unsigned int>(std::max(1, std::atoi(argv[++i])));
+        } else if (arg.compare(0, 2, "--") == 0) {
+            std::fprintf(stderr, "Unknown argument: %s\n", arg.c_str());
+            return false;
+        } else {
+            config.paths.push_back(arg);
+        }
+    }
+    if (config.paths.empty()) {
+        config.paths.push_back(IsDirectory("../../assets") ? "../../assets" : "assets");
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    CookConfig config;
+    if (!ParseArguments(argc, argv, config)) {
+        std::fprintf(stderr, "Usage: RevoltCook [--force] [--jobs N] [file.mdl|scene.json|directory...]\n"
+                             "Default directory: ../../assets, or assets if it doesn't exist\n");
+        return 1;
+    }
+
+    std::vector<CookJob> jobs;
+    bool success = true;
+    for (const std::string& path : config.paths) {
+        if (IsDirectory(path)) {
+            for (const std::string& file : ListDirectory(path)) {
+                AddSource(jobs, file);
+            }
+        } else if (!AddSource(jobs, path)) {
+            std::fprintf(stderr, "Can't cook %s\n", path.c_str());
+            success = false;
+        }
+    }
+
+    unsigned int threadCount = config.jobs ? config.jobs : std::max(1u, std::thread::hardware_concurrency());
+    threadCount = std::min(threadCount, static_cast<unsigned int>(std::max<size_t>(jobs.size(), 1)));
+
+    // Сообщения потоков подготовки идут через очередь журнала: её выводит
+    // один поток, целыми строками
+    Log::Start(nullptr);
+    std::atomic<size_t> nextJob(0);
+    std::vector<std::thread> threads;
+    for (unsigned int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&] {
+            for (size_t i = nextJob.fetch_add(1); i < jobs.size(); i = nextJob.fetch_add(1)) {
+                jobs[i].result = Cook(jobs[i], config.force);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    Log::Stop();
+
+    int cooked = 0, restamped = 0, upToDate = 0, failed = 0;
+    for (const CookJob& job : jobs) {
+        const char* status = "FAILED";
+        switch (job.result) {
+            case CookResult::Cooked:    status = "cooked";     ++cooked;    break;
+            case CookResult::Restamped: status = "restamped";  ++restamped; break;
+            case CookResult::UpToDate:  status = "up to date"; ++upToDate;  break;
+            case CookResult::Failed:    success = false;       ++failed;    break;
+        }
+        if (job.result == CookResult::UpToDate || job.result == CookResult::Failed) {
+            std::printf("%-10s %s\n", status, job.cookedPath.c_str());
+        } else {
+            std::printf("%-10s %s (%zu KB)\n", status, job.cookedPath.c_str(), (job.cookedSize + 1023) / 1024);
+        }
+    }
+    std::printf("%d cooked, %d restamped, %d up to date, %d failed (%u threads)\n",
+                cooked, restamped, upToDate, failed, threadCount);
+    return success ? 0 : 1;
+}